@@ -14,11 +14,20 @@ typedef enum {
 	MUX_SCAN_FULL
 } mux_scan_mode_t;
 
+/* Full-scan point order: GRAY/SERPENTINE flip fewer select lines per step */
+typedef enum {
+	MUX_ORDER_BINARY,
+	MUX_ORDER_SERPENTINE,
+	MUX_ORDER_GRAY
+} mux_scan_order_t;
+
 /* Configure scan parameters; non-blocking operations scheduled in tick */
 void mux_init(void);
 void mux_set_mode(mux_scan_mode_t mode, uint8_t row, uint8_t col);
 void mux_enable(uint8_t en); /* controls both EN pins combined policy */
 void mux_set_period_ms(uint16_t period_ms);
+void mux_set_order(mux_scan_order_t order); /* takes effect at next full-scan cycle */
+mux_scan_order_t mux_get_order(void);
 
 /* Called from 5ms tick to progress scanning without blocking */
 void mux_tick_5ms(void);
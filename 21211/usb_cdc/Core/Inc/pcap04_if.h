@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include "pcap04_register.h"
+#include "pcap04_reg_index.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -19,8 +20,9 @@ typedef struct
 {
 	pcap04_event_type_t type;
 	uint8_t             status;
-	uint8_t             reg_addr;
-	uint8_t             reg_value;
+	uint8_t             reg_addr;   /* REG_SYNC_DONE：本段起始寄存器 */
+	uint8_t             reg_count;  /* REG_SYNC_DONE：本段连续寄存器数（一次自动递增写入） */
+	uint8_t             reg_value;  /* 起始寄存器当前镜像值 */
 } pcap04_event_t;
 
 void pcap04_if_init(void);
@@ -28,9 +30,14 @@ void pcap04_if_tick_5ms(void);
 
 uint8_t pcap04_if_reg_set(uint8_t addr, const char* bitname, uint8_t value, uint8_t* old_value, uint8_t* new_value);
 uint8_t pcap04_if_reg_get(uint8_t addr, const char* bitname, uint8_t* out_value);
+/* 按字段编号（PCAP04_FIELD_*）读写，不做名称查找；pcap04_if_reg_set/get 先把名称换成编号再调用这两个函数 */
+uint8_t pcap04_if_field_set(PCAP04_FieldId_t id, uint8_t value, uint8_t* old_value, uint8_t* new_value);
+uint8_t pcap04_if_field_get(PCAP04_FieldId_t id, uint8_t* out_value);
+PCAP04_FieldId_t pcap04_if_field_id(uint8_t addr, const char* bitname);  /* 不属于该寄存器返回 PCAP04_FIELD_INVALID */
 uint8_t pcap04_if_reg_byte(uint8_t addr);
 const uint8_t* pcap04_if_reg_snapshot(void);
 uint8_t pcap04_if_sync_all(void);
+uint8_t pcap04_if_sync_pending(void);  /* 尚未写入芯片的寄存器数（含正在发送的一段） */
 
 uint8_t pcap04_if_save_to_flash(void);
 uint8_t pcap04_if_load_from_flash(void);
@@ -0,0 +1,172 @@
+/* 本文件由 CDC_GUI/tools/gen_pcap04_reg_index.py 根据 pcap04_register_def.c 生成，请勿手工修改 */
+#ifndef __PCAP04_REG_INDEX_H
+#define __PCAP04_REG_INDEX_H
+
+#include <stdint.h>
+#include "pcap04_register.h"
+
+/*
+ * 寄存器字段索引：
+ * - PCAP04_FIELD_* 为字段编号，代码中可直接使用，不再按名称查找；
+ * - PCAP04_FindField() 按字段名查编号，最小完美哈希，一次哈希计算加一次 strcmp 确认；
+ * - PCAP04_FindRegisterIndex() 按寄存器地址直接取定义；
+ * - PCAP04_SetField()/PCAP04_GetField() 按字段编号读写寄存器镜像，返回值同 PCAP04_SetRegisterBit()/GetRegisterBit()。
+ * 字段编号与上位机 communication/pcap04_registers.py 中的编号一致。
+ */
+
+#define PCAP04_REG_ADDR_LIMIT  64U   /* 定义表中的地址范围 0x00-0x3F */
+
+typedef enum
+{
+	PCAP04_FIELD_I2C_A = 0,                  /* 0x00 IIC_LF_CONFIG [7:6] */
+	PCAP04_FIELD_OLF_FTUNE = 1,              /* 0x00 IIC_LF_CONFIG [5:2] */
+	PCAP04_FIELD_OLF_CTUNE = 2,              /* 0x00 IIC_LF_CONFIG [1:0] */
+	PCAP04_FIELD_OX_DIS = 3,                 /* 0x01 OX_CONFIG [7] */
+	PCAP04_FIELD_OX_DIV4 = 4,                /* 0x01 OX_CONFIG [5] */
+	PCAP04_FIELD_OX_RUN = 5,                 /* 0x01 OX_CONFIG [2:0] */
+	PCAP04_FIELD_RDCHG_INT_SEL1 = 6,         /* 0x02 DISCHARGE_RES [7:6] */
+	PCAP04_FIELD_RDCHG_INT_SEL0 = 7,         /* 0x02 DISCHARGE_RES [5:4] */
+	PCAP04_FIELD_RDCHG_INT_EN = 8,           /* 0x02 DISCHARGE_RES [3] */
+	PCAP04_FIELD_RDCHG_EXT_EN = 9,           /* 0x02 DISCHARGE_RES [1] */
+	PCAP04_FIELD_AUX_PD_DIS = 10,            /* 0x03 CHARGE_CONFIG [6] */
+	PCAP04_FIELD_AUX_CINT = 11,              /* 0x03 CHARGE_CONFIG [5] */
+	PCAP04_FIELD_RDCHG_PERM_EN = 12,         /* 0x03 CHARGE_CONFIG [2] */
+	PCAP04_FIELD_RDCHG_EXT_PERM = 13,        /* 0x03 CHARGE_CONFIG [1] */
+	PCAP04_FIELD_RCHG_SEL = 14,              /* 0x03 CHARGE_CONFIG [0] */
+	PCAP04_FIELD_C_REF_INT = 15,             /* 0x04 CAP_CONNECT [7] */
+	PCAP04_FIELD_C_COMP_EXT = 16,            /* 0x04 CAP_CONNECT [5] */
+	PCAP04_FIELD_C_COMP_INT = 17,            /* 0x04 CAP_CONNECT [4] */
+	PCAP04_FIELD_C_DIFFERENTIAL = 18,        /* 0x04 CAP_CONNECT [1] */
+	PCAP04_FIELD_C_FLOATING = 19,            /* 0x04 CAP_CONNECT [0] */
+	PCAP04_FIELD_CY_PRE_MR1_SHORT = 20,      /* 0x05 CDC_CLOCK [7] */
+	PCAP04_FIELD_C_PORT_PAT = 21,            /* 0x05 CDC_CLOCK [5] */
+	PCAP04_FIELD_CY_HFCLK_SEL = 22,          /* 0x05 CDC_CLOCK [3] */
+	PCAP04_FIELD_CY_DIV4_DIS = 23,           /* 0x05 CDC_CLOCK [2] */
+	PCAP04_FIELD_CY_PRE_LONG = 24,           /* 0x05 CDC_CLOCK [1] */
+	PCAP04_FIELD_C_DC_BALANCE = 25,          /* 0x05 CDC_CLOCK [0] */
+	PCAP04_FIELD_PC5_EN = 26,                /* 0x06 PORT_ENABLE [5] */
+	PCAP04_FIELD_PC4_EN = 27,                /* 0x06 PORT_ENABLE [4] */
+	PCAP04_FIELD_PC3_EN = 28,                /* 0x06 PORT_ENABLE [3] */
+	PCAP04_FIELD_PC2_EN = 29,                /* 0x06 PORT_ENABLE [2] */
+	PCAP04_FIELD_PC1_EN = 30,                /* 0x06 PORT_ENABLE [1] */
+	PCAP04_FIELD_PC0_EN = 31,                /* 0x06 PORT_ENABLE [0] */
+	PCAP04_FIELD_C_AVRG_L = 32,              /* 0x07 C_AVRG_L [7:0] */
+	PCAP04_FIELD_C_AVRG_H = 33,              /* 0x08 C_AVRG_H [4:0] */
+	PCAP04_FIELD_CONV_TIME_L = 34,           /* 0x09 CONV_TIME_L [7:0] */
+	PCAP04_FIELD_CONV_TIME_M = 35,           /* 0x0A CONV_TIME_M [7:0] */
+	PCAP04_FIELD_CONV_TIME_H = 36,           /* 0x0B CONV_TIME_H [6:0] */
+	PCAP04_FIELD_DISCHARGE_TIME_L = 37,      /* 0x0C DISCHARGE_L [7:0] */
+	PCAP04_FIELD_C_STARTONPIN = 38,          /* 0x0D TRIG_CONFIG [7:6] */
+	PCAP04_FIELD_C_TRIG_SEL = 39,            /* 0x0D TRIG_CONFIG [4:2] */
+	PCAP04_FIELD_DISCHARGE_TIME_H = 40,      /* 0x0D TRIG_CONFIG [1:0] */
+	PCAP04_FIELD_PRECHARGE_TIME_L = 41,      /* 0x0E PRECHARGE_L [7:0] */
+	PCAP04_FIELD_C_FAKE = 42,                /* 0x0F PRECHARGE_CFG [5:2] */
+	PCAP04_FIELD_PRECHARGE_TIME_H = 43,      /* 0x0F PRECHARGE_CFG [1:0] */
+	PCAP04_FIELD_FULLCHARGE_TIME_L = 44,     /* 0x10 FULLCHARGE_L [7:0] */
+	PCAP04_FIELD_C_REF_SEL = 45,             /* 0x11 CREF_CONFIG [6:2] */
+	PCAP04_FIELD_FULLCHARGE_TIME_H = 46,     /* 0x11 CREF_CONFIG [1:0] */
+	PCAP04_FIELD_C_G_OP_RUN = 47,            /* 0x12 GUARD_ENABLE [7] */
+	PCAP04_FIELD_C_G_OP_EXT = 48,            /* 0x12 GUARD_ENABLE [6] */
+	PCAP04_FIELD_PC5_G_EN = 49,              /* 0x12 GUARD_ENABLE [5] */
+	PCAP04_FIELD_PC4_G_EN = 50,              /* 0x12 GUARD_ENABLE [4] */
+	PCAP04_FIELD_PC3_G_EN = 51,              /* 0x12 GUARD_ENABLE [3] */
+	PCAP04_FIELD_PC2_G_EN = 52,              /* 0x12 GUARD_ENABLE [2] */
+	PCAP04_FIELD_PC1_G_EN = 53,              /* 0x12 GUARD_ENABLE [1] */
+	PCAP04_FIELD_PC0_G_EN = 54,              /* 0x12 GUARD_ENABLE [0] */
+	PCAP04_FIELD_C_G_OP_VU = 55,             /* 0x13 GUARD_OP [7:6] */
+	PCAP04_FIELD_C_G_OP_ATTN = 56,           /* 0x13 GUARD_OP [5:4] */
+	PCAP04_FIELD_C_G_TIME = 57,              /* 0x13 GUARD_OP [3:0] */
+	PCAP04_FIELD_R_CY = 58,                  /* 0x14 RDC_TIME [7] */
+	PCAP04_FIELD_C_G_OP_TR = 59,             /* 0x14 RDC_TIME [2:0] */
+	PCAP04_FIELD_R_TRIG_PREDIV_L = 60,       /* 0x15 R_PREDIV_L [7:0] */
+	PCAP04_FIELD_R_TRIG_SEL = 61,            /* 0x16 RDC_TRIG [6:4] */
+	PCAP04_FIELD_R_AVRG = 62,                /* 0x16 RDC_TRIG [3:2] */
+	PCAP04_FIELD_R_TRIG_PREDIV_H = 63,       /* 0x16 RDC_TRIG [1:0] */
+	PCAP04_FIELD_PT1_EN = 64,                /* 0x17 RDC_PORT [7] */
+	PCAP04_FIELD_PTOREF_EN = 65,             /* 0x17 RDC_PORT [6] */
+	PCAP04_FIELD_R_PORT_EN_IMES = 66,        /* 0x17 RDC_PORT [5] */
+	PCAP04_FIELD_R_PORT_EN_IREF = 67,        /* 0x17 RDC_PORT [4] */
+	PCAP04_FIELD_R_FAKE = 68,                /* 0x17 RDC_PORT [2] */
+	PCAP04_FIELD_R_STARTONPIN = 69,          /* 0x17 RDC_PORT [1:0] */
+	PCAP04_FIELD_TDC_CHAN_EN = 70,           /* 0x18 TDC_CONFIG0 [5:4] */
+	PCAP04_FIELD_TDC_ALUPERMOPEN = 71,       /* 0x18 TDC_CONFIG0 [3] */
+	PCAP04_FIELD_TDC_NOISE_DIS = 72,         /* 0x18 TDC_CONFIG0 [2] */
+	PCAP04_FIELD_TDC_MUPU_SPEED = 73,        /* 0x18 TDC_CONFIG0 [1:0] */
+	PCAP04_FIELD_TDC_MUPU_NO = 74,           /* 0x19 TDC_CONFIG1 [7:2] */
+	PCAP04_FIELD_TDC_QHA_SEL = 75,           /* 0x1A TDC_CONFIG2 [7:2] */
+	PCAP04_FIELD_TDC_NOISE_CY_DIS = 76,      /* 0x1A TDC_CONFIG2 [1] */
+	PCAP04_FIELD_DSP_MOFLO_EN = 77,          /* 0x1B DSP_CONFIG [7:6] */
+	PCAP04_FIELD_DSP_SPEED = 78,             /* 0x1B DSP_CONFIG [3:2] */
+	PCAP04_FIELD_PG1xPG3 = 79,               /* 0x1B DSP_CONFIG [1] */
+	PCAP04_FIELD_PG0xPG2 = 80,               /* 0x1B DSP_CONFIG [0] */
+	PCAP04_FIELD_WD_DIS = 81,                /* 0x1C WATCHDOG [7:0] */
+	PCAP04_FIELD_DSP_STARTONPIN = 82,        /* 0x1D DSP_TRIGGER [7:4] */
+	PCAP04_FIELD_DSP_FF_IN = 83,             /* 0x1D DSP_TRIGGER [3:0] */
+	PCAP04_FIELD_PG5_INTN_EN = 84,           /* 0x1E INT_CONFIG [7] */
+	PCAP04_FIELD_PG4_INTN_EN = 85,           /* 0x1E INT_CONFIG [6] */
+	PCAP04_FIELD_DSP_TRIG_TIMER = 86,        /* 0x1E INT_CONFIG [2] */
+	PCAP04_FIELD_DSP_TRIG_RDC = 87,          /* 0x1E INT_CONFIG [1] */
+	PCAP04_FIELD_DSP_TRIG_CDC = 88,          /* 0x1E INT_CONFIG [0] */
+	PCAP04_FIELD_PI1_TOGGLE_EN = 89,         /* 0x1F PULSE_IF0 [7] */
+	PCAP04_FIELD_PIO_TOGGLE_EN = 90,         /* 0x1F PULSE_IF0 [6] */
+	PCAP04_FIELD_PIO_RES = 91,               /* 0x1F PULSE_IF0 [5:4] */
+	PCAP04_FIELD_PIO_PDM_SEL = 92,           /* 0x1F PULSE_IF0 [3] */
+	PCAP04_FIELD_PIO_CLK_SEL = 93,           /* 0x1F PULSE_IF0 [2:0] */
+	PCAP04_FIELD_PI1_RES = 94,               /* 0x20 PULSE_IF1 [5:4] */
+	PCAP04_FIELD_PI1_PDM_SEL = 95,           /* 0x20 PULSE_IF1 [3] */
+	PCAP04_FIELD_PI1_CLK_SEL = 96,           /* 0x20 PULSE_IF1 [2:0] */
+	PCAP04_FIELD_PG3_DIR = 97,               /* 0x21 GPIO_CONFIG [7] */
+	PCAP04_FIELD_PG2_DIR = 98,               /* 0x21 GPIO_CONFIG [6] */
+	PCAP04_FIELD_PG1_DIR = 99,               /* 0x21 GPIO_CONFIG [5] */
+	PCAP04_FIELD_PG0_DIR = 100,              /* 0x21 GPIO_CONFIG [4] */
+	PCAP04_FIELD_PG3_PU = 101,               /* 0x21 GPIO_CONFIG [3] */
+	PCAP04_FIELD_PG2_PU = 102,               /* 0x21 GPIO_CONFIG [2] */
+	PCAP04_FIELD_PG1_PU = 103,               /* 0x21 GPIO_CONFIG [1] */
+	PCAP04_FIELD_PG0_PU = 104,               /* 0x21 GPIO_CONFIG [0] */
+	PCAP04_FIELD_INT_TRIG_BG = 105,          /* 0x22 BANDGAP [7] */
+	PCAP04_FIELD_DSP_TRIG_BG = 106,          /* 0x22 BANDGAP [6] */
+	PCAP04_FIELD_BG_PERM = 107,              /* 0x22 BANDGAP [5] */
+	PCAP04_FIELD_AUTOSTART = 108,            /* 0x22 BANDGAP [4] */
+	PCAP04_FIELD_CDC_GAIN_CORR = 109,        /* 0x23 GAIN_CORR [7:0] */
+	PCAP04_FIELD_BG_TIME = 110,              /* 0x26 BG_TIME [7:0] */
+	PCAP04_FIELD_PULSE_SEL1 = 111,           /* 0x27 PULSE_SEL [7:4] */
+	PCAP04_FIELD_PULSE_SEL0 = 112,           /* 0x27 PULSE_SEL [3:0] */
+	PCAP04_FIELD_C_SENSE_SEL = 113,          /* 0x28 C_SENSE_SEL [7:0] */
+	PCAP04_FIELD_R_SENSE_SEL = 114,          /* 0x29 R_SENSE_SEL [7:0] */
+	PCAP04_FIELD_ALARM1_SELECT = 115,        /* 0x2A FW_CONFIG [6] */
+	PCAP04_FIELD_ALARM0_SELECT = 116,        /* 0x2A FW_CONFIG [4] */
+	PCAP04_FIELD_EN_ASYNC_READ = 117,        /* 0x2A FW_CONFIG [3] */
+	PCAP04_FIELD_R_MEDIAN_EN = 118,          /* 0x2A FW_CONFIG [1] */
+	PCAP04_FIELD_C_MEDIAN_EN = 119,          /* 0x2A FW_CONFIG [0] */
+	PCAP04_FIELD_RUNBIT = 120,               /* 0x2F RUNBIT [0] */
+	PCAP04_FIELD_MEM_LOCK_960 = 121,         /* 0x30 MEM_LOCK [3] */
+	PCAP04_FIELD_MEM_LOCK_832 = 122,         /* 0x30 MEM_LOCK [2] */
+	PCAP04_FIELD_MEM_LOCK_704 = 123,         /* 0x30 MEM_LOCK [1] */
+	PCAP04_FIELD_MEM_LOCK_0 = 124,           /* 0x30 MEM_LOCK [0] */
+	PCAP04_FIELD_SERIAL_NUMBER_L = 125,      /* 0x31 SERIAL_L [7:0] */
+	PCAP04_FIELD_SERIAL_NUMBER_H = 126,      /* 0x32 SERIAL_H [7:0] */
+	PCAP04_FIELD_MEM_CTRL = 127,             /* 0x36 MEM_CTRL [7:0] */
+	PCAP04_FIELD_CHARGE_PUMP_L = 128,        /* 0x3E CHARGE_PUMP_L [7:0] */
+	PCAP04_FIELD_CHARGE_PUMP_H = 129,        /* 0x3F CHARGE_PUMP_H [7:0] */
+	PCAP04_FIELD_COUNT = 130,
+	PCAP04_FIELD_INVALID = 0xFF
+} PCAP04_FieldId_t;
+
+typedef struct
+{
+	uint8_t reg_addr;   /* 所在寄存器地址 */
+	uint8_t bit_start;  /* 起始位 */
+	uint8_t bit_end;    /* 结束位 */
+	uint8_t reg_pos;    /* 寄存器在 PCAP04_REGISTER_TABLE 中的下标 */
+	uint8_t bit_index;  /* 字段在该寄存器 bits[] 中的下标 */
+} PCAP04_FieldIndex_t;
+
+extern const PCAP04_FieldIndex_t PCAP04_FIELD_INDEX[PCAP04_FIELD_COUNT];
+
+PCAP04_FieldId_t PCAP04_FindField(const char *name);
+const PCAP04_RegBit_t* PCAP04_GetFieldDefinition(PCAP04_FieldId_t id);
+const PCAP04_Register_t* PCAP04_FindRegisterIndex(uint8_t reg_addr);
+uint8_t PCAP04_SetField(uint8_t *reg_array, PCAP04_FieldId_t id, uint8_t value);
+uint8_t PCAP04_GetField(const uint8_t *reg_array, PCAP04_FieldId_t id);
+
+#endif /* __PCAP04_REG_INDEX_H */
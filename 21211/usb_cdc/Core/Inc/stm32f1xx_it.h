@@ -58,6 +58,7 @@ void SysTick_Handler(void);
 void USB_LP_CAN1_RX0_IRQHandler(void);
 void TIM2_IRQHandler(void);
 /* USER CODE BEGIN EFP */
+void SPI2_IRQHandler(void);
 
 /* USER CODE END EFP */
 
@@ -6,6 +6,7 @@
  * 双片 CD4067 控制定时扫描模块，配合 TIM1 5ms Tick 实现行列/点位/全扫等模式。
  * 所有 GPIO 操作在 tick 中完成，避免主循环阻塞；可通过 mux_set_period_ms()
  * 设置全扫周期，通过 mux_enable() 控制 EN 引脚。
+ * 全扫顺序可选二进制/蛇形/格雷码（mux_set_order()），格雷码下相邻两点只翻转一根选择线。
  */
 
 static mux_scan_mode_t s_mode = MUX_SCAN_FULL;
@@ -14,6 +15,9 @@ static uint8_t s_en = 0U;
 static uint16_t s_period_ms = 200U;
 static uint16_t s_elapsed_ms = 0U;
 static uint8_t s_fullscan_active = 0U;
+static mux_scan_order_t s_order = MUX_ORDER_GRAY;
+static mux_scan_order_t s_cycle_order = MUX_ORDER_GRAY; /* latched at cycle start */
+static uint16_t s_step = 0U;
 
 static void write_row_pins(uint8_t value)
 {
@@ -37,6 +41,31 @@ static void apply_selection(uint8_t row, uint8_t col)
 	write_col_pins(col & 0x0FU);
 }
 
+/* 全扫第 step 个点 -> 行列 */
+static void order_point(mux_scan_order_t order, uint16_t step, uint8_t* row, uint8_t* col)
+{
+	uint8_t r = (uint8_t)((step >> 4) & 0x0FU);
+	uint8_t c = (uint8_t)(step & 0x0FU);
+
+	if (order == MUX_ORDER_SERPENTINE)
+	{
+		if (r & 0x01U)
+		{
+			c = (uint8_t)(0x0FU - c);
+		}
+	}
+	else if (order == MUX_ORDER_GRAY)
+	{
+		/* 8-bit reflected Gray code: high nibble = row, low nibble = col */
+		uint8_t g = (uint8_t)((step ^ (step >> 1)) & 0xFFU);
+		r = (uint8_t)(g >> 4);
+		c = (uint8_t)(g & 0x0FU);
+	}
+
+	*row = r;
+	*col = c;
+}
+
 void mux_init(void)
 {
 	s_mode = MUX_SCAN_FULL;
@@ -45,6 +74,8 @@ void mux_init(void)
 	s_period_ms = 200U;
 	s_elapsed_ms = 0U;
 	s_fullscan_active = 0U;
+	s_order = MUX_ORDER_GRAY;
+	s_step = 0U;
 	/* Disable both EN lines (active low) */
 	HAL_GPIO_WritePin(ENX_GPIO_Port, ENX_Pin, GPIO_PIN_SET);
 	HAL_GPIO_WritePin(ENY_GPIO_Port, ENY_Pin, GPIO_PIN_SET);
@@ -83,6 +114,16 @@ void mux_set_period_ms(uint16_t period_ms)
 	}
 }
 
+void mux_set_order(mux_scan_order_t order)
+{
+	s_order = (order > MUX_ORDER_GRAY) ? MUX_ORDER_BINARY : order;
+}
+
+mux_scan_order_t mux_get_order(void)
+{
+	return s_order;
+}
+
 void mux_tick_5ms(void)
 {
 	if (!s_en)
@@ -114,23 +155,19 @@ void mux_tick_5ms(void)
 			{
 				s_elapsed_ms = 0U;
 				s_fullscan_active = 1U;
-				s_row = 0U;
-				s_col = 0U;
+				s_cycle_order = s_order;
+				s_step = 0U;
 			}
 		}
 		if (s_fullscan_active)
 		{
+			order_point(s_cycle_order, s_step, &s_row, &s_col);
 			apply_selection(s_row, s_col);
-			s_col++;
-			if (s_col >= 16U)
+			s_step++;
+			if (s_step >= 256U)
 			{
-				s_col = 0U;
-				s_row++;
-				if (s_row >= 16U)
-				{
-					s_fullscan_active = 0U;
-					s_row = 0U;
-				}
+				s_fullscan_active = 0U;
+				s_step = 0U;
 			}
 		}
 		break;
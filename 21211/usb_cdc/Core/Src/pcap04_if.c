@@ -7,9 +7,10 @@
 #include "main.h"
 
 #define PCAP04_FLASH_ADDR        0x08080000UL
-#define PCAP04_OPCODE_WRITE_REG  0xA0U
-#define PCAP04_REG_QUEUE_CAP     64U
-#define PCAP04_EVENT_QUEUE_CAP   4U
+#define PCAP04_OPCODE_WR_CONFIG  0xA3U   /* 写配置寄存器：地址字节 0xC0 + 寄存器号（存储器 0x3C0 起） */
+#define PCAP04_CONFIG_ADDR_BASE  0xC0U
+#define PCAP04_DIRTY_BYTES       ((PCAP04_REG_COUNT + 7U) / 8U)
+#define PCAP04_EVENT_QUEUE_CAP   8U
 
 #define PCAP04_SPI_ASSERT_CS()   HAL_GPIO_WritePin(SPI_SSN_GPIO_Port, SPI_SSN_Pin, GPIO_PIN_RESET)
 #define PCAP04_SPI_RELEASE_CS()  HAL_GPIO_WritePin(SPI_SSN_GPIO_Port, SPI_SSN_Pin, GPIO_PIN_SET)
@@ -20,29 +21,25 @@ typedef enum {
 	PCAP_FW_WRITE
 } pcap_state_t;
 
-typedef struct {
-	uint8_t addr;
-	uint8_t value;
-} reg_job_t;
-
+/* 寄存器同步：镜像中改过的寄存器在脏位图中置位，总线空闲时把连续的脏寄存器
+ * 合并为一次自动递增写入（操作码 + 起始地址 + N 字节），完成中断里立即发送下一段。
+ * 调用方（TIM2 命令处理）与 SPI2 中断抢占优先级相同，互不打断，位图无需关中断保护。 */
 static volatile pcap_state_t s_state = PCAP_IDLE;
 static uint8_t s_regs[PCAP04_REG_COUNT];
 static uint8_t s_regs_initialized = 0U;
 
-static reg_job_t s_reg_queue[PCAP04_REG_QUEUE_CAP];
-static uint8_t s_reg_head = 0U;
-static uint8_t s_reg_tail = 0U;
-static uint8_t s_reg_count = 0U;
-static reg_job_t s_active_job = {0U, 0U};
+static uint8_t s_dirty[PCAP04_DIRTY_BYTES];
+static uint8_t s_active_start = 0U;
+static uint8_t s_active_count = 0U;
 
-static uint8_t s_spi_tx_buf[260];
+static uint8_t s_spi_tx_buf[2U + PCAP04_REG_COUNT];
 
 static pcap04_event_t s_events[PCAP04_EVENT_QUEUE_CAP];
 static uint8_t s_evt_head = 0U;
 static uint8_t s_evt_tail = 0U;
 static uint8_t s_evt_count = 0U;
 
-static void push_event(pcap04_event_type_t type, uint8_t status, uint8_t addr, uint8_t value)
+static void push_event(pcap04_event_type_t type, uint8_t status, uint8_t addr, uint8_t count)
 {
 	if (s_evt_count >= PCAP04_EVENT_QUEUE_CAP)
 	{
@@ -51,23 +48,78 @@ static void push_event(pcap04_event_type_t type, uint8_t status, uint8_t addr, u
 	s_events[s_evt_tail].type = type;
 	s_events[s_evt_tail].status = status;
 	s_events[s_evt_tail].reg_addr = addr;
-	s_events[s_evt_tail].reg_value = value;
+	s_events[s_evt_tail].reg_count = count;
+	s_events[s_evt_tail].reg_value = s_regs[addr];
 	s_evt_tail = (uint8_t)((s_evt_tail + 1U) % PCAP04_EVENT_QUEUE_CAP);
 	s_evt_count++;
 }
 
-static void queue_reg_job(uint8_t addr, uint8_t value)
+static void mark_dirty(uint8_t addr)
+{
+	s_dirty[addr >> 3] |= (uint8_t)(1U << (addr & 7U));
+}
+
+static uint8_t is_dirty(uint8_t addr)
+{
+	return (uint8_t)((s_dirty[addr >> 3] >> (addr & 7U)) & 1U);
+}
+
+static void clear_dirty(uint8_t addr)
+{
+	s_dirty[addr >> 3] &= (uint8_t)~(1U << (addr & 7U));
+}
+
+/* 发送未成功的一段重新置脏，下一次 tick 重试 */
+static void mark_range_dirty(uint8_t start, uint8_t count)
 {
-	if (s_reg_count >= PCAP04_REG_QUEUE_CAP)
+	for (uint8_t i = 0U; i < count; i++)
+	{
+		mark_dirty((uint8_t)(start + i));
+	}
+}
+
+/* 总线空闲时取出第一段连续脏寄存器，快照到发送缓冲区后一次中断发送 */
+static void flush_next_range(void)
+{
+	uint8_t start = 0U;
+	uint8_t count = 0U;
+
+	if (s_state != PCAP_IDLE)
+	{
+		return;
+	}
+	while (start < PCAP04_REG_COUNT && !is_dirty(start))
 	{
-		/* drop oldest to keep newest configuration */
-		s_reg_head = (uint8_t)((s_reg_head + 1U) % PCAP04_REG_QUEUE_CAP);
-		s_reg_count--;
+		start++;
+	}
+	if (start >= PCAP04_REG_COUNT)
+	{
+		return;
+	}
+	while (start + count < PCAP04_REG_COUNT && is_dirty((uint8_t)(start + count)))
+	{
+		clear_dirty((uint8_t)(start + count));
+		count++;
+	}
+
+	/* 发送期间再次修改的寄存器重新置脏，下一段写入 */
+	s_spi_tx_buf[0] = PCAP04_OPCODE_WR_CONFIG;
+	s_spi_tx_buf[1] = (uint8_t)(PCAP04_CONFIG_ADDR_BASE + start);
+	memcpy(&s_spi_tx_buf[2], &s_regs[start], count);
+	s_active_start = start;
+	s_active_count = count;
+
+	s_state = PCAP_REG_WRITE;
+	usb_cmd_pause_cdc();
+	PCAP04_SPI_ASSERT_CS();
+	if (HAL_SPI_Transmit_IT(&hspi2, s_spi_tx_buf, (uint16_t)(2U + count)) != HAL_OK)
+	{
+		/* 驱动忙或出错：恢复脏位，由下一次 tick 重试 */
+		PCAP04_SPI_RELEASE_CS();
+		usb_cmd_resume_cdc();
+		s_state = PCAP_IDLE;
+		mark_range_dirty(start, count);
 	}
-	s_reg_queue[s_reg_tail].addr = addr;
-	s_reg_queue[s_reg_tail].value = value;
-	s_reg_tail = (uint8_t)((s_reg_tail + 1U) % PCAP04_REG_QUEUE_CAP);
-	s_reg_count++;
 }
 
 static void ensure_regs_initialized(void)
@@ -85,46 +137,77 @@ static void ensure_regs_initialized(void)
 
 void pcap04_if_init(void)
 {
-	/* 初始化寄存器镜像、SPI 状态与事件队列 */
+	/* 初始化寄存器镜像、SPI 状态、脏位图与事件队列 */
 	ensure_regs_initialized();
 	s_state = PCAP_IDLE;
-	s_reg_head = s_reg_tail = s_reg_count = 0U;
+	memset(s_dirty, 0, sizeof(s_dirty));
 	s_evt_head = s_evt_tail = s_evt_count = 0U;
 }
 
-uint8_t pcap04_if_reg_set(uint8_t addr, const char* bitname, uint8_t value, uint8_t* old_value, uint8_t* new_value)
+uint8_t pcap04_if_field_set(PCAP04_FieldId_t id, uint8_t value, uint8_t* old_value, uint8_t* new_value)
 {
-	/* 更新寄存器镜像并排队写操作，立即返回避免阻塞 */
+	/* 更新寄存器镜像并置脏，总线空闲时立即开始写入，不等待 */
 	ensure_regs_initialized();
-	if (addr >= PCAP04_REG_COUNT || bitname == NULL)
+	if ((uint32_t)id >= (uint32_t)PCAP04_FIELD_COUNT || PCAP04_FIELD_INDEX[id].reg_addr >= PCAP04_REG_COUNT)
 	{
 		return 1U;
 	}
-	uint8_t previous = PCAP04_GetRegisterBit(s_regs, addr, bitname);
-	uint8_t rc = PCAP04_SetRegisterBit(s_regs, addr, bitname, value);
+	uint8_t previous = PCAP04_GetField(s_regs, id);
+	uint8_t rc = PCAP04_SetField(s_regs, id, value);
 	if (rc != 0U)
 	{
 		return rc;
 	}
-	uint8_t now = PCAP04_GetRegisterBit(s_regs, addr, bitname);
+	uint8_t now = PCAP04_GetField(s_regs, id);
 	if (old_value != NULL) *old_value = previous;
 	if (new_value != NULL) *new_value = now;
-	queue_reg_job(addr, s_regs[addr]);
+	mark_dirty(PCAP04_FIELD_INDEX[id].reg_addr);
+	flush_next_range();
 	return 0U;
 }
 
-uint8_t pcap04_if_reg_get(uint8_t addr, const char* bitname, uint8_t* out_value)
+uint8_t pcap04_if_field_get(PCAP04_FieldId_t id, uint8_t* out_value)
 {
 	/* 从镜像读取寄存器字段数值 */
 	ensure_regs_initialized();
-	if (addr >= PCAP04_REG_COUNT || bitname == NULL || out_value == NULL)
+	if ((uint32_t)id >= (uint32_t)PCAP04_FIELD_COUNT || PCAP04_FIELD_INDEX[id].reg_addr >= PCAP04_REG_COUNT ||
+	    out_value == NULL)
 	{
 		return 1U;
 	}
-	*out_value = PCAP04_GetRegisterBit(s_regs, addr, bitname);
+	*out_value = PCAP04_GetField(s_regs, id);
 	return 0U;
 }
 
+PCAP04_FieldId_t pcap04_if_field_id(uint8_t addr, const char* bitname)
+{
+	/* 字段名 -> 编号，并确认字段属于该寄存器 */
+	PCAP04_FieldId_t id = PCAP04_FindField(bitname);
+	if (id == PCAP04_FIELD_INVALID || PCAP04_FIELD_INDEX[id].reg_addr != addr)
+	{
+		return PCAP04_FIELD_INVALID;
+	}
+	return id;
+}
+
+uint8_t pcap04_if_reg_set(uint8_t addr, const char* bitname, uint8_t value, uint8_t* old_value, uint8_t* new_value)
+{
+	if (addr >= PCAP04_REG_COUNT || bitname == NULL)
+	{
+		return 1U;
+	}
+	return pcap04_if_field_set(pcap04_if_field_id(addr, bitname), value, old_value, new_value);
+}
+
+uint8_t pcap04_if_reg_get(uint8_t addr, const char* bitname, uint8_t* out_value)
+{
+	if (addr >= PCAP04_REG_COUNT || bitname == NULL)
+	{
+		return 1U;
+	}
+	return pcap04_if_field_get(pcap04_if_field_id(addr, bitname), out_value);
+}
+
 uint8_t pcap04_if_reg_byte(uint8_t addr)
 {
 	ensure_regs_initialized();
@@ -143,15 +226,19 @@ const uint8_t* pcap04_if_reg_snapshot(void)
 
 uint8_t pcap04_if_sync_all(void)
 {
-	/* 将镜像中的全部寄存器重新排队写入，返回排队数量 */
+	/* 将镜像中的全部寄存器置脏，合并为连续段写入，返回置脏数量 */
 	ensure_regs_initialized();
 	uint8_t queued = 0U;
 	for (uint8_t i = 0U; i < PCAP04_REGISTER_TABLE.registers_count; i++)
 	{
 		uint8_t addr = PCAP04_REGISTER_TABLE.registers[i].address;
-		queue_reg_job(addr, s_regs[addr]);
-		queued++;
+		if (addr < PCAP04_REG_COUNT)
+		{
+			mark_dirty(addr);
+			queued++;
+		}
 	}
+	flush_next_range();
 	return queued;
 }
 
@@ -179,37 +266,39 @@ uint8_t pcap04_if_fetch_event(pcap04_event_t* out)
 	return 1U;
 }
 
+uint8_t pcap04_if_sync_pending(void)
+{
+	uint8_t pending = (s_state != PCAP_IDLE) ? s_active_count : 0U;
+	for (uint8_t i = 0U; i < PCAP04_REG_COUNT; i++)
+	{
+		pending = (uint8_t)(pending + is_dirty(i));
+	}
+	return pending;
+}
+
 void pcap04_if_tick_5ms(void)
 {
-	if (s_state != PCAP_IDLE)
+	/* 正常情况下写入由置脏和完成中断直接推进，这里补发启动失败或 SPI 出错后恢复的脏寄存器 */
+	flush_next_range();
+}
+
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+	if (hspi != &hspi2)
 	{
 		return;
 	}
-	if (s_reg_count > 0U)
+	if (s_state == PCAP_REG_WRITE)
 	{
-		s_active_job = s_reg_queue[s_reg_head];
-		s_reg_head = (uint8_t)((s_reg_head + 1U) % PCAP04_REG_QUEUE_CAP);
-		s_reg_count--;
-
-		s_spi_tx_buf[0] = PCAP04_OPCODE_WRITE_REG;
-		s_spi_tx_buf[1] = s_active_job.addr;
-		s_spi_tx_buf[2] = s_active_job.value;
-		PCAP04_SPI_ASSERT_CS();
-		if (HAL_SPI_Transmit_IT(&hspi2, s_spi_tx_buf, 3U) == HAL_OK)
-		{
-			usb_cmd_pause_cdc();
-			s_state = PCAP_REG_WRITE;
-		}
-		else
-		{
-			PCAP04_SPI_RELEASE_CS();
-			push_event(PCAP04_EVENT_REG_SYNC_DONE, 1U, s_active_job.addr, s_active_job.value);
-			s_state = PCAP_IDLE;
-		}
+		PCAP04_SPI_RELEASE_CS();
+		s_state = PCAP_IDLE;
+		usb_cmd_resume_cdc();
+		push_event(PCAP04_EVENT_REG_SYNC_DONE, 0U, s_active_start, s_active_count);
+		flush_next_range();
 	}
 }
 
-void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
 {
 	if (hspi != &hspi2)
 	{
@@ -220,7 +309,9 @@ void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
 		PCAP04_SPI_RELEASE_CS();
 		s_state = PCAP_IDLE;
 		usb_cmd_resume_cdc();
-		push_event(PCAP04_EVENT_REG_SYNC_DONE, 0U, s_active_job.addr, s_active_job.value);
+		/* 这一段的脏位在开始发送时已清除，恢复后由 tick 重试，不在错误中断里立即重发 */
+		mark_range_dirty(s_active_start, s_active_count);
+		push_event(PCAP04_EVENT_REG_SYNC_DONE, 2U, s_active_start, s_active_count);
 	}
 }
 
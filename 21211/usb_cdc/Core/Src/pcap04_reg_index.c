@@ -0,0 +1,249 @@
+/* 本文件由 CDC_GUI/tools/gen_pcap04_reg_index.py 根据 pcap04_register_def.c 生成，请勿手工修改 */
+#include "pcap04_reg_index.h"
+#include <string.h>
+
+#define FIELD_HASH_SIZE   130U
+#define FIELD_HASH_BASIS  0x811C9DC5UL
+#define FIELD_HASH_PRIME  16777619UL
+
+const PCAP04_FieldIndex_t PCAP04_FIELD_INDEX[PCAP04_FIELD_COUNT] = {
+	{0x00U, 6U, 7U, 0U, 0U},
+	{0x00U, 2U, 5U, 0U, 1U},
+	{0x00U, 0U, 1U, 0U, 2U},
+	{0x01U, 7U, 7U, 1U, 0U},
+	{0x01U, 5U, 5U, 1U, 1U},
+	{0x01U, 0U, 2U, 1U, 2U},
+	{0x02U, 6U, 7U, 2U, 0U},
+	{0x02U, 4U, 5U, 2U, 1U},
+	{0x02U, 3U, 3U, 2U, 2U},
+	{0x02U, 1U, 1U, 2U, 3U},
+	{0x03U, 6U, 6U, 3U, 0U},
+	{0x03U, 5U, 5U, 3U, 1U},
+	{0x03U, 2U, 2U, 3U, 2U},
+	{0x03U, 1U, 1U, 3U, 3U},
+	{0x03U, 0U, 0U, 3U, 4U},
+	{0x04U, 7U, 7U, 4U, 0U},
+	{0x04U, 5U, 5U, 4U, 1U},
+	{0x04U, 4U, 4U, 4U, 2U},
+	{0x04U, 1U, 1U, 4U, 3U},
+	{0x04U, 0U, 0U, 4U, 4U},
+	{0x05U, 7U, 7U, 5U, 0U},
+	{0x05U, 5U, 5U, 5U, 1U},
+	{0x05U, 3U, 3U, 5U, 2U},
+	{0x05U, 2U, 2U, 5U, 3U},
+	{0x05U, 1U, 1U, 5U, 4U},
+	{0x05U, 0U, 0U, 5U, 5U},
+	{0x06U, 5U, 5U, 6U, 0U},
+	{0x06U, 4U, 4U, 6U, 1U},
+	{0x06U, 3U, 3U, 6U, 2U},
+	{0x06U, 2U, 2U, 6U, 3U},
+	{0x06U, 1U, 1U, 6U, 4U},
+	{0x06U, 0U, 0U, 6U, 5U},
+	{0x07U, 0U, 7U, 7U, 0U},
+	{0x08U, 0U, 4U, 8U, 0U},
+	{0x09U, 0U, 7U, 9U, 0U},
+	{0x0AU, 0U, 7U, 10U, 0U},
+	{0x0BU, 0U, 6U, 11U, 0U},
+	{0x0CU, 0U, 7U, 12U, 0U},
+	{0x0DU, 6U, 7U, 13U, 0U},
+	{0x0DU, 2U, 4U, 13U, 1U},
+	{0x0DU, 0U, 1U, 13U, 2U},
+	{0x0EU, 0U, 7U, 14U, 0U},
+	{0x0FU, 2U, 5U, 15U, 0U},
+	{0x0FU, 0U, 1U, 15U, 1U},
+	{0x10U, 0U, 7U, 16U, 0U},
+	{0x11U, 2U, 6U, 17U, 0U},
+	{0x11U, 0U, 1U, 17U, 1U},
+	{0x12U, 7U, 7U, 18U, 0U},
+	{0x12U, 6U, 6U, 18U, 1U},
+	{0x12U, 5U, 5U, 18U, 2U},
+	{0x12U, 4U, 4U, 18U, 3U},
+	{0x12U, 3U, 3U, 18U, 4U},
+	{0x12U, 2U, 2U, 18U, 5U},
+	{0x12U, 1U, 1U, 18U, 6U},
+	{0x12U, 0U, 0U, 18U, 7U},
+	{0x13U, 6U, 7U, 19U, 0U},
+	{0x13U, 4U, 5U, 19U, 1U},
+	{0x13U, 0U, 3U, 19U, 2U},
+	{0x14U, 7U, 7U, 20U, 0U},
+	{0x14U, 0U, 2U, 20U, 1U},
+	{0x15U, 0U, 7U, 21U, 0U},
+	{0x16U, 4U, 6U, 22U, 0U},
+	{0x16U, 2U, 3U, 22U, 1U},
+	{0x16U, 0U, 1U, 22U, 2U},
+	{0x17U, 7U, 7U, 23U, 0U},
+	{0x17U, 6U, 6U, 23U, 1U},
+	{0x17U, 5U, 5U, 23U, 2U},
+	{0x17U, 4U, 4U, 23U, 3U},
+	{0x17U, 2U, 2U, 23U, 4U},
+	{0x17U, 0U, 1U, 23U, 5U},
+	{0x18U, 4U, 5U, 24U, 0U},
+	{0x18U, 3U, 3U, 24U, 1U},
+	{0x18U, 2U, 2U, 24U, 2U},
+	{0x18U, 0U, 1U, 24U, 3U},
+	{0x19U, 2U, 7U, 25U, 0U},
+	{0x1AU, 2U, 7U, 26U, 0U},
+	{0x1AU, 1U, 1U, 26U, 1U},
+	{0x1BU, 6U, 7U, 27U, 0U},
+	{0x1BU, 2U, 3U, 27U, 1U},
+	{0x1BU, 1U, 1U, 27U, 2U},
+	{0x1BU, 0U, 0U, 27U, 3U},
+	{0x1CU, 0U, 7U, 28U, 0U},
+	{0x1DU, 4U, 7U, 29U, 0U},
+	{0x1DU, 0U, 3U, 29U, 1U},
+	{0x1EU, 7U, 7U, 30U, 0U},
+	{0x1EU, 6U, 6U, 30U, 1U},
+	{0x1EU, 2U, 2U, 30U, 2U},
+	{0x1EU, 1U, 1U, 30U, 3U},
+	{0x1EU, 0U, 0U, 30U, 4U},
+	{0x1FU, 7U, 7U, 31U, 0U},
+	{0x1FU, 6U, 6U, 31U, 1U},
+	{0x1FU, 4U, 5U, 31U, 2U},
+	{0x1FU, 3U, 3U, 31U, 3U},
+	{0x1FU, 0U, 2U, 31U, 4U},
+	{0x20U, 4U, 5U, 32U, 0U},
+	{0x20U, 3U, 3U, 32U, 1U},
+	{0x20U, 0U, 2U, 32U, 2U},
+	{0x21U, 7U, 7U, 33U, 0U},
+	{0x21U, 6U, 6U, 33U, 1U},
+	{0x21U, 5U, 5U, 33U, 2U},
+	{0x21U, 4U, 4U, 33U, 3U},
+	{0x21U, 3U, 3U, 33U, 4U},
+	{0x21U, 2U, 2U, 33U, 5U},
+	{0x21U, 1U, 1U, 33U, 6U},
+	{0x21U, 0U, 0U, 33U, 7U},
+	{0x22U, 7U, 7U, 34U, 0U},
+	{0x22U, 6U, 6U, 34U, 1U},
+	{0x22U, 5U, 5U, 34U, 2U},
+	{0x22U, 4U, 4U, 34U, 3U},
+	{0x23U, 0U, 7U, 35U, 0U},
+	{0x26U, 0U, 7U, 38U, 0U},
+	{0x27U, 4U, 7U, 39U, 0U},
+	{0x27U, 0U, 3U, 39U, 1U},
+	{0x28U, 0U, 7U, 40U, 0U},
+	{0x29U, 0U, 7U, 41U, 0U},
+	{0x2AU, 6U, 6U, 42U, 0U},
+	{0x2AU, 4U, 4U, 42U, 1U},
+	{0x2AU, 3U, 3U, 42U, 2U},
+	{0x2AU, 1U, 1U, 42U, 3U},
+	{0x2AU, 0U, 0U, 42U, 4U},
+	{0x2FU, 0U, 0U, 47U, 0U},
+	{0x30U, 3U, 3U, 48U, 0U},
+	{0x30U, 2U, 2U, 48U, 1U},
+	{0x30U, 1U, 1U, 48U, 2U},
+	{0x30U, 0U, 0U, 48U, 3U},
+	{0x31U, 0U, 7U, 49U, 0U},
+	{0x32U, 0U, 7U, 50U, 0U},
+	{0x36U, 0U, 7U, 54U, 0U},
+	{0x3EU, 0U, 7U, 62U, 0U},
+	{0x3FU, 0U, 7U, 63U, 0U}
+};
+
+/* 一级哈希桶 -> 种子（>=0）或直接位置（-位置-1） */
+static const int16_t s_field_disp[FIELD_HASH_SIZE] = {
+	2, 0, -129, -128, -127, 1, 2, 0, 1, 0, -126, -121, -114, -109, 1, 0,
+	-106, 2, -103, -102, -97, 0, 0, 2, 2, 0, 0, 0, 2, 0, 1, 2,
+	0, -87, -82, -76, -75, 0, 0, 1, 1, 1, -74, -70, -69, -68, -67, 0,
+	-64, 0, 1, 0, -62, -61, 0, 0, 1, 3, 3, 0, -59, 0, -57, -55,
+	4, 4, 2, 5, -54, -51, -50, -49, 0, 0, -47, 0, 0, -46, 0, -45,
+	-44, -43, 1, 0, -41, -37, 0, 0, 0, 7, 6, 0, 0, -36, -34, 3,
+	-33, 0, 0, 0, -32, 0, -30, -27, 2, -26, 0, 2, 7, -23, 5, -21,
+	-19, 3, 1, 0, 0, 0, 2, 0, -18, 1, 0, -12, 0, 0, 0, -9,
+	-5, -2
+};
+
+/* 哈希位置 -> 字段编号 */
+static const uint8_t s_field_slot[FIELD_HASH_SIZE] = {
+	129U, 87U, 101U, 61U, 74U, 103U, 26U, 82U, 41U, 22U, 118U, 68U, 71U, 84U, 42U, 122U,
+	34U, 32U, 73U, 128U, 49U, 112U, 35U, 33U, 76U, 46U, 53U, 99U, 100U, 110U, 5U, 52U,
+	16U, 85U, 58U, 3U, 30U, 63U, 114U, 19U, 104U, 97U, 93U, 60U, 116U, 120U, 123U, 115U,
+	51U, 95U, 105U, 96U, 69U, 127U, 1U, 80U, 27U, 47U, 39U, 56U, 43U, 57U, 14U, 12U,
+	48U, 121U, 108U, 45U, 92U, 81U, 94U, 13U, 11U, 24U, 23U, 20U, 72U, 91U, 54U, 7U,
+	18U, 40U, 88U, 117U, 64U, 109U, 10U, 59U, 44U, 126U, 2U, 6U, 4U, 38U, 98U, 86U,
+	66U, 17U, 21U, 55U, 83U, 8U, 15U, 111U, 77U, 50U, 28U, 70U, 107U, 79U, 31U, 65U,
+	89U, 62U, 0U, 36U, 29U, 75U, 124U, 25U, 9U, 106U, 90U, 37U, 125U, 78U, 102U, 119U,
+	113U, 67U
+};
+
+/* 寄存器地址 -> PCAP04_REGISTER_TABLE 下标，0xFF 为未定义 */
+static const uint8_t s_reg_pos[PCAP04_REG_ADDR_LIMIT] = {
+	0x00U, 0x01U, 0x02U, 0x03U, 0x04U, 0x05U, 0x06U, 0x07U, 0x08U, 0x09U, 0x0AU, 0x0BU, 0x0CU, 0x0DU, 0x0EU, 0x0FU,
+	0x10U, 0x11U, 0x12U, 0x13U, 0x14U, 0x15U, 0x16U, 0x17U, 0x18U, 0x19U, 0x1AU, 0x1BU, 0x1CU, 0x1DU, 0x1EU, 0x1FU,
+	0x20U, 0x21U, 0x22U, 0x23U, 0x24U, 0x25U, 0x26U, 0x27U, 0x28U, 0x29U, 0x2AU, 0x2BU, 0x2CU, 0x2DU, 0x2EU, 0x2FU,
+	0x30U, 0x31U, 0x32U, 0x33U, 0x34U, 0x35U, 0x36U, 0x37U, 0x38U, 0x39U, 0x3AU, 0x3BU, 0x3CU, 0x3DU, 0x3EU, 0x3FU
+};
+
+static uint32_t field_hash(uint32_t seed, const char *name)
+{
+	uint32_t h = seed;
+	while (*name != '\0')
+	{
+		h = (h ^ (uint8_t)*name++) * FIELD_HASH_PRIME;
+	}
+	return h;
+}
+
+PCAP04_FieldId_t PCAP04_FindField(const char *name)
+{
+	if (name == NULL)
+	{
+		return PCAP04_FIELD_INVALID;
+	}
+	int16_t d = s_field_disp[field_hash(FIELD_HASH_BASIS, name) % FIELD_HASH_SIZE];
+	uint32_t slot = (d < 0) ? (uint32_t)(-d - 1) : (field_hash((uint32_t)d, name) % FIELD_HASH_SIZE);
+	PCAP04_FieldId_t id = (PCAP04_FieldId_t)s_field_slot[slot];
+	/* 完美哈希只保证已知字段不冲突，未知名称也会落到某个位置，需比较一次名称 */
+	if (strcmp(PCAP04_GetFieldDefinition(id)->name, name) != 0)
+	{
+		return PCAP04_FIELD_INVALID;
+	}
+	return id;
+}
+
+const PCAP04_RegBit_t* PCAP04_GetFieldDefinition(PCAP04_FieldId_t id)
+{
+	if ((uint32_t)id >= (uint32_t)PCAP04_FIELD_COUNT)
+	{
+		return NULL;
+	}
+	const PCAP04_FieldIndex_t *f = &PCAP04_FIELD_INDEX[id];
+	return &PCAP04_REGISTER_TABLE.registers[f->reg_pos].bits[f->bit_index];
+}
+
+const PCAP04_Register_t* PCAP04_FindRegisterIndex(uint8_t reg_addr)
+{
+	if (reg_addr >= PCAP04_REG_ADDR_LIMIT || s_reg_pos[reg_addr] == 0xFFU)
+	{
+		return NULL;
+	}
+	return &PCAP04_REGISTER_TABLE.registers[s_reg_pos[reg_addr]];
+}
+
+uint8_t PCAP04_SetField(uint8_t *reg_array, PCAP04_FieldId_t id, uint8_t value)
+{
+	if (reg_array == NULL || (uint32_t)id >= (uint32_t)PCAP04_FIELD_COUNT)
+	{
+		return 1U;
+	}
+	const PCAP04_FieldIndex_t *f = &PCAP04_FIELD_INDEX[id];
+	if (f->reg_addr >= PCAP04_REG_COUNT)
+	{
+		return 1U;
+	}
+	reg_array[f->reg_addr] = PCAP04_SetBitValue(reg_array[f->reg_addr], f->bit_start, f->bit_end, value);
+	return 0U;
+}
+
+uint8_t PCAP04_GetField(const uint8_t *reg_array, PCAP04_FieldId_t id)
+{
+	if (reg_array == NULL || (uint32_t)id >= (uint32_t)PCAP04_FIELD_COUNT)
+	{
+		return 0U;
+	}
+	const PCAP04_FieldIndex_t *f = &PCAP04_FIELD_INDEX[id];
+	if (f->reg_addr >= PCAP04_REG_COUNT)
+	{
+		return 0U;
+	}
+	return PCAP04_GetBitValue(reg_array[f->reg_addr], f->bit_start, f->bit_end);
+}
@@ -1,4 +1,5 @@
 #include "pcap04_register.h"
+#include "pcap04_reg_index.h"
 #include <string.h>
 #include <stdio.h>
 
@@ -7,6 +8,8 @@
  * 该文件提供 PCAP04 寄存器配置相关的通用工具，包括寄存器描述查找、
  * 位段读写、寄存器打印以及（示例）Flash 存取占位函数。所有接口均以
  * 寄存器镜像数组为输入，便于上层维护本地缓存并批量写入设备。
+ * 寄存器/位段查找使用 pcap04_reg_index.c 中生成的索引（地址直接下标、字段名完美哈希），
+ * 修改 pcap04_register_def.c 后需运行 CDC_GUI/tools/gen_pcap04_reg_index.py 重新生成。
  */
 
 static const PCAP04_Register_t* PCAP04_FindRegister(uint8_t reg_addr);
@@ -43,14 +46,7 @@ const PCAP04_Register_t* PCAP04_GetRegisterDefinition(uint8_t reg_addr)
 
 static const PCAP04_Register_t* PCAP04_FindRegister(uint8_t reg_addr)
 {
-	for (uint8_t i = 0; i < PCAP04_REGISTER_TABLE.registers_count; i++)
-	{
-		if (PCAP04_REGISTER_TABLE.registers[i].address == reg_addr)
-		{
-			return &PCAP04_REGISTER_TABLE.registers[i];
-		}
-	}
-	return NULL;
+	return PCAP04_FindRegisterIndex(reg_addr);
 }
 
 static const PCAP04_RegBit_t* PCAP04_FindBit(const PCAP04_Register_t *reg, const char *bit_name)
@@ -59,14 +55,13 @@ static const PCAP04_RegBit_t* PCAP04_FindBit(const PCAP04_Register_t *reg, const
 	{
 		return NULL;
 	}
-	for (uint8_t i = 0; i < reg->bits_count; i++)
+	/* 字段名全表唯一：哈希查到后核对所属寄存器 */
+	PCAP04_FieldId_t id = PCAP04_FindField(bit_name);
+	if (id == PCAP04_FIELD_INVALID || PCAP04_FIELD_INDEX[id].reg_addr != reg->address)
 	{
-		if (strcmp(reg->bits[i].name, bit_name) == 0)
-		{
-			return &reg->bits[i];
-		}
+		return NULL;
 	}
-	return NULL;
+	return PCAP04_GetFieldDefinition(id);
 }
 
 void PCAP04_InitRegisters(uint8_t *reg_array)
@@ -88,6 +88,9 @@ void HAL_SPI_MspInit(SPI_HandleTypeDef* spiHandle)
     HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
 
   /* USER CODE BEGIN SPI2_MspInit 1 */
+    /* pcap04_if 寄存器同步使用中断发送；与 TIM2 命令处理同一抢占优先级，互不打断 */
+    HAL_NVIC_SetPriority(SPI2_IRQn, 1, 0);
+    HAL_NVIC_EnableIRQ(SPI2_IRQn);
 
   /* USER CODE END SPI2_MspInit 1 */
   }
@@ -112,6 +115,7 @@ void HAL_SPI_MspDeInit(SPI_HandleTypeDef* spiHandle)
     HAL_GPIO_DeInit(GPIOB, GPIO_PIN_13|GPIO_PIN_14|GPIO_PIN_15);
 
   /* USER CODE BEGIN SPI2_MspDeInit 1 */
+    HAL_NVIC_DisableIRQ(SPI2_IRQn);
 
   /* USER CODE END SPI2_MspDeInit 1 */
   }
@@ -58,6 +58,7 @@
 extern PCD_HandleTypeDef hpcd_USB_FS;
 extern TIM_HandleTypeDef htim2;
 /* USER CODE BEGIN EV */
+extern SPI_HandleTypeDef hspi2;
 
 /* USER CODE END EV */
 
@@ -228,5 +229,11 @@ void TIM2_IRQHandler(void)
 }
 
 /* USER CODE BEGIN 1 */
-
+/**
+  * @brief This function handles SPI2 global interrupt (pcap04_if register sync).
+  */
+void SPI2_IRQHandler(void)
+{
+  HAL_SPI_IRQHandler(&hspi2);
+}
 /* USER CODE END 1 */
@@ -188,28 +188,17 @@ static void queue_err(const char* tag, const char* fmt, ...)
 	(void)queue_response_fmt("ERR", tag != NULL ? tag : "CMD", "%s", buffer);
 }
 
+/* 把排队的响应尽量多地写入CDC发送环形缓冲区，端点由发送完成回调持续推进 */
 static void pump_tx(void)
 {
-	if (resp_count == 0U)
-	{
-		return;
-	}
-	if (CDC_TxBusy_FS() != USBD_OK)
-	{
-		return;
-	}
-
-	const char* msg = resp_msgs[resp_head];
-	uint16_t len = (uint16_t)strlen(msg);
-	if (len == 0U)
-	{
-		resp_head = (uint8_t)((resp_head + 1U) % RESP_QUEUE_CAP);
-		resp_count--;
-		return;
-	}
-
-	if (CDC_FS_Send((const uint8_t*)msg, len) == USBD_OK)
+	while (resp_count > 0U)
 	{
+		const char* msg = resp_msgs[resp_head];
+		uint16_t len = (uint16_t)strlen(msg);
+		if (len != 0U && CDC_FS_Send((const uint8_t*)msg, len) != USBD_OK)
+		{
+			return;
+		}
 		resp_head = (uint8_t)((resp_head + 1U) % RESP_QUEUE_CAP);
 		resp_count--;
 	}
@@ -249,23 +238,6 @@ static const PCAP04_Register_t* get_register_def(uint8_t addr)
 	return PCAP04_GetRegisterDefinition(addr);
 }
 
-static const PCAP04_RegBit_t* find_bit_def(const PCAP04_Register_t* reg, const char* name)
-{
-	if (reg == NULL || name == NULL)
-	{
-		return NULL;
-	}
-	for (uint8_t i = 0U; i < reg->bits_count; i++)
-	{
-		const PCAP04_RegBit_t* bit = &reg->bits[i];
-		if (strcmp(bit->name, name) == 0)
-		{
-			return bit;
-		}
-	}
-	return NULL;
-}
-
 static const PCAP04_BitOption_t* find_bit_option(const PCAP04_RegBit_t* bit, uint8_t field_value)
 {
 	if (bit == NULL || bit->options == NULL)
@@ -460,7 +432,7 @@ static void handle_pcap_command(const char* args)
 	else if (strcmp(sub, "SYNC") == 0 || strcmp(sub, "INIT") == 0)
 	{
 		uint8_t count = pcap04_if_sync_all();
-		queue_ok("PCAP", "queued %u register writes", (unsigned)count);
+		queue_ok("PCAP", "%u registers marked for sync", (unsigned)count);
 	}
 	else
 	{
@@ -505,21 +477,21 @@ static void handle_reg_command(const char* args)
 			return;
 		}
 
+		/* 名称只查一次（完美哈希），之后按字段编号读写和输出 */
+		PCAP04_FieldId_t field = pcap04_if_field_id((uint8_t)addr, bitname);
+		if (field == PCAP04_FIELD_INVALID)
+		{
+			queue_err("REG", "unknown bit field '%s' in 0x%02X", bitname, (unsigned)addr);
+			return;
+		}
+
 		uint8_t old_val = 0U;
 		uint8_t new_val = 0U;
-		uint8_t rc = pcap04_if_reg_set((uint8_t)addr, bitname, (uint8_t)val, &old_val, &new_val);
+		uint8_t rc = pcap04_if_field_set(field, (uint8_t)val, &old_val, &new_val);
 		if (rc == 0U)
 		{
 			queue_ok("REG", "SET 0x%02X.%s: %u->%u", (unsigned)addr, bitname, (unsigned)old_val, (unsigned)new_val);
-			const PCAP04_Register_t* def = get_register_def((uint8_t)addr);
-			if (def != NULL)
-			{
-				const PCAP04_RegBit_t* bit_def = find_bit_def(def, bitname);
-				if (bit_def != NULL)
-				{
-					queue_reg_bit_detail((uint8_t)addr, bit_def, new_val);
-				}
-			}
+			queue_reg_bit_detail((uint8_t)addr, PCAP04_GetFieldDefinition(field), new_val);
 		}
 		else
 		{
@@ -545,20 +517,19 @@ static void handle_reg_command(const char* args)
 			return;
 		}
 
+		PCAP04_FieldId_t field = pcap04_if_field_id((uint8_t)addr, bitname);
+		if (field == PCAP04_FIELD_INVALID)
+		{
+			queue_err("REG", "unknown bit field '%s' in 0x%02X", bitname, (unsigned)addr);
+			return;
+		}
+
 		uint8_t value = 0U;
-		uint8_t rc = pcap04_if_reg_get((uint8_t)addr, bitname, &value);
+		uint8_t rc = pcap04_if_field_get(field, &value);
 		if (rc == 0U)
 		{
 			queue_ok("REG", "GET 0x%02X.%s=0x%02X", (unsigned)addr, bitname, value);
-			const PCAP04_Register_t* def = get_register_def((uint8_t)addr);
-			if (def != NULL)
-			{
-				const PCAP04_RegBit_t* bit_def = find_bit_def(def, bitname);
-				if (bit_def != NULL)
-				{
-					queue_reg_bit_detail((uint8_t)addr, bit_def, value);
-				}
-			}
+			queue_reg_bit_detail((uint8_t)addr, PCAP04_GetFieldDefinition(field), value);
 		}
 		else
 		{
@@ -682,6 +653,39 @@ static void handle_scan_command(const char* args)
 		mux_enable(1U);
 		queue_ok("SCAN", "column %u", (unsigned)col);
 	}
+	else if (strcmp(mode_tok, "ORDER") == 0)
+	{
+		static const char* const names[] = {"BINARY", "SERPENTINE", "GRAY"};
+		char order_tok[16];
+		read_token(rest, order_tok, sizeof(order_tok));
+		for (char* p = order_tok; *p != '\0'; ++p)
+		{
+			*p = (char)toupper((unsigned char)*p);
+		}
+		if (order_tok[0] == '\0')
+		{
+			queue_ok("SCAN", "order=%s", names[mux_get_order()]);
+			return;
+		}
+		if (strcmp(order_tok, "BINARY") == 0)
+		{
+			mux_set_order(MUX_ORDER_BINARY);
+		}
+		else if (strcmp(order_tok, "SERPENTINE") == 0 || strcmp(order_tok, "SERP") == 0)
+		{
+			mux_set_order(MUX_ORDER_SERPENTINE);
+		}
+		else if (strcmp(order_tok, "GRAY") == 0)
+		{
+			mux_set_order(MUX_ORDER_GRAY);
+		}
+		else
+		{
+			queue_err("SCAN", "ORDER requires BINARY, SERPENTINE or GRAY");
+			return;
+		}
+		queue_ok("SCAN", "order=%s", names[mux_get_order()]);
+	}
 	else if (strcmp(mode_tok, "EN") == 0)
 	{
 		char en_tok[8];
@@ -737,7 +741,15 @@ static void usb_cmd_process_core(uint8_t periodic_tick)
 		switch (evt.type)
 		{
 		case PCAP04_EVENT_REG_SYNC_DONE:
-			queue_ok("PCAP", "register 0x%02X synchronized (rc=%u)", evt.reg_addr, evt.status);
+			if (evt.reg_count > 1U)
+			{
+				queue_ok("PCAP", "registers 0x%02X-0x%02X synchronized (%u bytes, rc=%u)",
+				         evt.reg_addr, (unsigned)(evt.reg_addr + evt.reg_count - 1U), evt.reg_count, evt.status);
+			}
+			else
+			{
+				queue_ok("PCAP", "register 0x%02X synchronized (rc=%u)", evt.reg_addr, evt.status);
+			}
 			break;
 		case PCAP04_EVENT_FIRMWARE_DONE:
 			if (evt.status == 0U)
@@ -94,17 +94,17 @@ uint8_t UserRxBufferFS[APP_RX_DATA_SIZE];
 uint8_t UserTxBufferFS[APP_TX_DATA_SIZE];
 
 /* USER CODE BEGIN PRIVATE_VARIABLES */
-/* Software double-buffer for Full-Speed 64B packets, with busy flags */
 #include "string.h"
 static volatile uint32_t s_rxLen = 0U;
 
-/* Two 64-byte TX packet buffers (Full-Speed max packet size) */
-static uint8_t s_txBuf[2][CDC_DATA_FS_MAX_PACKET_SIZE];
-static uint16_t s_txLen[2] = {0U, 0U};
-static volatile uint8_t s_txActiveIdx = 0U;
-static volatile uint8_t s_txNextIdx = 1U;
-static volatile uint8_t s_txPendingCount = 0U; /* 0..2 queued (including in-flight) */
-static volatile uint8_t s_txInFlight = 0U;      /* 1 if a packet has been submitted */
+/* TX byte ring drained by the IN endpoint completion callback.
+   s_txHead/s_txTail are free-running (count = head - tail):
+   head is advanced only by CDC_TxRing_Write (thread context),
+   tail only when a transfer completes (USB interrupt). */
+static uint8_t s_txRing[CDC_TX_RING_SIZE];
+static volatile uint16_t s_txHead = 0U;
+static volatile uint16_t s_txTail = 0U;
+static volatile uint16_t s_txInFlight = 0U;     /* bytes of the submitted transfer, 0 = endpoint idle */
 
 /* USER CODE END PRIVATE_VARIABLES */
 
@@ -136,8 +136,10 @@ static int8_t CDC_Init_FS(void);
 static int8_t CDC_DeInit_FS(void);
 static int8_t CDC_Control_FS(uint8_t cmd, uint8_t* pbuf, uint16_t length);
 static int8_t CDC_Receive_FS(uint8_t* pbuf, uint32_t *Len);
+static int8_t CDC_TransmitCplt_FS(uint8_t *pbuf, uint32_t *Len, uint8_t epnum);
 
 /* USER CODE BEGIN PRIVATE_FUNCTIONS_DECLARATION */
+static void CDC_TxRing_Kick(void);
 
 /* USER CODE END PRIVATE_FUNCTIONS_DECLARATION */
 
@@ -150,7 +152,8 @@ USBD_CDC_ItfTypeDef USBD_Interface_fops_FS =
   CDC_Init_FS,
   CDC_DeInit_FS,
   CDC_Control_FS,
-  CDC_Receive_FS
+  CDC_Receive_FS,
+  CDC_TransmitCplt_FS
 };
 
 /* Private functions ---------------------------------------------------------*/
@@ -164,6 +167,9 @@ static int8_t CDC_Init_FS(void)
   /* Set Application Buffers */
   USBD_CDC_SetTxBuffer(&hUsbDeviceFS, UserTxBufferFS, 0);
   USBD_CDC_SetRxBuffer(&hUsbDeviceFS, UserRxBufferFS);
+  /* Drop anything queued before the host configured the device */
+  s_txInFlight = 0U;
+  s_txTail = s_txHead;
   return (USBD_OK);
   /* USER CODE END 3 */
 }
@@ -175,6 +181,9 @@ static int8_t CDC_Init_FS(void)
 static int8_t CDC_DeInit_FS(void)
 {
   /* USER CODE BEGIN 4 */
+  /* Any in-flight transfer is aborted with the endpoint */
+  s_txInFlight = 0U;
+  s_txTail = s_txHead;
   return (USBD_OK);
   /* USER CODE END 4 */
 }
@@ -298,16 +307,39 @@ uint8_t CDC_Transmit_FS(uint8_t* Buf, uint16_t Len)
 {
   uint8_t result = USBD_OK;
   /* USER CODE BEGIN 7 */
-  USBD_CDC_HandleTypeDef *hcdc = (USBD_CDC_HandleTypeDef*)hUsbDeviceFS.pClassData;
-  if (hcdc->TxState != 0){
-    return USBD_BUSY;
-  }
-  USBD_CDC_SetTxBuffer(&hUsbDeviceFS, Buf, Len);
-  result = USBD_CDC_TransmitPacket(&hUsbDeviceFS);
+  /* Share the TX ring so direct callers cannot collide with queued data */
+  result = CDC_FS_Send(Buf, Len);
   /* USER CODE END 7 */
   return result;
 }
 
+/**
+  * @brief  CDC_TransmitCplt_FS
+  *         Data transmitted callback
+  *
+  *         @note
+  *         This function is IN transfer complete callback used to inform user that
+  *         the submitted Data is successfully sent over USB.
+  *
+  * @param  Buf: Buffer of data to be received
+  * @param  Len: Number of data received (in bytes)
+  * @retval Result of the operation: USBD_OK if all operations are OK else USBD_FAIL
+  */
+static int8_t CDC_TransmitCplt_FS(uint8_t *Buf, uint32_t *Len, uint8_t epnum)
+{
+  uint8_t result = USBD_OK;
+  /* USER CODE BEGIN 13 */
+  UNUSED(Buf);
+  UNUSED(Len);
+  UNUSED(epnum);
+  /* Release the sent span (and its ZLP, if any) and keep the endpoint busy */
+  s_txTail = (uint16_t)(s_txTail + s_txInFlight);
+  s_txInFlight = 0U;
+  CDC_TxRing_Kick();
+  /* USER CODE END 13 */
+  return result;
+}
+
 /* USER CODE BEGIN PRIVATE_FUNCTIONS_IMPLEMENTATION */
 uint32_t CDC_RxLen_FS(void)
 {
@@ -319,120 +351,108 @@ void CDC_ClearRxLen_FS(void)
   s_rxLen = 0U;
 }
 
-/* Kick next queued TX packet if link is idle; return BUSY if still transmitting. */
-uint8_t CDC_TxBusy_FS(void)
+/* Submit the next contiguous span of the ring if the endpoint is idle.
+   Runs in the USB interrupt (completion callback) or with interrupts masked.
+   The span is sent straight from the ring; the class appends a ZLP when a
+   span ends on a 64-byte packet boundary, so the host always sees the
+   transfer terminate. */
+static void CDC_TxRing_Kick(void)
 {
-  USBD_CDC_HandleTypeDef *hcdc = (USBD_CDC_HandleTypeDef*)hUsbDeviceFS.pClassData;
-  if (hcdc == NULL)
+  if (s_txInFlight != 0U || hUsbDeviceFS.pClassData == NULL)
   {
-    return USBD_BUSY;
+    return;
+  }
+
+  uint16_t count = (uint16_t)(s_txHead - s_txTail);
+  if (count == 0U)
+  {
+    return;
+  }
+
+  uint16_t offset = (uint16_t)(s_txTail & (CDC_TX_RING_SIZE - 1U));
+  uint16_t span = (uint16_t)(CDC_TX_RING_SIZE - offset);
+  if (span > count)
+  {
+    span = count;
   }
 
-  if (hcdc->TxState == 0U)
+  USBD_CDC_SetTxBuffer(&hUsbDeviceFS, &s_txRing[offset], span);
+  if (USBD_CDC_TransmitPacket(&hUsbDeviceFS) == USBD_OK)
   {
-    /* If a previously submitted transfer just completed, account and rotate */
-    if (s_txInFlight == 1U)
-    {
-      s_txInFlight = 0U;
-      if (s_txPendingCount > 0U)
-      {
-        s_txPendingCount--;
-      }
-      /* Move active index to the buffer that was previously queued */
-      s_txActiveIdx ^= 1U;
-      s_txNextIdx ^= 1U;
-    }
-
-    /* If there is still any pending packet, (re)start it now */
-    if (s_txPendingCount > 0U)
-    {
-      USBD_CDC_SetTxBuffer(&hUsbDeviceFS, s_txBuf[s_txActiveIdx], s_txLen[s_txActiveIdx]);
-      if (USBD_CDC_TransmitPacket(&hUsbDeviceFS) == USBD_OK)
-      {
-        s_txInFlight = 1U;
-      }
-      else
-      {
-        return USBD_BUSY;
-      }
-    }
+    s_txInFlight = span;
   }
-  return (hcdc->TxState == 0U) ? USBD_OK : USBD_BUSY;
 }
 
-/* Enqueue data for FS transmission with 64B packetization using software double buffer.
-   - Non-blocking; returns USBD_OK if fully enqueued, USBD_BUSY if queue is full (some tail not queued).
-   - Maintains send order; main loop should call CDC_TxBusy_FS() periodically to advance. */
-uint8_t CDC_FS_Send(const uint8_t* data, uint16_t length)
+/* Copy up to length bytes into the TX ring and start the endpoint if idle.
+   Non-blocking; returns the number of bytes accepted (0 when the ring is full). */
+uint16_t CDC_TxRing_Write(const uint8_t* data, uint16_t length)
 {
   if (data == NULL || length == 0U)
   {
-    return USBD_OK;
+    return 0U;
   }
 
-  uint16_t remaining = length;
-  const uint8_t* cursor = data;
-  uint8_t status = USBD_OK;
+  uint16_t free_bytes = (uint16_t)(CDC_TX_RING_SIZE - (uint16_t)(s_txHead - s_txTail));
+  uint16_t n = (length > free_bytes) ? free_bytes : length;
+  if (n == 0U)
+  {
+    return 0U;
+  }
 
-  while (remaining > 0U)
+  uint16_t offset = (uint16_t)(s_txHead & (CDC_TX_RING_SIZE - 1U));
+  uint16_t first = (uint16_t)(CDC_TX_RING_SIZE - offset);
+  if (first > n)
+  {
+    first = n;
+  }
+  memcpy(&s_txRing[offset], data, first);
+  if (n > first)
   {
-    uint16_t chunk = (remaining > CDC_DATA_FS_MAX_PACKET_SIZE) ? CDC_DATA_FS_MAX_PACKET_SIZE : remaining;
-
-    USBD_CDC_HandleTypeDef *hcdc = (USBD_CDC_HandleTypeDef*)hUsbDeviceFS.pClassData;
-    if (hcdc == NULL)
-    {
-      return USBD_BUSY;
-    }
-
-    /* If link idle and nothing pending, send immediately using active buffer */
-    if ((hcdc->TxState == 0U) && (s_txPendingCount == 0U))
-    {
-      memcpy(s_txBuf[s_txActiveIdx], cursor, chunk);
-      s_txLen[s_txActiveIdx] = chunk;
-      USBD_CDC_SetTxBuffer(&hUsbDeviceFS, s_txBuf[s_txActiveIdx], s_txLen[s_txActiveIdx]);
-      if (USBD_CDC_TransmitPacket(&hUsbDeviceFS) != USBD_OK)
-      {
-        /* Could not start; treat as busy */
-        status = USBD_BUSY;
-        break;
-      }
-      s_txPendingCount = 1U; /* in-flight one */
-      s_txInFlight = 1U;
-    }
-    else
-    {
-      /* Use the next queue slot if available (max 2 total including in-flight) */
-      if (s_txPendingCount >= 2U)
-      {
-        status = USBD_BUSY;
-        break;
-      }
-      memcpy(s_txBuf[s_txNextIdx], cursor, chunk);
-      s_txLen[s_txNextIdx] = chunk;
-      /* We only mark as pending; actual transmit will be kicked by CDC_TxBusy_FS when the link is idle */
-      s_txPendingCount++;
-      /* Rotate next index (ping-pong 0<->1) */
-      s_txNextIdx ^= 1U;
-      /* If we just queued the second buffer while first is in-flight, do nothing else now */
-    }
-
-    cursor += chunk;
-    remaining = (uint16_t)(remaining - chunk);
-
-    /* Attempt to advance if possible */
-    (void)CDC_TxBusy_FS();
-
-    /* If the in-flight transfer just finished and there is a queued packet in the "other" buffer,
-       we need to rotate active index when the USB core clears TxState. This is polled via CDC_TxBusy_FS(). */
+    memcpy(&s_txRing[0], &data[first], (size_t)(n - first));
   }
+  __DMB();
+  s_txHead = (uint16_t)(s_txHead + n);
 
-  /* If the in-flight packet completed and a queued one exists, rotate indices.
-     We detect completion by TxState==0 while we still have pending data not yet started.
-     The rotation is applied when we actually start the next transfer in CDC_TxBusy_FS().
-     To ensure the active/next indices are consistent after completion, whenever a transfer
-     completes (TxState goes 0), we move the active index to the buffer that was previously queued. */
+  /* The completion interrupt may be starting a transfer at the same time */
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  CDC_TxRing_Kick();
+  __set_PRIMASK(primask);
 
-  return status;
+  return n;
+}
+
+/* Free space in the TX ring (bytes) */
+uint16_t CDC_TxRing_Free(void)
+{
+  return (uint16_t)(CDC_TX_RING_SIZE - (uint16_t)(s_txHead - s_txTail));
+}
+
+/* Return BUSY while queued or in-flight TX data remains; the ring drains on its own. */
+uint8_t CDC_TxBusy_FS(void)
+{
+  if (hUsbDeviceFS.pClassData == NULL)
+  {
+    return USBD_BUSY;
+  }
+  return (s_txHead != s_txTail) ? USBD_BUSY : USBD_OK;
+}
+
+/* Enqueue a whole message: returns USBD_OK if all of it fit in the TX ring,
+   USBD_BUSY (nothing queued) otherwise, so callers can retry the same message
+   without duplicating a partial head. */
+uint8_t CDC_FS_Send(const uint8_t* data, uint16_t length)
+{
+  if (data == NULL || length == 0U)
+  {
+    return USBD_OK;
+  }
+  if (hUsbDeviceFS.pClassData == NULL || CDC_TxRing_Free() < length)
+  {
+    return USBD_BUSY;
+  }
+  (void)CDC_TxRing_Write(data, length);
+  return USBD_OK;
 }
 
 /* Convenience API: send CRLF */
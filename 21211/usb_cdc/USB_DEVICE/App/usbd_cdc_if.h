@@ -51,6 +51,8 @@
 #define APP_RX_DATA_SIZE  1024
 #define APP_TX_DATA_SIZE  1024
 /* USER CODE BEGIN EXPORTED_DEFINES */
+/* TX byte ring drained from the IN completion callback (power of two, <= 32768) */
+#define CDC_TX_RING_SIZE  2048U
 
 /* USER CODE END EXPORTED_DEFINES */
 
@@ -108,9 +110,11 @@ extern USBD_CDC_ItfTypeDef USBD_Interface_fops_FS;
 uint8_t CDC_Transmit_FS(uint8_t* Buf, uint16_t Len);
 
 /* USER CODE BEGIN EXPORTED_FUNCTIONS */
-/* Non-blocking helpers and double-buffered send APIs (Full-Speed, 64B packets) */
+/* Non-blocking TX ring; the IN endpoint is restarted from the completion callback */
+uint16_t CDC_TxRing_Write(const uint8_t* data, uint16_t length);  /* returns bytes accepted */
+uint16_t CDC_TxRing_Free(void);
 uint8_t CDC_TxBusy_FS(void);
-uint8_t CDC_FS_Send(const uint8_t* data, uint16_t length);
+uint8_t CDC_FS_Send(const uint8_t* data, uint16_t length);        /* all-or-nothing */
 uint8_t CDC_Transmit_CRLF_FS(void);
 
 /* Simple RX helpers */
@@ -0,0 +1,252 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+二进制矩阵帧解码模块（SET_FORMAT:binary）
+线路格式：0x00 | COBS(帧头 | 数据 | CRC-32) | 0x00
+帧之间的文本响应（OK:/START/END等）按行拆出
+差分帧（SET_DELTA）由 FrameDecoder 基于上一帧重建为完整帧
+"""
+
+import struct
+import zlib
+
+FRAME_MAGIC = 0x5AA5
+FRAME_VERSION = 3
+# magic, version, flags, seq, timestamp_us, rows, cols, value_bits, reserved, payload_len, end_us
+FRAME_HEADER = struct.Struct('<HBBIIBBBBHI')
+FRAME_CRC_SIZE = 4
+FRAME_FLAG_QUANT = 0x01
+FRAME_FLAG_PACKED = 0x02  # 值按 value_bits 位打包（10位：每4个值5字节）
+FRAME_FLAG_DELTA = 0x04   # 帧间差分：base_seq + zigzag varint 记号
+FRAME_MAX_ENCODED = 8192  # 超过此长度仍未遇到分隔符则丢弃（失步保护）
+
+_VALUE_FORMATS = {8: 'B', 16: 'H', 32: 'I'}  # 按字节对齐的值
+
+
+class MatrixFrame:
+    """解码后的一帧"""
+
+    __slots__ = ('seq', 'timestamp_us', 'end_us', 'rows', 'cols', 'value_bits', 'quantized', 'packed', 'values',
+                 'delta', 'base_seq', 'deltas', 'host_time')
+
+    def __init__(self, seq, timestamp_us, rows, cols, value_bits, quantized, packed, values,
+                 delta=False, base_seq=None, deltas=None, end_us=None):
+        self.seq = seq
+        self.timestamp_us = timestamp_us  # 扫描开始（设备微秒，32位回绕）
+        self.end_us = end_us  # 最后一点读取完成（设备微秒）
+        self.rows = rows
+        self.cols = cols
+        self.value_bits = value_bits
+        self.quantized = quantized
+        self.packed = packed
+        self.values = values  # values[row][col]（差分帧重建后填入）
+        self.delta = delta  # 是否为差分帧
+        self.base_seq = base_seq  # 差分帧的参考帧序号
+        self.deltas = deltas  # 差分帧按行优先的差值
+        self.host_time = None  # 接收线程解出该帧时的主机时间（time.perf_counter，秒）
+
+
+def cobs_decode(data):
+    """COBS解码，格式错误时抛出ValueError"""
+    out = bytearray()
+    i = 0
+    n = len(data)
+    while i < n:
+        code = data[i]
+        if code == 0:
+            raise ValueError("zero byte in COBS data")
+        end = i + code
+        if end > n:
+            raise ValueError("COBS block overruns frame")
+        out += data[i + 1:end]
+        i = end
+        if code < 0xFF and i < n:
+            out.append(0)
+    return bytes(out)
+
+
+def unpack_bits(data, count, bits):
+    """
+    位打包解包：第 i 个值占小端位流的 [bits*i, bits*i+bits) 位
+    10位时每4个值5字节：v0 | v1<<10 | v2<<20 | v3<<30
+    """
+    stream = int.from_bytes(data, 'little')
+    mask = (1 << bits) - 1
+    return [(stream >> (bits * i)) & mask for i in range(count)]
+
+
+def read_varint(data, pos):
+    """LEB128无符号变长整数，返回 (值, 下一位置)"""
+    value = 0
+    shift = 0
+    while True:
+        if pos >= len(data) or shift > 28:
+            raise ValueError("truncated varint")
+        b = data[pos]
+        pos += 1
+        value |= (b & 0x7F) << shift
+        if b < 0x80:
+            return value, pos
+        shift += 7
+
+
+def decode_deltas(data, count):
+    """
+    差分记号解码：非0记号为 zigzag(d)，0x00 后跟 varint(k) 表示连续k个0差分
+    返回 (base_seq, 差值列表)
+    """
+    if len(data) < 4:
+        raise ValueError("missing base_seq")
+    (base_seq,) = struct.unpack_from('<I', data, 0)
+    deltas = []
+    pos = 4
+    while pos < len(data):
+        token, pos = read_varint(data, pos)
+        if token == 0:
+            run, pos = read_varint(data, pos)
+            deltas.extend([0] * run)
+        else:
+            deltas.append((token >> 1) ^ -(token & 1))
+    if len(deltas) != count:
+        raise ValueError("delta count mismatch")
+    return base_seq, deltas
+
+
+def parse_frame(encoded):
+    """解码一个COBS帧（不含分隔符），校验失败返回None"""
+    try:
+        raw = cobs_decode(encoded)
+    except ValueError:
+        return None
+    if len(raw) < FRAME_HEADER.size + FRAME_CRC_SIZE:
+        return None
+
+    magic, version, flags, seq, timestamp_us, rows, cols, bits, _, payload_len, end_us = FRAME_HEADER.unpack_from(raw)
+    if magic != FRAME_MAGIC or version != FRAME_VERSION:
+        return None
+    packed = bool(flags & FRAME_FLAG_PACKED)
+    delta = bool(flags & FRAME_FLAG_DELTA)
+    if bits == 0 or bits > 32 or (not packed and bits not in _VALUE_FORMATS):
+        return None
+    if not delta and payload_len != (rows * cols * bits + 7) // 8:
+        return None
+    if len(raw) != FRAME_HEADER.size + payload_len + FRAME_CRC_SIZE:
+        return None
+
+    body_len = FRAME_HEADER.size + payload_len
+    (crc,) = struct.unpack_from('<I', raw, body_len)
+    if zlib.crc32(raw[:body_len]) & 0xFFFFFFFF != crc:
+        return None
+
+    if delta:
+        try:
+            base_seq, deltas = decode_deltas(raw[FRAME_HEADER.size:body_len], rows * cols)
+        except ValueError:
+            return None
+        return MatrixFrame(seq, timestamp_us, rows, cols, bits, bool(flags & FRAME_FLAG_QUANT), packed, None,
+                           delta=True, base_seq=base_seq, deltas=deltas, end_us=end_us)
+
+    if packed:
+        flat = unpack_bits(raw[FRAME_HEADER.size:body_len], rows * cols, bits)
+    else:
+        flat = struct.unpack_from('<%d%s' % (rows * cols, _VALUE_FORMATS[bits]), raw, FRAME_HEADER.size)
+    values = [list(flat[r * cols:(r + 1) * cols]) for r in range(rows)]
+    return MatrixFrame(seq, timestamp_us, rows, cols, bits, bool(flags & FRAME_FLAG_QUANT), packed, values,
+                       end_us=end_us)
+
+
+class FrameDecoder:
+    """
+    字节流拆分：文本行和二进制帧混在同一串口中
+    - 文本状态：'\\n' 结束一行，遇到0x00进入帧状态
+    - 帧状态：遇到0x00时解码累积的数据，成功则回到文本状态；
+      失败（中途接入或帧内混入文本导致CRC错误）时把其中的文本行交出，
+      并把这个0x00当作下一帧的起始分隔符
+    - 差分帧：参考帧（上一个交出的帧）序号等于 base_seq 时重建为完整帧，
+      否则丢弃并置 resync_needed，调用方可发送 KEYFRAME 请求关键帧
+    """
+
+    def __init__(self):
+        self.text_buffer = bytearray()
+        self.frame_buffer = bytearray()
+        self.in_frame = False
+        self.frames_ok = 0
+        self.frames_bad = 0
+        self.frames_unsynced = 0
+        self.resync_needed = False
+        self.reference = None  # 上一个完整帧（MatrixFrame）
+
+    def feed(self, data):
+        """输入新收到的字节，返回 (文本行列表, 帧列表)"""
+        lines = []
+        frames = []
+        pos = 0
+        n = len(data)
+
+        while pos < n:
+            zero = data.find(b'\x00', pos)
+            end = zero if zero >= 0 else n
+
+            if not self.in_frame:
+                self.text_buffer += data[pos:end]
+                self._split_lines(lines)
+            else:
+                self.frame_buffer += data[pos:end]
+                if len(self.frame_buffer) > FRAME_MAX_ENCODED:
+                    self.frame_buffer = bytearray()
+                    self.frames_bad += 1
+
+            if zero < 0:
+                break
+            pos = zero + 1
+
+            if not self.in_frame:
+                # 文本响应都以换行结束，分隔符前不完整的一行是中途接入时的残帧
+                self.text_buffer = bytearray()
+                self.in_frame = True
+                continue
+            if not self.frame_buffer:
+                continue  # 连续的分隔符
+
+            frame = parse_frame(self.frame_buffer)
+            if frame is not None:
+                self.frames_ok += 1
+                self.in_frame = False
+                frame = self._reconstruct(frame)
+                if frame is not None:
+                    frames.append(frame)
+            else:
+                self.frames_bad += 1
+                self.text_buffer += self.frame_buffer
+                self._split_lines(lines)
+                self.text_buffer = bytearray()
+            self.frame_buffer = bytearray()
+
+        return lines, frames
+
+    def _reconstruct(self, frame):
+        """差分帧叠加到参考帧上；完整帧直接成为新的参考帧"""
+        if frame.delta:
+            ref = self.reference
+            if (ref is None or ref.seq != frame.base_seq or ref.rows != frame.rows
+                    or ref.cols != frame.cols or ref.value_bits != frame.value_bits):
+                self.frames_unsynced += 1
+                self.resync_needed = True
+                return None
+            mask = (1 << frame.value_bits) - 1
+            cols = frame.cols
+            frame.values = [[(ref.values[r][c] + frame.deltas[r * cols + c]) & mask for c in range(cols)]
+                            for r in range(frame.rows)]
+        self.reference = frame
+        self.resync_needed = False
+        return frame
+
+    def _split_lines(self, lines):
+        while True:
+            idx = self.text_buffer.find(b'\n')
+            if idx < 0:
+                return
+            line = self.text_buffer[:idx].decode('utf-8', errors='ignore').strip()
+            del self.text_buffer[:idx + 1]
+            if line:
+                lines.append(line)
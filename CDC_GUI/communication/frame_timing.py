@@ -0,0 +1,177 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+帧序号/时间戳统计
+设备每帧带序号和两个微秒时间戳（扫描开始、最后一点读取完成，32位回绕）：
+  文本格式：START:<seq>,<start_us> ... END:<seq>,<end_us>
+  二进制帧：帧头 seq / timestamp_us / end_us
+据此统计丢帧（序号跳变）、实际帧间隔与抖动、单帧扫描耗时，
+以及端到端延迟的波动（主机收到时间 - 设备扫描结束时间，相对窗口内最小值；
+两端时钟不同源，绝对延迟无法直接测得）
+丢帧或帧内缺行时由 ResendRequester 发出 GET_FRAME:<seq>，从设备历史帧中补回
+"""
+
+import math
+from collections import deque
+
+_US_WRAP = 1 << 32
+_SEQ_WRAP = 1 << 32
+LATE_WINDOW = 64  # 比最新序号旧且相差不超过此值的帧视为重发帧，更大的倒退视为设备复位
+
+
+def parse_marker(line):
+    """解析 'START:<seq>,<us>' / 'END:<seq>,<us>'，返回 (标记, seq, us)；不带参数或格式不符返回 None"""
+    tag, sep, rest = line.partition(':')
+    if not sep or tag not in ('START', 'END'):
+        return None
+    seq, sep, us = rest.partition(',')
+    if not sep:
+        return None
+    try:
+        return tag, int(seq), int(us)
+    except ValueError:
+        return None
+
+
+class FrameTiming:
+    """按帧累计时序统计，window 为计算间隔/抖动/延迟所用的最近帧数"""
+
+    def __init__(self, window=100):
+        self.window = window
+        self.reset()
+
+    def reset(self):
+        self.frames = 0
+        self.lost = 0
+        self.reordered = 0
+        self.late = 0  # 重发补回的旧帧（不参与间隔统计）
+        self.last_seq = None
+        self.last_start_us = None
+        self.last_scan_us = None
+        self.intervals = deque(maxlen=self.window)  # 相邻帧扫描开始时间差（us）
+        self.offsets = deque(maxlen=self.window)  # 主机接收时间 - 设备结束时间（us，含任意常数偏移）
+
+    def is_late(self, seq):
+        """seq 比已收到的最新帧旧（GET_FRAME 补回的帧）"""
+        return self.last_seq is not None and 0 < (self.last_seq - seq) % _SEQ_WRAP <= LATE_WINDOW
+
+    def add(self, seq, start_us, end_us, host_time=None):
+        """记录一帧；host_time 为主机收到该帧的 time.perf_counter()（秒），可为 None"""
+        if self.last_seq is not None:
+            gap = (seq - self.last_seq) % _SEQ_WRAP
+            if self.is_late(seq):
+                # GET_FRAME 补回的旧帧：丢帧数在发现序号跳变时已计入
+                self.late += 1
+                return
+            if gap == 0 or gap >= _SEQ_WRAP // 2:
+                # 重复或大幅倒退（设备复位/会话重开）：重新开始计算间隔
+                self.reordered += 1
+                self.last_start_us = None
+            else:
+                self.lost += gap - 1
+        if self.last_start_us is not None and start_us is not None:
+            self.intervals.append((start_us - self.last_start_us) % _US_WRAP)
+        self.last_seq = seq
+        self.last_start_us = start_us
+        self.frames += 1
+
+        if start_us is not None and end_us is not None:
+            self.last_scan_us = (end_us - start_us) % _US_WRAP
+        if host_time is not None and end_us is not None:
+            self._add_offset(host_time * 1e6 - end_us)
+
+    def _add_offset(self, offset):
+        # 设备时间32位回绕（约71分钟）时偏移整体跳变 2^32，平移回与上一个偏移相近的位置
+        if self.offsets:
+            prev = self.offsets[-1]
+            offset += round((prev - offset) / _US_WRAP) * _US_WRAP
+        self.offsets.append(offset)
+
+    def interval_stats(self):
+        """返回 (平均间隔us, 抖动标准差us, 最小us, 最大us)，样本不足返回 None"""
+        if len(self.intervals) < 2:
+            return None
+        n = len(self.intervals)
+        mean = sum(self.intervals) / n
+        std = math.sqrt(sum((v - mean) ** 2 for v in self.intervals) / n)
+        return mean, std, min(self.intervals), max(self.intervals)
+
+    def latency_spread_us(self):
+        """最近一帧的端到端延迟比窗口内最小延迟多出的微秒数，样本不足返回 None"""
+        if len(self.offsets) < 2:
+            return None
+        return self.offsets[-1] - min(self.offsets)
+
+    def summary(self):
+        """单行文字摘要（界面/控制台显示）"""
+        text = "帧 %d (seq %s) 丢帧 %d" % (self.frames, self.last_seq if self.last_seq is not None else '-', self.lost)
+        if self.late:
+            text += " 补回 %d" % self.late
+        stats = self.interval_stats()
+        if stats:
+            mean, std, lo, hi = stats
+            text += " | 间隔 %.2f ms 抖动 %.0f us [%.2f-%.2f ms]" % (mean / 1000.0, std, lo / 1000.0, hi / 1000.0)
+        if self.last_scan_us is not None:
+            text += " | 扫描 %.2f ms" % (self.last_scan_us / 1000.0)
+        spread = self.latency_spread_us()
+        if spread is not None:
+            text += " | 延迟波动 +%.1f ms" % (spread / 1000.0)
+        return text
+
+
+class ResendRequester:
+    """
+    丢帧补发：序号跳变时请求中间缺失的帧，帧内缺行时请求该帧本身
+    设备只保留最近几帧（FRAME_STREAM_HISTORY，加上空闲的流水线缓冲区），
+    更早的缺帧已被回收，不再请求；每个序号只请求一次，超时未收到计为未补回
+    """
+
+    def __init__(self, history=5, timeout=1.0):
+        self.history = history
+        self.timeout = timeout
+        self.reset()
+
+    def reset(self):
+        self.newest = None
+        self.pending = {}  # seq -> 请求时间
+        self.requested = 0
+        self.recovered = 0
+        self.expired = 0
+
+    def on_frame(self, seq, complete, now):
+        """收到一帧（complete=False 表示缺行），返回需要发送 GET_FRAME 的序号列表"""
+        self._expire(now)
+        wanted = []
+        if seq in self.pending and complete:
+            del self.pending[seq]
+            self.recovered += 1
+        if self.newest is None or (seq - self.newest) % _SEQ_WRAP >= _SEQ_WRAP // 2:
+            # 第一帧或旧帧（重发/迟到）
+            if self.newest is None:
+                self.newest = seq
+        else:
+            gap = (seq - self.newest) % _SEQ_WRAP
+            first_missing = max(1, gap - self.history)
+            wanted.extend((self.newest + k) % _SEQ_WRAP for k in range(first_missing, gap))
+            self.newest = seq
+        if not complete:
+            wanted.append(seq)
+        wanted = [s for s in wanted if s not in self.pending]
+        for s in wanted:
+            self.pending[s] = now
+        self.requested += len(wanted)
+        return wanted
+
+    def on_unavailable(self, seq):
+        """设备回复该帧已不在历史中"""
+        if self.pending.pop(seq, None) is not None:
+            self.expired += 1
+
+    def _expire(self, now):
+        for s, t in list(self.pending.items()):
+            if now - t > self.timeout:
+                del self.pending[s]
+                self.expired += 1
+
+    def summary(self):
+        return "重发请求 %d 补回 %d 失败 %d" % (self.requested, self.recovered, self.expired)
@@ -0,0 +1,689 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+PCap04 寄存器/字段/选项表
+本文件由 tools/gen_pcap04_reg_index.py 根据固件 pcap04_register_def.c 生成，请勿手工修改
+字段编号与固件 pcap04_reg_index.h 中的 PCAP04_FIELD_* 一致；
+Option.value 与固件相同，是移位到字段位置后的值
+"""
+
+from collections import namedtuple
+
+Register = namedtuple('Register', 'addr name desc default fields')
+Field = namedtuple('Field', 'id name reg bit_start bit_end desc options')
+Option = namedtuple('Option', 'value name desc')
+
+REGISTERS = (
+    Register(0x00, 'IIC_LF_CONFIG', 'IIC', 0x1D, (0, 1, 2)),
+    Register(0x01, 'OX_CONFIG', 'OX', 0x00, (3, 4, 5)),
+    Register(0x02, 'DISCHARGE_RES', '', 0x58, (6, 7, 8, 9)),
+    Register(0x03, 'CHARGE_CONFIG', '', 0x10, (10, 11, 12, 13, 14)),
+    Register(0x04, 'CAP_CONNECT', '', 0x10, (15, 16, 17, 18, 19)),
+    Register(0x05, 'CDC_CLOCK', 'CDC', 0x00, (20, 21, 22, 23, 24, 25)),
+    Register(0x06, 'PORT_ENABLE', '', 0x3F, (26, 27, 28, 29, 30, 31)),
+    Register(0x07, 'C_AVRG_L', '', 0x20, (32,)),
+    Register(0x08, 'C_AVRG_H', '', 0x00, (33,)),
+    Register(0x09, 'CONV_TIME_L', '', 0xD0, (34,)),
+    Register(0x0A, 'CONV_TIME_M', '', 0x07, (35,)),
+    Register(0x0B, 'CONV_TIME_H', '', 0x00, (36,)),
+    Register(0x0C, 'DISCHARGE_L', '', 0x00, (37,)),
+    Register(0x0D, 'TRIG_CONFIG', '', 0x08, (38, 39, 40)),
+    Register(0x0E, 'PRECHARGE_L', '', 0xFF, (41,)),
+    Register(0x0F, 'PRECHARGE_CFG', '', 0x03, (42, 43)),
+    Register(0x10, 'FULLCHARGE_L', '', 0x00, (44,)),
+    Register(0x11, 'CREF_CONFIG', '', 0x24, (45, 46)),
+    Register(0x12, 'GUARD_ENABLE', '', 0x00, (47, 48, 49, 50, 51, 52, 53, 54)),
+    Register(0x13, 'GUARD_OP', '', 0x00, (55, 56, 57)),
+    Register(0x14, 'RDC_TIME', 'RDC', 0x00, (58, 59)),
+    Register(0x15, 'R_PREDIV_L', 'RDC', 0x01, (60,)),
+    Register(0x16, 'RDC_TRIG', 'RDC', 0x50, (61, 62, 63)),
+    Register(0x17, 'RDC_PORT', 'RDC', 0x30, (64, 65, 66, 67, 68, 69)),
+    Register(0x18, 'TDC_CONFIG0', 'TDC0()', 0x73, (70, 71, 72, 73)),
+    Register(0x19, 'TDC_CONFIG1', 'TDC1()', 0x04, (74,)),
+    Register(0x1A, 'TDC_CONFIG2', 'TDC2()', 0x50, (75, 76)),
+    Register(0x1B, 'DSP_CONFIG', 'DSP', 0x08, (77, 78, 79, 80)),
+    Register(0x1C, 'WATCHDOG', '', 0x5A, (81,)),
+    Register(0x1D, 'DSP_TRIGGER', 'DSP', 0x00, (82, 83)),
+    Register(0x1E, 'INT_CONFIG', '', 0x82, (84, 85, 86, 87, 88)),
+    Register(0x1F, 'PULSE_IF0', '0', 0x08, (89, 90, 91, 92, 93)),
+    Register(0x20, 'PULSE_IF1', '1', 0x08, (94, 95, 96)),
+    Register(0x21, 'GPIO_CONFIG', 'GPIO', 0x00, (97, 98, 99, 100, 101, 102, 103, 104)),
+    Register(0x22, 'BANDGAP', '', 0x47, (105, 106, 107, 108)),
+    Register(0x23, 'GAIN_CORR', '', 0x40, (109,)),
+    Register(0x24, 'RESERVED36', '36', 0x00, ()),
+    Register(0x25, 'RESERVED37', '37', 0x00, ()),
+    Register(0x26, 'BG_TIME', '', 0x00, (110,)),
+    Register(0x27, 'PULSE_SEL', '', 0x71, (111, 112)),
+    Register(0x28, 'C_SENSE_SEL', '', 0x00, (113,)),
+    Register(0x29, 'R_SENSE_SEL', '', 0x00, (114,)),
+    Register(0x2A, 'FW_CONFIG', '', 0x08, (115, 116, 117, 118, 119)),
+    Register(0x2B, 'RESERVED43', '43', 0x00, ()),
+    Register(0x2C, 'RESERVED44', '44', 0x00, ()),
+    Register(0x2D, 'RESERVED45', '45', 0x00, ()),
+    Register(0x2E, 'RESERVED46', '46', 0x00, ()),
+    Register(0x2F, 'RUNBIT', '', 0x01, (120,)),
+    Register(0x30, 'MEM_LOCK', '', 0x00, (121, 122, 123, 124)),
+    Register(0x31, 'SERIAL_L', '', 0x00, (125,)),
+    Register(0x32, 'SERIAL_H', '', 0x00, (126,)),
+    Register(0x33, 'RESERVED51', '51', 0x00, ()),
+    Register(0x34, 'RESERVED52', '52', 0x00, ()),
+    Register(0x35, 'RESERVED53', '53', 0x00, ()),
+    Register(0x36, 'MEM_CTRL', '', 0x00, (127,)),
+    Register(0x37, 'RESERVED55', '55', 0x00, ()),
+    Register(0x38, 'RESERVED56', '56', 0x00, ()),
+    Register(0x39, 'RESERVED57', '57', 0x00, ()),
+    Register(0x3A, 'RESERVED58', '58', 0x00, ()),
+    Register(0x3B, 'RESERVED59', '59', 0x00, ()),
+    Register(0x3C, 'RESERVED60', '60', 0x00, ()),
+    Register(0x3D, 'RESERVED61', '61', 0x00, ()),
+    Register(0x3E, 'CHARGE_PUMP_L', '()', 0x00, (128,)),
+    Register(0x3F, 'CHARGE_PUMP_H', '()', 0x00, (129,)),
+)
+
+FIELDS = (
+    Field(0, 'I2C_A', 0x00, 6, 7, 'I2C address complement config', (
+        Option(0x00, 'ADDR_0', 'I2C address complement 0'),
+        Option(0x01, 'ADDR_1', 'I2C address complement 1'),
+        Option(0x02, 'ADDR_2', 'I2C address complement 2'),
+        Option(0x03, 'ADDR_3', 'I2C address complement 3'),
+    )),
+    Field(1, 'OLF_FTUNE', 0x00, 2, 5, 'Low freq clock fine tune (0-15)', (
+        Option(0x00, 'MIN', 'Min value 0'),
+        Option(0x07, 'TYP', 'Typical value 7'),
+        Option(0x0F, 'MAX', 'Max value 15'),
+    )),
+    Field(2, 'OLF_CTUNE', 0x00, 0, 1, 'Low freq clock coarse tune', (
+        Option(0x00, '10KHZ', '10 kHz frequency'),
+        Option(0x01, '50KHZ', '50 kHz frequency'),
+        Option(0x02, '100KHZ', '100 kHz frequency'),
+        Option(0x03, '200KHZ', '200 kHz frequency'),
+    )),
+    Field(3, 'OX_DIS', 0x01, 7, 7, 'Disable OX clock', (
+        Option(0x00, 'ENABLE', 'OX clock enable'),
+        Option(0x01, 'DISABLE', 'OX clock disable'),
+    )),
+    Field(4, 'OX_DIV4', 0x01, 5, 5, 'OX clock divide by 4', (
+        Option(0x00, '2MHZ', 'No divide, f_ox=2MHz'),
+        Option(0x01, '0.5MHZ', 'Divide by 4, f_ox=0.5MHz'),
+    )),
+    Field(5, 'OX_RUN', 0x01, 0, 2, 'OX generator continuity or delay', (
+        Option(0x00, 'OFF', 'Generator off'),
+        Option(0x01, 'PERMANENT', 'OX permanent run'),
+        Option(0x02, 'DELAY31', 'OX delay=31/fOLF'),
+        Option(0x03, 'DELAY2', 'OX delay=2/fOLF'),
+        Option(0x06, 'DELAY1', 'OX delay=1/fOLF'),
+    )),
+    Field(6, 'RDCHG_INT_SEL1', 0x02, 6, 7, 'PC4~PC5', (
+        Option(0x00, '180K', '180 k'),
+        Option(0x01, '90K', '90 k'),
+        Option(0x02, '30K', '30 k'),
+        Option(0x03, '10K', '10 k'),
+    )),
+    Field(7, 'RDCHG_INT_SEL0', 0x02, 4, 5, 'PC0~PC3PC6', (
+        Option(0x00, '180K', '180 k'),
+        Option(0x01, '90K', '90 k'),
+        Option(0x02, '30K', '30 k'),
+        Option(0x03, '10K', '10 k'),
+    )),
+    Field(8, 'RDCHG_INT_EN', 0x02, 3, 3, '', (
+        Option(0x00, 'DISABLE', 'Disable'),
+        Option(0x01, 'ENABLE', 'Enable'),
+    )),
+    Field(9, 'RDCHG_EXT_EN', 0x02, 1, 1, '', (
+        Option(0x00, 'DISABLE', 'Disable'),
+        Option(0x01, 'ENABLE', 'Enable'),
+    )),
+    Field(10, 'AUX_PD_DIS', 0x03, 6, 6, 'PCAUX', (
+        Option(0x00, 'DISABLE', 'Disable'),
+        Option(0x01, 'ENABLE', 'Enable'),
+    )),
+    Field(11, 'AUX_CINT', 0x03, 5, 5, 'PCAUX', (
+        Option(0x00, 'DISABLE', 'Disable'),
+        Option(0x01, 'ENABLE', 'Enable'),
+    )),
+    Field(12, 'RDCHG_PERM_EN', 0x03, 2, 2, '', (
+        Option(0x00, 'DISABLE', 'Disable'),
+        Option(0x01, 'ENABLE', 'Enable'),
+    )),
+    Field(13, 'RDCHG_EXT_PERM', 0x03, 1, 1, 'PCAUX', (
+        Option(0x00, 'DISABLE', 'Disable'),
+        Option(0x01, 'ENABLE', 'Enable'),
+    )),
+    Field(14, 'RCHG_SEL', 0x03, 0, 0, '', (
+        Option(0x00, '180K', '180 k'),
+        Option(0x01, '10K', '10 k()'),
+    )),
+    Field(15, 'C_REF_INT', 0x04, 7, 7, 'Use on-chip reference cap', (
+        Option(0x00, 'EXTERNAL', 'External reference'),
+        Option(0x01, 'INTERNAL', 'Internal reference'),
+    )),
+    Field(16, 'C_COMP_EXT', 0x04, 5, 5, 'External parasitic cap compensation', (
+        Option(0x00, 'DISABLE', 'Disable'),
+        Option(0x01, 'ENABLE', 'Enable'),
+    )),
+    Field(17, 'C_COMP_INT', 0x04, 4, 4, 'On-chip parasitic cap compensation', (
+        Option(0x00, 'DISABLE', 'Disable'),
+        Option(0x01, 'ENABLE', 'Enable'),
+    )),
+    Field(18, 'C_DIFFERENTIAL', 0x04, 1, 1, 'Single or diff sensor', (
+        Option(0x00, 'SINGLE', 'Single-ended sensor'),
+        Option(0x01, 'DIFF', 'Differential sensor'),
+    )),
+    Field(19, 'C_FLOATING', 0x04, 0, 0, 'Grounded or floating sensor', (
+        Option(0x00, 'GROUNDED', 'Grounded sensor'),
+        Option(0x01, 'FLOATING', 'Floating sensor'),
+    )),
+    Field(20, 'CY_PRE_MR1_SHORT', 0x05, 7, 7, 'Reduce internal clock path delay', (
+        Option(0x00, 'DISABLE', 'Disable'),
+        Option(0x01, 'ENABLE', 'Enable'),
+    )),
+    Field(21, 'C_PORT_PAT', 0x05, 5, 5, 'Port measurement order alternate', (
+        Option(0x00, 'DISABLE', 'Disable'),
+        Option(0x01, 'ENABLE', 'Enable'),
+    )),
+    Field(22, 'CY_HFCLK_SEL', 0x05, 3, 3, 'CDC clock source select', (
+        Option(0x00, 'OLF', 'Low freq clock OLF'),
+        Option(0x01, 'OHF', 'High freq clock OHF'),
+    )),
+    Field(23, 'CY_DIV4_DIS', 0x05, 2, 2, 'Four times clock period', (
+        Option(0x00, 'DISABLE', 'Disable'),
+        Option(0x01, 'ENABLE', 'Enable'),
+    )),
+    Field(24, 'CY_PRE_LONG', 0x05, 1, 1, 'Add safety delay', (
+        Option(0x00, 'DISABLE', 'Disable'),
+        Option(0x01, 'ENABLE', 'Enable'),
+    )),
+    Field(25, 'C_DC_BALANCE', 0x05, 0, 0, 'Diff floating DC free', (
+        Option(0x00, 'DISABLE', 'Disable'),
+        Option(0x01, 'ENABLE', 'Enable'),
+    )),
+    Field(26, 'PC5_EN', 0x06, 5, 5, 'PC5 port enable', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(27, 'PC4_EN', 0x06, 4, 4, 'PC4 port enable', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(28, 'PC3_EN', 0x06, 3, 3, 'PC3 port enable', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(29, 'PC2_EN', 0x06, 2, 2, 'PC2 port enable', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(30, 'PC1_EN', 0x06, 1, 1, 'PC1 port enable', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(31, 'PC0_EN', 0x06, 0, 0, 'PC0 port enable', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(32, 'C_AVRG_L', 0x07, 0, 7, 'Average count low 8 bits (0-8191)', (
+        Option(0x00, '1', '1 sample'),
+        Option(0x20, '32', '32 samples (default)'),
+        Option(0x00, '256', '256 samples'),
+    )),
+    Field(33, 'C_AVRG_H', 0x08, 0, 4, '5(0-8191)', (
+        Option(0x00, '1', '1 sample'),
+    )),
+    Field(34, 'CONV_TIME_L', 0x09, 0, 7, '8', (
+        Option(0x00, '0', ''),
+        Option(0xD0, '2000', '2000(20ms@200kHz,)'),
+    )),
+    Field(35, 'CONV_TIME_M', 0x0A, 0, 7, '8', (
+        Option(0x00, '0', ''),
+    )),
+    Field(36, 'CONV_TIME_H', 0x0B, 0, 6, '7', (
+        Option(0x00, '0', ''),
+    )),
+    Field(37, 'DISCHARGE_TIME_L', 0x0C, 0, 7, '8(0-1023)', (
+        Option(0x00, '0', ''),
+    )),
+    Field(38, 'C_STARTONPIN', 0x0D, 6, 7, 'CDCGPIO', (
+        Option(0x00, 'PG0', 'GPIO0'),
+        Option(0x01, 'PG1', 'GPIO1'),
+        Option(0x02, 'PG2', 'GPIO2'),
+        Option(0x03, 'PG3', 'GPIO3'),
+    )),
+    Field(39, 'C_TRIG_SEL', 0x0D, 2, 4, 'CDC', (
+        Option(0x00, '', ''),
+        Option(0x01, '', ''),
+        Option(0x02, '', '()'),
+        Option(0x03, '', ''),
+        Option(0x05, '', ''),
+        Option(0x06, '', ''),
+    )),
+    Field(40, 'DISCHARGE_TIME_H', 0x0D, 0, 1, '2', (
+        Option(0x00, '0', ''),
+    )),
+    Field(41, 'PRECHARGE_TIME_L', 0x0E, 0, 7, '8(0-1023)', (
+        Option(0x00, '0', ''),
+    )),
+    Field(42, 'C_FAKE', 0x0F, 2, 5, '(0-15)', (
+        Option(0x00, '0', ''),
+        Option(0x01, '1', '1'),
+        Option(0x0F, '15', '15'),
+    )),
+    Field(43, 'PRECHARGE_TIME_H', 0x0F, 0, 1, '2', (
+        Option(0x00, '0', ''),
+    )),
+    Field(44, 'FULLCHARGE_TIME_L', 0x10, 0, 7, '8', (
+        Option(0x00, '0', ''),
+    )),
+    Field(45, 'C_REF_SEL', 0x11, 2, 6, '(0-31pF)', (
+        Option(0x00, '0pF', ''),
+        Option(0x04, '4pF', '4-5pF()'),
+        Option(0x1F, '31pF', '31pF'),
+    )),
+    Field(46, 'FULLCHARGE_TIME_H', 0x11, 0, 1, '2', (
+        Option(0x00, '0', ''),
+    )),
+    Field(47, 'C_G_OP_RUN', 0x12, 7, 7, '', (
+        Option(0x00, '', ''),
+        Option(0x01, '', '()'),
+    )),
+    Field(48, 'C_G_OP_EXT', 0x12, 6, 6, '', (
+        Option(0x00, '', ''),
+        Option(0x01, '', ''),
+    )),
+    Field(49, 'PC5_G_EN', 0x12, 5, 5, 'PC5', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(50, 'PC4_G_EN', 0x12, 4, 4, 'PC4', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(51, 'PC3_G_EN', 0x12, 3, 3, 'PC3', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(52, 'PC2_G_EN', 0x12, 2, 2, 'PC2', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(53, 'PC1_G_EN', 0x12, 1, 1, 'PC1', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(54, 'PC0_G_EN', 0x12, 0, 0, 'PC0', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(55, 'C_G_OP_VU', 0x13, 6, 7, '', (
+        Option(0x00, '1.00', '1.00'),
+        Option(0x01, '1.01', '1.01'),
+        Option(0x02, '1.02', '1.02'),
+        Option(0x03, '1.03', '1.03'),
+    )),
+    Field(56, 'C_G_OP_ATTN', 0x13, 4, 5, '', (
+        Option(0x00, '0.5aF', '0.5aF'),
+        Option(0x01, '1.0aF', '1.0aF'),
+        Option(0x02, '1.5aF', '1.5aF'),
+        Option(0x03, '2.0aF', '2.0aF'),
+    )),
+    Field(57, 'C_G_TIME', 0x13, 0, 3, '(500ns)', (
+        Option(0x00, '0', ''),
+    )),
+    Field(58, 'R_CY', 0x14, 7, 7, 'RDC', (
+        Option(0x00, '', ''),
+        Option(0x01, '', ''),
+    )),
+    Field(59, 'C_G_OP_TR', 0x14, 0, 2, 'OP', (
+        Option(0x00, '0', ''),
+    )),
+    Field(60, 'R_TRIG_PREDIV_L', 0x15, 0, 7, 'RDC8', (
+        Option(0x00, '0', ''),
+    )),
+    Field(61, 'R_TRIG_SEL', 0x16, 4, 6, 'RDC', (
+        Option(0x00, '', 'RDC'),
+        Option(0x01, '', ''),
+        Option(0x03, '', ''),
+        Option(0x05, 'CDC', 'CDC()'),
+        Option(0x06, 'CDC', 'CDC'),
+    )),
+    Field(62, 'R_AVRG', 0x16, 2, 3, 'RDC', (
+        Option(0x00, '', ''),
+        Option(0x01, '4', '4'),
+        Option(0x02, '8', '8'),
+        Option(0x03, '16', '16'),
+    )),
+    Field(63, 'R_TRIG_PREDIV_H', 0x16, 0, 1, 'RDC2', (
+        Option(0x00, '0', ''),
+    )),
+    Field(64, 'PT1_EN', 0x17, 7, 7, 'PT1', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(65, 'PTOREF_EN', 0x17, 6, 6, 'PTOREF', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(66, 'R_PORT_EN_IMES', 0x17, 5, 5, '', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(67, 'R_PORT_EN_IREF', 0x17, 4, 4, '', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(68, 'R_FAKE', 0x17, 2, 2, 'RDC', (
+        Option(0x00, '2', '2'),
+        Option(0x01, '8', '8'),
+    )),
+    Field(69, 'R_STARTONPIN', 0x17, 0, 1, 'RDCGPIO', (
+        Option(0x00, 'PG0', 'GPIO0'),
+        Option(0x01, 'PG1', 'GPIO1'),
+        Option(0x02, 'PG2', 'GPIO2'),
+        Option(0x03, 'PG3', 'GPIO3'),
+    )),
+    Field(70, 'TDC_CHAN_EN', 0x18, 4, 5, 'TDC(3)', (
+        Option(0x00, '0', ''),
+    )),
+    Field(71, 'TDC_ALUPERMOPEN', 0x18, 3, 3, 'TDC(0)', (
+        Option(0x00, '0', ''),
+    )),
+    Field(72, 'TDC_NOISE_DIS', 0x18, 2, 2, 'TDC(0)', (
+        Option(0x00, '0', ''),
+    )),
+    Field(73, 'TDC_MUPU_SPEED', 0x18, 0, 1, 'TDC(3)', (
+        Option(0x00, '0', ''),
+    )),
+    Field(74, 'TDC_MUPU_NO', 0x19, 2, 7, 'TDC(1)', (
+        Option(0x00, '0', ''),
+    )),
+    Field(75, 'TDC_QHA_SEL', 0x1A, 2, 7, 'TDC QHA(20)', (
+        Option(0x00, '0', ''),
+    )),
+    Field(76, 'TDC_NOISE_CY_DIS', 0x1A, 1, 1, 'TDC(0)', (
+        Option(0x00, '0', ''),
+    )),
+    Field(77, 'DSP_MOFLO_EN', 0x1B, 6, 7, 'GPIO', (
+        Option(0x00, '', ''),
+        Option(0x03, '', ''),
+    )),
+    Field(78, 'DSP_SPEED', 0x1B, 2, 3, 'DSP', (
+        Option(0x00, '', 'DSP'),
+        Option(0x01, '', 'DSP'),
+        Option(0x02, '', 'DSP()'),
+        Option(0x03, '', 'DSP'),
+    )),
+    Field(79, 'PG1xPG3', 0x1B, 1, 1, 'PG1/PG3', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(80, 'PG0xPG2', 0x1B, 0, 0, 'PG0/PG2', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(81, 'WD_DIS', 0x1C, 0, 7, '(0x5A=)', (
+        Option(0x00, '', '()'),
+        Option(0x5A, '', ''),
+    )),
+    Field(82, 'DSP_STARTONPIN', 0x1D, 4, 7, 'DSP(PG0~3)', (
+        Option(0x00, '0', ''),
+    )),
+    Field(83, 'DSP_FF_IN', 0x1D, 0, 3, 'DSP', (
+        Option(0x00, '0', ''),
+    )),
+    Field(84, 'PG5_INTN_EN', 0x1E, 7, 7, 'INTNPG5', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(85, 'PG4_INTN_EN', 0x1E, 6, 6, 'INTNPG4', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(86, 'DSP_TRIG_TIMER', 0x1E, 2, 2, 'DSP', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(87, 'DSP_TRIG_RDC', 0x1E, 1, 1, 'RDCDSP()', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(88, 'DSP_TRIG_CDC', 0x1E, 0, 0, 'CDCDSP', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(89, 'PI1_TOGGLE_EN', 0x1F, 7, 7, 'PI1', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(90, 'PIO_TOGGLE_EN', 0x1F, 6, 6, 'PI0', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(91, 'PIO_RES', 0x1F, 4, 5, '0', (
+        Option(0x00, '10', '10'),
+        Option(0x01, '12', '12'),
+        Option(0x02, '14', '14'),
+        Option(0x03, '16', '16'),
+    )),
+    Field(92, 'PIO_PDM_SEL', 0x1F, 3, 3, 'PI0 PWM/PDM', (
+        Option(0x00, 'PWM', 'PWM'),
+        Option(0x01, 'PDM', 'PDM'),
+    )),
+    Field(93, 'PIO_CLK_SEL', 0x1F, 0, 2, '0', (
+        Option(0x00, '', ''),
+        Option(0x01, 'OLF/1', 'OLF'),
+        Option(0x02, 'OLF/2', 'OLF 2'),
+        Option(0x03, 'OLF/4', 'OLF 4'),
+        Option(0x04, 'OX/1', 'OX'),
+        Option(0x05, 'OX/2', 'OX 2'),
+        Option(0x06, 'OX/4', 'OX 4'),
+    )),
+    Field(94, 'PI1_RES', 0x20, 4, 5, '1', (
+        Option(0x00, '10', '10'),
+        Option(0x01, '12', '12'),
+        Option(0x02, '14', '14'),
+        Option(0x03, '16', '16'),
+    )),
+    Field(95, 'PI1_PDM_SEL', 0x20, 3, 3, 'PI1 PWM/PDM', (
+        Option(0x00, 'PWM', 'PWM'),
+        Option(0x01, 'PDM', 'PDM'),
+    )),
+    Field(96, 'PI1_CLK_SEL', 0x20, 0, 2, '1', (
+        Option(0x00, '', ''),
+        Option(0x01, 'OLF/1', 'OLF'),
+        Option(0x02, 'OLF/2', 'OLF 2'),
+        Option(0x03, 'OLF/4', 'OLF 4'),
+        Option(0x04, 'OX/1', 'OX'),
+        Option(0x05, 'OX/2', 'OX 2'),
+        Option(0x06, 'OX/4', 'OX 4'),
+    )),
+    Field(97, 'PG3_DIR', 0x21, 7, 7, 'PG3', (
+        Option(0x00, '', 'GPIO'),
+        Option(0x01, '', 'GPIO'),
+    )),
+    Field(98, 'PG2_DIR', 0x21, 6, 6, 'PG2', (
+        Option(0x00, '', 'GPIO'),
+        Option(0x01, '', 'GPIO'),
+    )),
+    Field(99, 'PG1_DIR', 0x21, 5, 5, 'PG1', (
+        Option(0x00, '', 'GPIO'),
+        Option(0x01, '', 'GPIO'),
+    )),
+    Field(100, 'PG0_DIR', 0x21, 4, 4, 'PG0', (
+        Option(0x00, '', 'GPIO'),
+        Option(0x01, '', 'GPIO'),
+    )),
+    Field(101, 'PG3_PU', 0x21, 3, 3, 'PG3', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(102, 'PG2_PU', 0x21, 2, 2, 'PG2', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(103, 'PG1_PU', 0x21, 1, 1, 'PG1', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(104, 'PG0_PU', 0x21, 0, 0, 'PG0', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(105, 'INT_TRIG_BG', 0x22, 7, 7, '', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(106, 'DSP_TRIG_BG', 0x22, 6, 6, 'DSP', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(107, 'BG_PERM', 0x22, 5, 5, '', (
+        Option(0x00, '', ''),
+        Option(0x01, '', '(+20A)'),
+    )),
+    Field(108, 'AUTOSTART', 0x22, 4, 4, 'CDC', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(109, 'CDC_GAIN_CORR', 0x23, 0, 7, '(1+n/256)', (
+        Option(0x00, '1.00', '1.00'),
+        Option(0x40, '1.25', '1.25()'),
+        Option(0x80, '1.50', '1.50'),
+        Option(0xFF, '1.996', '1.996()'),
+    )),
+    Field(110, 'BG_TIME', 0x26, 0, 7, '(0=)', (
+        Option(0x00, '0', ''),
+    )),
+    Field(111, 'PULSE_SEL1', 0x27, 4, 7, '1', (
+        Option(0x00, 'Res0', 'C0/Cref'),
+        Option(0x01, 'Res1', 'C1/Cref'),
+        Option(0x02, 'Res2', 'C2/Cref'),
+        Option(0x03, 'Res3', 'C3/Cref'),
+        Option(0x04, 'Res4', 'C4/Cref'),
+        Option(0x05, 'Res5', 'C5/Cref'),
+        Option(0x06, 'Res6', 'PT1/Ref'),
+        Option(0x07, 'Res7', 'Alu/Ref'),
+    )),
+    Field(112, 'PULSE_SEL0', 0x27, 0, 3, '0', (
+        Option(0x00, 'Res0', 'C0/Cref'),
+        Option(0x01, 'Res1', 'C1/Cref'),
+        Option(0x02, 'Res2', 'C2/Cref'),
+        Option(0x03, 'Res3', 'C3/Cref'),
+        Option(0x04, 'Res4', 'C4/Cref'),
+        Option(0x05, 'Res5', 'C5/Cref'),
+        Option(0x06, 'Res6', 'PT1/Ref'),
+        Option(0x07, 'Res7', 'Alu/Ref'),
+    )),
+    Field(113, 'C_SENSE_SEL', 0x28, 0, 7, '()', (
+        Option(0x00, '0', ''),
+    )),
+    Field(114, 'R_SENSE_SEL', 0x29, 0, 7, '()', (
+        Option(0x00, '0', ''),
+    )),
+    Field(115, 'ALARM1_SELECT', 0x2A, 6, 6, '1', (
+        Option(0x00, 'Z', 'Z'),
+        Option(0x01, 'Theta', 'Theta'),
+    )),
+    Field(116, 'ALARM0_SELECT', 0x2A, 4, 4, '0', (
+        Option(0x00, 'Z', 'Z'),
+        Option(0x01, 'Theta', 'Theta'),
+    )),
+    Field(117, 'EN_ASYNC_READ', 0x2A, 3, 3, '', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(118, 'R_MEDIAN_EN', 0x2A, 1, 1, 'R', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(119, 'C_MEDIAN_EN', 0x2A, 0, 0, 'C', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(120, 'RUNBIT', 0x2F, 0, 0, 'DSP', (
+        Option(0x00, '', ''),
+        Option(0x01, '', ''),
+    )),
+    Field(121, 'MEM_LOCK_960', 0x30, 3, 3, '960-10071022-1023', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(122, 'MEM_LOCK_832', 0x30, 2, 2, '832-959', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(123, 'MEM_LOCK_704', 0x30, 1, 1, '704-831', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(124, 'MEM_LOCK_0', 0x30, 0, 0, '0-703', (
+        Option(0x00, 'DISABLE', 'Port disable'),
+        Option(0x01, 'ENABLE', 'Port enable'),
+    )),
+    Field(125, 'SERIAL_NUMBER_L', 0x31, 0, 7, '', (
+        Option(0x00, '0', ''),
+    )),
+    Field(126, 'SERIAL_NUMBER_H', 0x32, 0, 7, '', (
+        Option(0x00, '0', ''),
+    )),
+    Field(127, 'MEM_CTRL', 0x36, 0, 7, '', (
+        Option(0x00, '', ''),
+        Option(0x2D, '', 'NVRAM'),
+        Option(0x59, '', 'NVRAM'),
+        Option(0xB8, '', 'NVRAM'),
+    )),
+    Field(128, 'CHARGE_PUMP_L', 0x3E, 0, 7, '()', (
+        Option(0x00, '0', ''),
+    )),
+    Field(129, 'CHARGE_PUMP_H', 0x3F, 0, 7, '()', (
+        Option(0x00, '0', ''),
+    )),
+)
+
+REGISTER_BY_ADDR = {r.addr: r for r in REGISTERS}
+FIELD_BY_NAME = {f.name: f for f in FIELDS}
+
+
+def field_mask(field):
+    """字段在寄存器字节中的掩码"""
+    return ((1 << (field.bit_end - field.bit_start + 1)) - 1) << field.bit_start
+
+
+def field_value(field, reg_value):
+    """从寄存器字节中取出字段值"""
+    return (reg_value & field_mask(field)) >> field.bit_start
+
+
+def set_field(field, reg_value, value):
+    """把字段值写入寄存器字节，返回新的字节"""
+    mask = field_mask(field)
+    return (reg_value & ~mask & 0xFF) | ((value << field.bit_start) & mask)
+
+
+def find_option(field, value):
+    """字段值对应的选项，没有时返回 None"""
+    encoded = (value << field.bit_start) & 0xFF
+    for option in field.options:
+        if option.value == encoded:
+            return option
+    return None
+
+
+def decode(addr, reg_value):
+    """解码寄存器字节，返回 [(字段, 字段值, 选项或None), ...]"""
+    reg = REGISTER_BY_ADDR.get(addr)
+    if reg is None:
+        return []
+    result = []
+    for fid in reg.fields:
+        field = FIELDS[fid]
+        value = field_value(field, reg_value)
+        result.append((field, value, find_option(field, value)))
+    return result
+
+
+def reg_commands():
+    """所有字段的 REG SET/GET 命令前缀，供命令输入框补全"""
+    commands = []
+    for field in FIELDS:
+        commands.append('REG SET 0x%02X %s ' % (field.reg, field.name))
+        commands.append('REG GET 0x%02X %s' % (field.reg, field.name))
+    return commands
@@ -3,6 +3,7 @@
 """
 USB CDC串口通信模块
 双线程双缓冲机制
+文本行通过 data_received 发出，二进制帧（SET_FORMAT:binary）解码后通过 frame_received 发出
 """
 
 import serial
@@ -10,12 +11,14 @@ import serial.tools.list_ports
 from PyQt5.QtCore import QThread, pyqtSignal, QMutex, QMutexLocker
 from collections import deque
 import time
+from .frame_decoder import FrameDecoder
 
 class SerialCommunication(QThread):
     """串口通信类 - 使用双线程和双缓冲"""
     
     # 信号
     data_received = pyqtSignal(str)  # 接收到数据
+    frame_received = pyqtSignal(object)  # 接收到二进制帧（MatrixFrame）
     status_changed = pyqtSignal(str, str)  # 状态变化 (status, message)
     
     def __init__(self):
@@ -174,6 +177,8 @@ class SerialCommunication(QThread):
             if self.serial_port:
                 receive_thread = ReceiveThread(self.serial_port, self.receive_buffer, self.receive_lock)
                 receive_thread.data_received.connect(self.on_receive_data)
+                receive_thread.frame_received.connect(self.frame_received.emit)
+                receive_thread.keyframe_needed.connect(self.request_keyframe)
                 receive_thread.connection_lost.connect(lambda: self.on_connection_lost())
                 receive_thread.start()
                 
@@ -263,6 +268,11 @@ class SerialCommunication(QThread):
                 receive_thread.stop()
                 receive_thread.wait(1000)
                 
+    def request_keyframe(self):
+        """差分帧缺少参考帧时请求设备发送关键帧（直接入队，不做连接检测以免清空接收缓冲区）"""
+        with QMutexLocker(self.send_lock):
+            self.send_buffer.append("KEYFRAME\r\n")
+    
     def on_receive_data(self, data):
         """接收数据回调（在主线程中）"""
         pass  # 数据已通过信号发送
@@ -286,18 +296,23 @@ class ReceiveThread(QThread):
     """接收线程（子线程）"""
     
     data_received = pyqtSignal(str)
+    frame_received = pyqtSignal(object)  # 二进制帧（MatrixFrame）
+    keyframe_needed = pyqtSignal()  # 差分帧无法重建，需要关键帧
     connection_lost = pyqtSignal()  # 连接丢失信号
     
+    KEYFRAME_RETRY_S = 0.5  # 请求关键帧的最短间隔
+    
     def __init__(self, serial_port, buffer, lock):
         super().__init__()
         self.serial_port = serial_port
         self.buffer = buffer
         self.lock = lock
         self.running = True
+        self.decoder = FrameDecoder()
+        self.last_keyframe_request = 0.0
         
     def run(self):
         """接收线程运行"""
-        line_buffer = ""
         
         while self.running and self.serial_port:
             waiting = 0
@@ -325,16 +340,19 @@ class ReceiveThread(QThread):
                             data = self.serial_port.read(waiting)
                         except serial.SerialTimeoutException:
                             data = b""
-                        line_buffer += data.decode('utf-8', errors='ignore')
                         
-                        # 批量处理多行数据，提高效率
+                        # 按0x00分隔符拆出二进制帧，其余按行拆分
                         # 注意：确保完整行才发送，避免半行数据
-                        lines_to_send = []
-                        while '\n' in line_buffer:
-                            line, line_buffer = line_buffer.split('\n', 1)
-                            line = line.strip()
-                            if line:
-                                lines_to_send.append(line)
+                        lines_to_send, frames = self.decoder.feed(data)
+                        now = time.perf_counter()
+                        for frame in frames:
+                            frame.host_time = now  # 端到端延迟统计用（FrameTiming）
+                            self.frame_received.emit(frame)
+                        if self.decoder.resync_needed:
+                            now = time.time()
+                            if now - self.last_keyframe_request >= self.KEYFRAME_RETRY_S:
+                                self.last_keyframe_request = now
+                                self.keyframe_needed.emit()
                         
                         # 批量写入接收缓冲区（线程安全）
                         if lines_to_send:
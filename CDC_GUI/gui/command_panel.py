@@ -6,11 +6,14 @@
 """
 
 from PyQt5.QtWidgets import (QWidget, QVBoxLayout, QHBoxLayout, QPushButton, 
-                             QLineEdit, QComboBox, QGroupBox, QGridLayout, QLabel, QSizePolicy, QSpacerItem)
+                             QLineEdit, QComboBox, QGroupBox, QGridLayout, QLabel, QSizePolicy, QSpacerItem,
+                             QCompleter)
 from PyQt5.QtCore import pyqtSignal, Qt
 import os
 import json
 
+from communication.pcap04_registers import reg_commands
+
 class CommandPanel(QWidget):
     """命令发送面板"""
     
@@ -120,6 +123,11 @@ class CommandPanel(QWidget):
         self.custom_edit = QLineEdit()
         self.custom_edit.setPlaceholderText("输入命令，如: SET_RATE:50")
         self.custom_edit.returnPressed.connect(self.send_custom_command)
+        # REG SET/GET 字段名补全，来自固件寄存器定义生成的表
+        reg_completer = QCompleter(reg_commands(), self.custom_edit)
+        reg_completer.setCaseSensitivity(Qt.CaseInsensitive)
+        reg_completer.setFilterMode(Qt.MatchContains)
+        self.custom_edit.setCompleter(reg_completer)
         
         custom_btn = QPushButton("发送")
         custom_btn.clicked.connect(self.send_custom_command)
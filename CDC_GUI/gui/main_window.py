@@ -14,6 +14,7 @@ from gui.matrix_widget import MatrixWidget
 from gui.message_log import MessageLog
 from gui.command_panel import CommandPanel
 from communication.serial_communication import SerialCommunication
+from communication.frame_timing import FrameTiming, ResendRequester, parse_marker
 from database.database_manager import DatabaseManager
 
 class MainWindow(QMainWindow):
@@ -54,6 +55,12 @@ class MainWindow(QMainWindow):
         self.expected_rows = set(range(16))  # 期望的行号（Y00-Y15）
         # 统计START/END期间的字节数
         self.transfer_byte_count = 0
+        # 帧序号/时间戳统计（START:<seq>,<us> / END:<seq>,<us> 或二进制帧头）
+        self.frame_timing = FrameTiming()
+        self.frame_marker = None  # 当前文本帧 START 行的 (seq, start_us)
+        self.timing_display_time = 0.0  # 上次刷新帧时序显示的时间
+        # 丢帧/缺行时发送 GET_FRAME:<seq> 从设备历史帧补回
+        self.resend = ResendRequester()
         
         # 追踪的点（行，列）
         self.tracked_point = None
@@ -345,6 +352,19 @@ class MainWindow(QMainWindow):
         fmt_row.addWidget(self.format_display)
         fmt_row.addStretch()
         mode_layout.addLayout(fmt_row)
+
+        # 帧时序显示：序号、丢帧、帧间隔/抖动、扫描耗时、延迟波动
+        timing_row = QHBoxLayout()
+        timing_label = QLabel("帧时序:")
+        timing_label.setStyleSheet("font-size: 9pt;")
+        timing_label.setMaximumHeight(18)
+        timing_row.addWidget(timing_label)
+        self.timing_display = QLabel("-")
+        self.timing_display.setStyleSheet("color: #333333; font-size: 9pt;")
+        self.timing_display.setMaximumHeight(18)
+        timing_row.addWidget(self.timing_display)
+        timing_row.addStretch()
+        mode_layout.addLayout(timing_row)
         
         # 初始状态：根据当前模式启用/禁用量化参数
         self.update_quant_controls_enabled()
@@ -415,6 +435,7 @@ class MainWindow(QMainWindow):
         
         # 串口通信信号
         self.serial_comm.data_received.connect(self.on_data_received)
+        self.serial_comm.frame_received.connect(self.on_frame_received)
         self.serial_comm.status_changed.connect(self.on_serial_status_changed)
         
         # 矩阵点击信号
@@ -449,6 +470,8 @@ class MainWindow(QMainWindow):
             self.current_port = display_name  # 保存显示名称
             
             if self.serial_comm.connect(port):
+                self.frame_timing.reset()
+                self.resend.reset()
                 self.connect_btn.setEnabled(False)
                 self.disconnect_btn.setEnabled(True)
                 self.statusBar().showMessage(f"已连接到 {display_name}")
@@ -613,19 +636,117 @@ class MainWindow(QMainWindow):
         # 不显示矩阵数据日志（提升性能）
         # 只在非矩阵数据时显示响应消息
         if not self.matrix_receiving and data.strip() and not (line.startswith('Y') or line.startswith('X')):
-            # 也不显示START/END，完全静默处理矩阵数据
-            if line not in ["START", "END"]:
+            # 也不显示START/END（含帧标记），完全静默处理矩阵数据
+            if line not in ["START", "END"] and parse_marker(line) is None:
                 self.message_log.add_response(data, "received")
     
+    def on_frame_received(self, frame):
+        """处理二进制帧（SET_FORMAT:binary）：整帧已通过CRC校验，直接替换矩阵数据"""
+        if self.test_mode_active:
+            return
+        
+        import time
+        late = self.frame_timing.is_late(frame.seq)
+        self._request_resend(self.resend.on_frame(frame.seq, True, time.perf_counter()))
+        self.frame_timing.add(frame.seq, frame.timestamp_us, frame.end_us, frame.host_time)
+        self._update_timing_display()
+        self.current_frame_id += 1
+        if late:
+            # 补回的旧帧只存入数据库，不覆盖界面上更新的数据
+            self._record_current_frame(frame.values)
+            return
+        
+        rows = min(frame.rows, 16)
+        cols = min(frame.cols, 16)
+        for r in range(rows):
+            self.matrix_data[r][:cols] = frame.values[r][:cols]
+        self.matrix_data_changed = True
+        
+        if self.current_format != 'binary':
+            self.current_format = 'binary'
+            self.update_format_display()
+        
+        if self.tracked_point:
+            row, col = self.tracked_point
+            raw_value = self.matrix_data[row][col]
+            if self.output_mode == "quant":
+                display_value = self.quantize_value(raw_value)
+                self.db_manager.add_data_point(row, col, display_value, raw_value=raw_value, non_blocking=True)
+            else:
+                self.db_manager.add_data_point(row, col, raw_value, raw_value=raw_value, non_blocking=True)
+        
+        self._record_current_frame()
+    
+    def _update_timing_display(self):
+        """刷新帧时序显示（最多每0.5秒一次）"""
+        import time
+        now = time.perf_counter()
+        if now - self.timing_display_time < 0.5:
+            return
+        self.timing_display_time = now
+        try:
+            self.timing_display.setText(self.frame_timing.summary() + " | " + self.resend.summary())
+        except Exception:
+            pass
+    
+    def _request_resend(self, seqs):
+        """请求设备重发历史帧"""
+        for seq in seqs:
+            self.serial_comm.send_command("GET_FRAME:%d" % seq)
+    
+    def _text_frame_complete(self):
+        """当前文本帧是否完整：表格格式16行都已收到，简洁格式256个点"""
+        if self.current_format == 'table':
+            return self.received_rows >= self.expected_rows
+        if self.current_format == 'simple':
+            return len(self.matrix_buffer) >= 256
+        return False
+    
+    def _record_current_frame(self, values=None):
+        """把当前矩阵（或给定的 values[row][col]）作为一帧记录到数据库"""
+        matrix = values if values is not None else self.matrix_data
+        try:
+            if self.auto_record_enabled and self.db_manager:
+                from datetime import datetime
+                ts = datetime.now()
+                frame_points = []
+                for r in range(16):
+                    for c in range(16):
+                        raw_val = matrix[r][c]
+                        if raw_val is None:
+                            raw_val = 0
+                        if self.output_mode == "quant":
+                            disp_val = self.quantize_value(raw_val)
+                        else:
+                            disp_val = raw_val
+                        frame_points.append((ts, r, c, disp_val, raw_val, self.current_frame_id))
+                self.db_manager.add_frame_points(frame_points)
+        except Exception as e:
+            print(f"记录帧到数据库失败: {e}")
+    
     def _process_single_line(self, line, rows_updated):
         """处理单行数据（优化版本，减少函数调用开销）"""
         line = line.strip()
         if not line:
             return
         
+        # 帧标记 START:<seq>,<us> / END:<seq>,<us>；不带参数的 START/END 为会话标记
+        marker = parse_marker(line)
+        
+        # GET_FRAME 请求的帧已被设备回收
+        if line.startswith("ERROR: Frame "):
+            try:
+                self.resend.on_unavailable(int(line.split()[2]))
+            except (ValueError, IndexError):
+                pass
+        
         # 检测START标记（记录开始时间，用于计算时差）
-        if line == "START":
+        if line == "START" or (marker is not None and marker[0] == "START"):
             import time
+            if self.frame_marker is not None and marker is not None:
+                # 上一帧的END丢失：整帧请求重发
+                self._request_resend(self.resend.on_frame(self.frame_marker[0], False, time.perf_counter()))
+            self.frame_marker = marker[1:] if marker is not None else None
             self.start_time = time.time() * 1000  # 转换为毫秒
             self.matrix_receiving = True
             self.current_format = None
@@ -644,7 +765,19 @@ class MainWindow(QMainWindow):
             return
         
         # 检测END标记（只计算时差，不打印日志以提升性能）
-        if line == "END":
+        if line == "END" or (marker is not None and marker[0] == "END"):
+            if marker is not None:
+                import time
+                now = time.perf_counter()
+                # START丢失或帧内缺行（接收缓冲区溢出、串口丢数据）时请求重发该帧
+                complete = (self.frame_marker is not None and self.frame_marker[0] == marker[1]
+                            and self._text_frame_complete())
+                self._request_resend(self.resend.on_frame(marker[1], complete, now))
+                if self.frame_marker is not None and self.frame_marker[0] == marker[1]:
+                    # 文本行经接收缓冲区转交主线程，主机时间比二进制帧粗略
+                    self.frame_timing.add(marker[1], self.frame_marker[1], marker[2], now)
+                    self._update_timing_display()
+            self.frame_marker = None
             if self.start_time is not None:
                 import time
                 end_time = time.time() * 1000
@@ -662,24 +795,7 @@ class MainWindow(QMainWindow):
                 except Exception:
                     pass
                 # 记录本帧到数据库
-                try:
-                    if self.auto_record_enabled and self.db_manager:
-                        from datetime import datetime
-                        ts = datetime.now()
-                        frame_points = []
-                        for r in range(16):
-                            for c in range(16):
-                                raw_val = self.matrix_data[r][c]
-                                if raw_val is None:
-                                    raw_val = 0
-                                if self.output_mode == "quant":
-                                    disp_val = self.quantize_value(raw_val)
-                                else:
-                                    disp_val = raw_val
-                                frame_points.append((ts, r, c, disp_val, raw_val, self.current_frame_id))
-                        self.db_manager.add_frame_points(frame_points)
-                except Exception as e:
-                    print(f"记录帧到数据库失败: {e}")
+                self._record_current_frame()
                 self.start_time = None
             
             # 处理缓冲区中剩余的数据（确保不遗漏）
@@ -771,6 +887,8 @@ class MainWindow(QMainWindow):
                     self.format_display.setText("SIMPLE (逐点)")
                 elif self.current_format == 'table':
                     self.format_display.setText("TABLE (按行)")
+                elif self.current_format == 'binary':
+                    self.format_display.setText("BINARY (COBS帧)")
                 else:
                     self.format_display.setText("未知")
         except Exception:
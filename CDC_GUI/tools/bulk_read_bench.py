@@ -0,0 +1,120 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+USB CDC 批量读取吞吐量测试
+向设备发送 BENCH:<KB>，读取测试图样并校验，输出主机端/设备端吞吐量
+
+图样：每64字节一行，62个相同字母 + '\\r\\n'，字母按行号 A..Z 循环；
+结束行 BENCH_DONE:<字节数>,<微秒> 为设备端耗时
+
+用法：python bulk_read_bench.py COM5 --kb 1024 --runs 3
+修改固件USB端点配置前后各运行一次对比
+"""
+
+import argparse
+import sys
+import time
+
+import serial
+
+BENCH_LINE = 64
+READ_CHUNK = 16384
+
+
+def expected_line(index):
+    """第 index 行的图样"""
+    return bytes([ord('A') + index % 26]) * (BENCH_LINE - 2) + b'\r\n'
+
+
+def read_line(ser, timeout):
+    """读取一行文本（不含换行），超时返回None"""
+    deadline = time.perf_counter() + timeout
+    line = bytearray()
+    while time.perf_counter() < deadline:
+        b = ser.read(1)
+        if not b:
+            continue
+        if b == b'\n':
+            return line.decode('utf-8', errors='ignore').strip()
+        line += b
+    return None
+
+
+def run_once(ser, kb, timeout):
+    """执行一次测试，返回 (字节数, 主机端秒数, 设备端微秒数, 错误行数)"""
+    ser.reset_input_buffer()
+    ser.write(('BENCH:%d\r\n' % kb).encode('ascii'))
+
+    # 等待确认（之前残留的文本行直接跳过）
+    while True:
+        line = read_line(ser, timeout)
+        if line is None:
+            raise RuntimeError("no reply to BENCH")
+        if line.startswith('ERROR'):
+            raise RuntimeError(line)
+        if line.startswith('OK: BENCH'):
+            total = int(line.split()[2])
+            break
+
+    received = bytearray()
+    start = None
+    deadline = time.perf_counter() + timeout
+    while len(received) < total:
+        chunk = ser.read(min(READ_CHUNK, total - len(received)))
+        now = time.perf_counter()
+        if chunk:
+            if start is None:
+                start = now
+            received += chunk
+            deadline = now + timeout
+        elif now > deadline:
+            raise RuntimeError("timeout after %d of %d bytes" % (len(received), total))
+    elapsed = time.perf_counter() - start
+
+    bad_lines = 0
+    for i in range(total // BENCH_LINE):
+        if received[i * BENCH_LINE:(i + 1) * BENCH_LINE] != expected_line(i):
+            bad_lines += 1
+
+    device_us = None
+    line = read_line(ser, timeout)
+    if line is not None and line.startswith('BENCH_DONE:'):
+        sent, device_us = (int(v) for v in line[len('BENCH_DONE:'):].split(','))
+        if sent != total:
+            bad_lines += 1
+
+    return total, elapsed, device_us, bad_lines
+
+
+def main():
+    parser = argparse.ArgumentParser(description='USB CDC bulk IN throughput benchmark (BENCH command)')
+    parser.add_argument('port', help='串口名，例如 COM5 或 /dev/ttyACM0')
+    parser.add_argument('--kb', type=int, default=1024, help='每次测试的数据量（KB，1-4096）')
+    parser.add_argument('--runs', type=int, default=3, help='测试次数')
+    parser.add_argument('--timeout', type=float, default=2.0, help='无数据超时（秒）')
+    args = parser.parse_args()
+
+    ser = serial.Serial(args.port, 115200, timeout=0.05)
+    try:
+        # 停止扫描并丢弃正在发送的数据
+        ser.write(b'STOP\r\n')
+        time.sleep(0.3)
+        ser.reset_input_buffer()
+
+        failed = False
+        for run in range(args.runs):
+            total, elapsed, device_us, bad_lines = run_once(ser, args.kb, args.timeout)
+            host_rate = total / elapsed / 1024.0
+            text = "run %d: %d bytes in %.3f s, host %.1f KB/s" % (run + 1, total, elapsed, host_rate)
+            if device_us:
+                text += ", device %.1f KB/s" % (total / (device_us / 1e6) / 1024.0)
+            text += ", bad lines %d" % bad_lines
+            print(text)
+            failed = failed or bad_lines != 0
+        return 1 if failed else 0
+    finally:
+        ser.close()
+
+
+if __name__ == '__main__':
+    sys.exit(main())
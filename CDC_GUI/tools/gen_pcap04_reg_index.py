@@ -0,0 +1,457 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+PCap04 寄存器字段索引生成器
+解析固件的寄存器定义表 21211/usb_cdc/Core/Src/pcap04_register_def.c，生成：
+  Core/Inc/pcap04_reg_index.h   字段枚举 PCAP04_FIELD_<名称> 和 字段 -> (寄存器, 位段) 表
+  Core/Src/pcap04_reg_index.c   字段名的最小完美哈希（一次哈希 + 一次 strcmp 确认）、
+                                寄存器地址 -> 定义表下标
+  CDC_GUI/communication/pcap04_registers.py  同一份寄存器/字段/选项表，字段编号与固件一致
+
+字段名在所有寄存器中唯一，哈希以字段名为键，查到后再核对寄存器地址。
+完美哈希用"哈希-位移"法：一级哈希 FNV-1a（标准初值）把字段分到 N 个桶，
+每个桶找一个种子 d，使桶内字段以 d 为初值的 FNV-1a 落到互不冲突的空位；
+只有一个字段的桶直接记录位置（存为 -位置-1）。N 等于字段数，没有空位浪费。
+
+修改 pcap04_register_def.c 后运行：python gen_pcap04_reg_index.py
+加 --check 只检查生成文件是否为最新（不写文件，过期时返回1）
+"""
+
+import argparse
+import re
+import sys
+from pathlib import Path
+
+ROOT = Path(__file__).resolve().parents[2]
+FW_DIR = ROOT / '21211' / 'usb_cdc' / 'Core'
+DEF_C = FW_DIR / 'Src' / 'pcap04_register_def.c'
+OUT_H = FW_DIR / 'Inc' / 'pcap04_reg_index.h'
+OUT_C = FW_DIR / 'Src' / 'pcap04_reg_index.c'
+OUT_PY = ROOT / 'CDC_GUI' / 'communication' / 'pcap04_registers.py'
+
+FNV_BASIS = 0x811C9DC5
+FNV_PRIME = 16777619
+MAX_SEED = 0x7FFF  # 位移表为 int16_t
+
+_OPTIONS_RE = re.compile(r'static\s+const\s+PCAP04_BitOption_t\s+(\w+)\s*\[\s*\]\s*=\s*\{(.*?)\};', re.S)
+_OPTION_RE = re.compile(r'\{\s*(0x[0-9A-Fa-f]+|\d+)\s*,\s*"([^"]*)"\s*,\s*"([^"]*)"\s*\}')
+_BITS_RE = re.compile(r'static\s+const\s+PCAP04_RegBit_t\s+(\w+)\s*\[\s*\]\s*=\s*\{(.*?)\};', re.S)
+_BIT_RE = re.compile(r'\{\s*(\d+)\s*,\s*(\d+)\s*,\s*"([^"]*)"\s*,\s*"([^"]*)"\s*,\s*(\d+)\s*,\s*(\w+)\s*\}')
+_REGS_RE = re.compile(r'static\s+const\s+PCAP04_Register_t\s+PCAP04_REGISTERS\s*\[\s*\]\s*=\s*\{(.*?)\};', re.S)
+_REG_RE = re.compile(r'\{\s*(0x[0-9A-Fa-f]+|\d+)\s*,\s*"([^"]*)"\s*,\s*"([^"]*)"\s*,\s*(\d+)\s*,\s*(\w+)\s*,\s*'
+                     r'(0x[0-9A-Fa-f]+|\d+)\s*\}')
+_IDENT_RE = re.compile(r'^[A-Za-z_][A-Za-z0-9_]*$')
+
+
+def strip_comments(text):
+    """去掉 C 注释（寄存器表行尾有 // 注释，块注释里可能出现花括号）"""
+    text = re.sub(r'/\*.*?\*/', '', text, flags=re.S)
+    return re.sub(r'//[^\n]*', '', text)
+
+
+def parse_definitions(path):
+    """解析寄存器定义表，返回 (registers, fields)，fields 按寄存器地址、位段在表中的顺序排列"""
+    text = strip_comments(path.read_text(encoding='utf-8', errors='replace'))
+
+    options = {}
+    for name, body in _OPTIONS_RE.findall(text):
+        # value 为 uint8_t，超过一字节的常数在固件中被截断，这里保持一致
+        options[name] = [(int(v, 0) & 0xFF, n, d) for v, n, d in _OPTION_RE.findall(body)]
+
+    bit_arrays = {}
+    for name, body in _BITS_RE.findall(text):
+        bits = []
+        for start, end, fname, desc, count, opt in _BIT_RE.findall(body):
+            opts = options.get(opt, []) if opt not in ('0', 'NULL') else []
+            if len(opts) < int(count):
+                raise SystemExit('%s.%s: options_count=%s, %s has %d entries' % (name, fname, count, opt, len(opts)))
+            # 固件只使用前 options_count 个选项（共用的选项表可能更长）
+            bits.append((int(start), int(end), fname, desc, opts[:int(count)]))
+        bit_arrays[name] = bits
+
+    table = _REGS_RE.search(text)
+    if table is None:
+        raise SystemExit('PCAP04_REGISTERS[] not found in %s' % path)
+
+    registers = []
+    fields = []
+    for pos, (addr, rname, rdesc, count, bits_name, default) in enumerate(_REG_RE.findall(table.group(1))):
+        bits = bit_arrays.get(bits_name, []) if bits_name not in ('0', 'NULL') else []
+        if len(bits) != int(count):
+            raise SystemExit('register %s: bits_count=%s, %s has %d entries' % (rname, count, bits_name, len(bits)))
+        ids = []
+        for index, (start, end, fname, desc, opts) in enumerate(bits):
+            ids.append(len(fields))
+            fields.append({'name': fname, 'reg': int(addr, 0), 'pos': pos, 'index': index,
+                           'start': start, 'end': end, 'desc': desc, 'options': opts})
+        registers.append({'addr': int(addr, 0), 'name': rname, 'desc': rdesc,
+                          'default': int(default, 0), 'fields': ids})
+
+    seen = {}
+    for f in fields:
+        if not _IDENT_RE.match(f['name']):
+            raise SystemExit('field name %r is not a C identifier' % f['name'])
+        if f['name'] in seen:
+            raise SystemExit('field name %s used by registers 0x%02X and 0x%02X; the index keys on field name'
+                             % (f['name'], seen[f['name']], f['reg']))
+        seen[f['name']] = f['reg']
+    return registers, fields
+
+
+def fnv1a(seed, name):
+    h = seed
+    for b in name.encode('ascii'):
+        h = ((h ^ b) * FNV_PRIME) & 0xFFFFFFFF
+    return h
+
+
+def build_perfect_hash(names):
+    """哈希-位移法构造最小完美哈希，返回 (位移表, 位置 -> 下标表)"""
+    size = len(names)
+    buckets = [[] for _ in range(size)]
+    for i, name in enumerate(names):
+        buckets[fnv1a(FNV_BASIS, name) % size].append(i)
+
+    disp = [0] * size
+    slots = [None] * size
+    order = sorted(range(size), key=lambda b: len(buckets[b]), reverse=True)
+
+    pending = 0
+    for pending, b in enumerate(order):
+        bucket = buckets[b]
+        if len(bucket) <= 1:
+            break
+        for d in range(1, MAX_SEED + 1):
+            placed = []
+            for i in bucket:
+                s = fnv1a(d, names[i]) % size
+                if slots[s] is not None or s in placed:
+                    break
+                placed.append(s)
+            else:
+                break
+        else:
+            raise SystemExit('no displacement found for bucket %d' % b)
+        disp[b] = d
+        for i, s in zip(bucket, placed):
+            slots[s] = i
+    else:
+        pending = size
+
+    free = [s for s in range(size) if slots[s] is None]
+    for b in order[pending:]:
+        if not buckets[b]:
+            continue
+        s = free.pop()
+        slots[s] = buckets[b][0]
+        disp[b] = -s - 1
+
+    for i, name in enumerate(names):
+        d = disp[fnv1a(FNV_BASIS, name) % size]
+        s = (-d - 1) if d < 0 else fnv1a(d, name) % size
+        assert slots[s] == i, name
+    return disp, slots
+
+
+def c_rows(values, fmt, per_line):
+    rows = []
+    for i in range(0, len(values), per_line):
+        rows.append('\t' + ', '.join(fmt % v for v in values[i:i + per_line]))
+    return ',\n'.join(rows)
+
+
+def bit_range(f):
+    if f['start'] == f['end']:
+        return '[%d]' % f['start']
+    return '[%d:%d]' % (f['end'], f['start'])
+
+
+def gen_header(registers, fields):
+    reg_name = {r['addr']: r['name'] for r in registers}
+    enum_rows = []
+    for i, f in enumerate(fields):
+        enum_rows.append('\tPCAP04_FIELD_%s = %d,%s/* 0x%02X %s %s */'
+                         % (f['name'], i, ' ' * max(1, 24 - len(f['name']) - len(str(i))),
+                            f['reg'], reg_name[f['reg']], bit_range(f)))
+    max_addr = max(r['addr'] for r in registers)
+    return '''/* 本文件由 CDC_GUI/tools/gen_pcap04_reg_index.py 根据 pcap04_register_def.c 生成，请勿手工修改 */
+#ifndef __PCAP04_REG_INDEX_H
+#define __PCAP04_REG_INDEX_H
+
+#include <stdint.h>
+#include "pcap04_register.h"
+
+/*
+ * 寄存器字段索引：
+ * - PCAP04_FIELD_* 为字段编号，代码中可直接使用，不再按名称查找；
+ * - PCAP04_FindField() 按字段名查编号，最小完美哈希，一次哈希计算加一次 strcmp 确认；
+ * - PCAP04_FindRegisterIndex() 按寄存器地址直接取定义；
+ * - PCAP04_SetField()/PCAP04_GetField() 按字段编号读写寄存器镜像，返回值同 PCAP04_SetRegisterBit()/GetRegisterBit()。
+ * 字段编号与上位机 communication/pcap04_registers.py 中的编号一致。
+ */
+
+#define PCAP04_REG_ADDR_LIMIT  %(addr_limit)dU   /* 定义表中的地址范围 0x00-0x%(max_addr)02X */
+
+typedef enum
+{
+%(enum_rows)s
+	PCAP04_FIELD_COUNT = %(count)d,
+	PCAP04_FIELD_INVALID = 0xFF
+} PCAP04_FieldId_t;
+
+typedef struct
+{
+	uint8_t reg_addr;   /* 所在寄存器地址 */
+	uint8_t bit_start;  /* 起始位 */
+	uint8_t bit_end;    /* 结束位 */
+	uint8_t reg_pos;    /* 寄存器在 PCAP04_REGISTER_TABLE 中的下标 */
+	uint8_t bit_index;  /* 字段在该寄存器 bits[] 中的下标 */
+} PCAP04_FieldIndex_t;
+
+extern const PCAP04_FieldIndex_t PCAP04_FIELD_INDEX[PCAP04_FIELD_COUNT];
+
+PCAP04_FieldId_t PCAP04_FindField(const char *name);
+const PCAP04_RegBit_t* PCAP04_GetFieldDefinition(PCAP04_FieldId_t id);
+const PCAP04_Register_t* PCAP04_FindRegisterIndex(uint8_t reg_addr);
+uint8_t PCAP04_SetField(uint8_t *reg_array, PCAP04_FieldId_t id, uint8_t value);
+uint8_t PCAP04_GetField(const uint8_t *reg_array, PCAP04_FieldId_t id);
+
+#endif /* __PCAP04_REG_INDEX_H */
+''' % {'enum_rows': '\n'.join(enum_rows), 'count': len(fields),
+       'addr_limit': max_addr + 1, 'max_addr': max_addr}
+
+
+def gen_source(registers, fields):
+    names = [f['name'] for f in fields]
+    disp, slots = build_perfect_hash(names)
+    if len(fields) > 0xFE:
+        raise SystemExit('too many fields for uint8_t ids')
+
+    addr_limit = max(r['addr'] for r in registers) + 1
+    reg_pos = [0xFF] * addr_limit
+    for pos, r in enumerate(registers):
+        reg_pos[r['addr']] = pos
+
+    index_rows = ',\n'.join('\t{0x%02XU, %dU, %dU, %dU, %dU}' % (f['reg'], f['start'], f['end'], f['pos'], f['index'])
+                            for f in fields)
+    return '''/* 本文件由 CDC_GUI/tools/gen_pcap04_reg_index.py 根据 pcap04_register_def.c 生成，请勿手工修改 */
+#include "pcap04_reg_index.h"
+#include <string.h>
+
+#define FIELD_HASH_SIZE   %(size)dU
+#define FIELD_HASH_BASIS  0x%(basis)08XUL
+#define FIELD_HASH_PRIME  %(prime)dUL
+
+const PCAP04_FieldIndex_t PCAP04_FIELD_INDEX[PCAP04_FIELD_COUNT] = {
+%(index_rows)s
+};
+
+/* 一级哈希桶 -> 种子（>=0）或直接位置（-位置-1） */
+static const int16_t s_field_disp[FIELD_HASH_SIZE] = {
+%(disp)s
+};
+
+/* 哈希位置 -> 字段编号 */
+static const uint8_t s_field_slot[FIELD_HASH_SIZE] = {
+%(slots)s
+};
+
+/* 寄存器地址 -> PCAP04_REGISTER_TABLE 下标，0xFF 为未定义 */
+static const uint8_t s_reg_pos[PCAP04_REG_ADDR_LIMIT] = {
+%(reg_pos)s
+};
+
+static uint32_t field_hash(uint32_t seed, const char *name)
+{
+	uint32_t h = seed;
+	while (*name != '\\0')
+	{
+		h = (h ^ (uint8_t)*name++) * FIELD_HASH_PRIME;
+	}
+	return h;
+}
+
+PCAP04_FieldId_t PCAP04_FindField(const char *name)
+{
+	if (name == NULL)
+	{
+		return PCAP04_FIELD_INVALID;
+	}
+	int16_t d = s_field_disp[field_hash(FIELD_HASH_BASIS, name) %% FIELD_HASH_SIZE];
+	uint32_t slot = (d < 0) ? (uint32_t)(-d - 1) : (field_hash((uint32_t)d, name) %% FIELD_HASH_SIZE);
+	PCAP04_FieldId_t id = (PCAP04_FieldId_t)s_field_slot[slot];
+	/* 完美哈希只保证已知字段不冲突，未知名称也会落到某个位置，需比较一次名称 */
+	if (strcmp(PCAP04_GetFieldDefinition(id)->name, name) != 0)
+	{
+		return PCAP04_FIELD_INVALID;
+	}
+	return id;
+}
+
+const PCAP04_RegBit_t* PCAP04_GetFieldDefinition(PCAP04_FieldId_t id)
+{
+	if ((uint32_t)id >= (uint32_t)PCAP04_FIELD_COUNT)
+	{
+		return NULL;
+	}
+	const PCAP04_FieldIndex_t *f = &PCAP04_FIELD_INDEX[id];
+	return &PCAP04_REGISTER_TABLE.registers[f->reg_pos].bits[f->bit_index];
+}
+
+const PCAP04_Register_t* PCAP04_FindRegisterIndex(uint8_t reg_addr)
+{
+	if (reg_addr >= PCAP04_REG_ADDR_LIMIT || s_reg_pos[reg_addr] == 0xFFU)
+	{
+		return NULL;
+	}
+	return &PCAP04_REGISTER_TABLE.registers[s_reg_pos[reg_addr]];
+}
+
+uint8_t PCAP04_SetField(uint8_t *reg_array, PCAP04_FieldId_t id, uint8_t value)
+{
+	if (reg_array == NULL || (uint32_t)id >= (uint32_t)PCAP04_FIELD_COUNT)
+	{
+		return 1U;
+	}
+	const PCAP04_FieldIndex_t *f = &PCAP04_FIELD_INDEX[id];
+	if (f->reg_addr >= PCAP04_REG_COUNT)
+	{
+		return 1U;
+	}
+	reg_array[f->reg_addr] = PCAP04_SetBitValue(reg_array[f->reg_addr], f->bit_start, f->bit_end, value);
+	return 0U;
+}
+
+uint8_t PCAP04_GetField(const uint8_t *reg_array, PCAP04_FieldId_t id)
+{
+	if (reg_array == NULL || (uint32_t)id >= (uint32_t)PCAP04_FIELD_COUNT)
+	{
+		return 0U;
+	}
+	const PCAP04_FieldIndex_t *f = &PCAP04_FIELD_INDEX[id];
+	if (f->reg_addr >= PCAP04_REG_COUNT)
+	{
+		return 0U;
+	}
+	return PCAP04_GetBitValue(reg_array[f->reg_addr], f->bit_start, f->bit_end);
+}
+''' % {'size': len(fields), 'basis': FNV_BASIS, 'prime': FNV_PRIME, 'index_rows': index_rows,
+       'disp': c_rows(disp, '%d', 16), 'slots': c_rows(slots, '%dU', 16),
+       'reg_pos': c_rows(reg_pos, '0x%02XU', 16)}
+
+
+def gen_python(registers, fields):
+    reg_rows = []
+    for r in registers:
+        reg_rows.append('    Register(0x%02X, %r, %r, 0x%02X, %r),' % (r['addr'], r['name'], r['desc'], r['default'],
+                                                                       tuple(r['fields'])))
+    field_rows = []
+    for i, f in enumerate(fields):
+        opts = ''.join('\n        Option(0x%02X, %r, %r),' % o for o in f['options'])
+        field_rows.append('    Field(%d, %r, 0x%02X, %d, %d, %r, (%s)),'
+                          % (i, f['name'], f['reg'], f['start'], f['end'], f['desc'],
+                             (opts + '\n    ') if opts else ''))
+    return '''#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+PCap04 寄存器/字段/选项表
+本文件由 tools/gen_pcap04_reg_index.py 根据固件 pcap04_register_def.c 生成，请勿手工修改
+字段编号与固件 pcap04_reg_index.h 中的 PCAP04_FIELD_* 一致；
+Option.value 与固件相同，是移位到字段位置后的值
+"""
+
+from collections import namedtuple
+
+Register = namedtuple('Register', 'addr name desc default fields')
+Field = namedtuple('Field', 'id name reg bit_start bit_end desc options')
+Option = namedtuple('Option', 'value name desc')
+
+REGISTERS = (
+%(regs)s
+)
+
+FIELDS = (
+%(fields)s
+)
+
+REGISTER_BY_ADDR = {r.addr: r for r in REGISTERS}
+FIELD_BY_NAME = {f.name: f for f in FIELDS}
+
+
+def field_mask(field):
+    """字段在寄存器字节中的掩码"""
+    return ((1 << (field.bit_end - field.bit_start + 1)) - 1) << field.bit_start
+
+
+def field_value(field, reg_value):
+    """从寄存器字节中取出字段值"""
+    return (reg_value & field_mask(field)) >> field.bit_start
+
+
+def set_field(field, reg_value, value):
+    """把字段值写入寄存器字节，返回新的字节"""
+    mask = field_mask(field)
+    return (reg_value & ~mask & 0xFF) | ((value << field.bit_start) & mask)
+
+
+def find_option(field, value):
+    """字段值对应的选项，没有时返回 None"""
+    encoded = (value << field.bit_start) & 0xFF
+    for option in field.options:
+        if option.value == encoded:
+            return option
+    return None
+
+
+def decode(addr, reg_value):
+    """解码寄存器字节，返回 [(字段, 字段值, 选项或None), ...]"""
+    reg = REGISTER_BY_ADDR.get(addr)
+    if reg is None:
+        return []
+    result = []
+    for fid in reg.fields:
+        field = FIELDS[fid]
+        value = field_value(field, reg_value)
+        result.append((field, value, find_option(field, value)))
+    return result
+
+
+def reg_commands():
+    """所有字段的 REG SET/GET 命令前缀，供命令输入框补全"""
+    commands = []
+    for field in FIELDS:
+        commands.append('REG SET 0x%%02X %%s ' %% (field.reg, field.name))
+        commands.append('REG GET 0x%%02X %%s' %% (field.reg, field.name))
+    return commands
+''' % {'regs': '\n'.join(reg_rows), 'fields': '\n'.join(field_rows)}
+
+
+def main():
+    parser = argparse.ArgumentParser(description='生成 PCap04 寄存器字段索引')
+    parser.add_argument('--check', action='store_true', help='只检查生成文件是否为最新')
+    args = parser.parse_args()
+
+    registers, fields = parse_definitions(DEF_C)
+    outputs = {
+        OUT_H: gen_header(registers, fields),
+        OUT_C: gen_source(registers, fields),
+        OUT_PY: gen_python(registers, fields),
+    }
+
+    stale = []
+    for path, content in outputs.items():
+        old = path.read_text(encoding='utf-8') if path.exists() else None
+        if old == content:
+            continue
+        stale.append(path)
+        if not args.check:
+            path.write_text(content, encoding='utf-8', newline='\n')
+
+    for path in stale:
+        print('%s %s' % ('stale' if args.check else 'wrote', path.relative_to(ROOT)))
+    print('%d registers, %d fields' % (len(registers), len(fields)))
+    return 1 if (args.check and stale) else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,119 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+厂商批量接口读取工具（libusb，经 pyusb）
+对接口2选择备用设置1后，固件把二进制帧（SET_FORMAT:binary）从 EP 0x84 发出，
+不再经过虚拟串口驱动；本工具读取该端点并用 FrameDecoder 解码、校验CRC
+
+命令（START、SET_FORMAT:binary、NORMAL_MODE 等）仍经虚拟串口发送：
+给出 --port 时本工具代为发送，否则由GUI或串口终端发送
+
+用法：python vendor_bulk_reader.py --port /dev/ttyACM0 --seconds 10 --dump frames.bin
+依赖：pip install pyusb（另需 libusb 运行库）
+  Linux：udev 规则 SUBSYSTEM=="usb", ATTRS{idVendor}=="0483", ATTRS{idProduct}=="5740", MODE="0666"
+  Windows：用 Zadig 为 "PCap04 Frame Stream"（接口2）安装 WinUSB 驱动，接口0/1 保持 usbser
+"""
+
+import argparse
+import os
+import sys
+import time
+
+import usb.core
+import usb.util
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..'))
+from communication.frame_decoder import FrameDecoder  # noqa: E402
+
+USB_VID = 0x0483
+USB_PID = 0x5740
+VENDOR_INTERFACE = 2
+VENDOR_ALT_STREAM = 1
+VENDOR_IN_EP = 0x84
+READ_CHUNK = 16384
+
+
+def send_commands(port, commands):
+    """经虚拟串口发送命令并打印回复"""
+    import serial
+
+    with serial.Serial(port, 115200, timeout=0.3) as ser:
+        for cmd in commands:
+            ser.write((cmd + '\r\n').encode('ascii'))
+            time.sleep(0.1)
+            reply = ser.read(4096).decode('utf-8', errors='ignore').strip()
+            print("%s -> %s" % (cmd, reply.splitlines()[0] if reply else '(no reply)'))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Read binary matrix frames from the vendor bulk interface')
+    parser.add_argument('--port', help='虚拟串口名（可选），用于发送 START/SET_FORMAT:binary/STOP')
+    parser.add_argument('--mode', default='FAST_MODE', help='开始传输的命令（FAST_MODE 或 NORMAL_MODE）')
+    parser.add_argument('--seconds', type=float, default=10.0, help='读取时长（秒）')
+    parser.add_argument('--dump', help='把原始字节流写入文件')
+    args = parser.parse_args()
+
+    dev = usb.core.find(idVendor=USB_VID, idProduct=USB_PID)
+    if dev is None:
+        print("device %04x:%04x not found" % (USB_VID, USB_PID))
+        return 1
+
+    # 接口0/1 由CDC驱动占用，只认领厂商接口
+    if sys.platform.startswith('linux') and dev.is_kernel_driver_active(VENDOR_INTERFACE):
+        dev.detach_kernel_driver(VENDOR_INTERFACE)
+    usb.util.claim_interface(dev, VENDOR_INTERFACE)
+    dev.set_interface_altsetting(interface=VENDOR_INTERFACE, alternate_setting=VENDOR_ALT_STREAM)
+
+    if args.port:
+        send_commands(args.port, ['START', 'SET_FORMAT:binary', args.mode])
+
+    decoder = FrameDecoder()
+    dump = open(args.dump, 'wb') if args.dump else None
+    total_bytes = 0
+    frames = 0
+    last_seq = None
+    seq_gaps = 0
+    start = time.perf_counter()
+    report = start + 1.0
+    try:
+        while time.perf_counter() - start < args.seconds:
+            try:
+                data = dev.read(VENDOR_IN_EP, READ_CHUNK, timeout=200)
+            except usb.core.USBTimeoutError:
+                data = b''
+            if data:
+                data = bytes(data)
+                total_bytes += len(data)
+                if dump:
+                    dump.write(data)
+                _, decoded = decoder.feed(data)
+                for frame in decoded:
+                    if last_seq is not None and frame.seq != (last_seq + 1) & 0xFFFFFFFF:
+                        seq_gaps += 1
+                    last_seq = frame.seq
+                frames += len(decoded)
+
+            now = time.perf_counter()
+            if now >= report:
+                elapsed = now - start
+                print("%.1f s: %d frames (%.1f fps), %.1f KB/s, bad CRC %d, seq gaps %d, unsynced delta %d"
+                      % (elapsed, frames, frames / elapsed, total_bytes / elapsed / 1024.0,
+                         decoder.frames_bad, seq_gaps, decoder.frames_unsynced))
+                report = now + 1.0
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if args.port:
+            send_commands(args.port, ['STOP'])
+        # 回到备用设置0：之后的二进制帧重新走虚拟串口
+        dev.set_interface_altsetting(interface=VENDOR_INTERFACE, alternate_setting=0)
+        usb.util.release_interface(dev, VENDOR_INTERFACE)
+        usb.util.dispose_resources(dev)
+        if dump:
+            dump.close()
+
+    return 1 if decoder.frames_bad else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,78 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    boot_seq.h
+  * @brief   PCap04 Status-Polled Boot Sequencer Header
+  *
+  * 上电时 PCap04 的 POR/INIT/NV_RECALL/固件/配置/INIT 各阶段改为轮询就绪，
+  * 不再使用固定延时；USB 枚举在此期间由中断并行完成。
+  * NVRAM 中已是当前镜像（CRC一致）时跳过固件/配置下载。
+  * 每阶段耗时由 BOOT_STATS 命令查询。
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __BOOT_SEQ_H
+#define __BOOT_SEQ_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "pcap04_image.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define BOOT_POLL_INTERVAL_US     50      /* 两次就绪查询之间的间隔 */
+#define BOOT_POR_TIMEOUT_US       100000  /* POR 后等待接口响应 TEST_READ 的最长时间 */
+#define BOOT_STEP_TIMEOUT_US      10000   /* INIT/写固件/写配置后等待接口响应的最长时间 */
+#define BOOT_RUN_TIMEOUT_US       20000   /* 第二次INIT后等待 STATUS_0 RUNBIT 的最长时间 */
+#define BOOT_TEST_READ_VALUE      0x11    /* TEST_READ 的正常应答 */
+
+/* Exported types ------------------------------------------------------------*/
+/* 上电阶段 */
+typedef enum {
+  BOOT_STAGE_POR = 0,       /* POR，等待接口响应 TEST_READ */
+  BOOT_STAGE_INIT,          /* INIT */
+  BOOT_STAGE_RECALL,        /* NV_RECALL，读回校验CRC */
+  BOOT_STAGE_FIRMWARE,      /* 写入固件（NVRAM校验通过时跳过） */
+  BOOT_STAGE_CONFIG,        /* 写入配置（NVRAM校验通过时跳过） */
+  BOOT_STAGE_RUN,           /* 再次INIT，等待 RUNBIT（DSP开始运行） */
+  BOOT_STAGE_COUNT
+} BootStage_t;
+
+/* 单个阶段的统计 */
+typedef struct {
+  uint32_t us;              /* 阶段耗时（含SPI传输和轮询） */
+  uint16_t polls;           /* 就绪查询次数 */
+  uint8_t timeout;          /* 1=超时未就绪（仍继续后续阶段） */
+  uint8_t skipped;          /* 1=未执行 */
+} BootStage_Stats_t;
+
+/* 上电统计（时刻均为 HAL_GetTick，即复位后的毫秒数） */
+typedef struct {
+  BootStage_Stats_t stage[BOOT_STAGE_COUNT];
+  uint32_t sensor_start_ms;  /* 开始上电序列 */
+  uint32_t sensor_ready_ms;  /* 上电序列完成 */
+  uint32_t main_loop_ms;     /* 进入主循环 */
+  uint32_t usb_config_ms;    /* USB枚举完成（主机设置配置），0=尚未完成 */
+  uint8_t test_read;         /* 最后一次 TEST_READ 应答 */
+  uint8_t status0;           /* 最后一次读取的 STATUS_0 */
+  PCap04_Image_Source_t image_source;  /* 镜像来源：NVRAM 或下载 */
+  uint32_t image_crc;        /* MCU 内镜像的 CRC-32 */
+  uint32_t recall_crc;       /* NV_RECALL 后读回的 CRC-32 */
+} Boot_Stats_t;
+
+/* Exported functions prototypes ---------------------------------------------*/
+void Boot_Seq_Run(void);                  /* 先调用 PCap04_Image_Init() 登记镜像 */
+void Boot_Seq_Main_Loop(void);            /* 记录进入主循环的时刻 */
+uint8_t Boot_Seq_Usb_Ready(void);         /* 主循环中调用：USB首次枚举完成时返回1（只返回一次） */
+void Boot_Seq_Get_Stats(Boot_Stats_t *stats);
+const char *Boot_Stage_Name(BootStage_t stage);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BOOT_SEQ_H */
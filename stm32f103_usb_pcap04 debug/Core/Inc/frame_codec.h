@@ -0,0 +1,105 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    frame_codec.h
+  * @brief   Binary Matrix Frame Encoder (COBS Framing + CRC-32) Header
+  *
+  * 二进制帧（SET_FORMAT:BINARY）在线路上的形式：
+  *   0x00 | COBS( 帧头 | 数据 | CRC-32 ) | 0x00
+  * COBS编码后帧内不含0x00，0x00只作为帧分隔符，主机可在任意字节处重新同步；
+  * 与文本响应（均不含0x00）混在同一CDC通道中也能区分。
+  *
+  * 帧头（小端，FRAME_CODEC_HEADER_SIZE 字节）：
+  *   [0..1]   magic        0x5AA5（线路上为 A5 5A）
+  *   [2]      version      FRAME_CODEC_VERSION
+  *   [3]      flags        bit0 = 量化值，bit1 = 位打包（见 value_bits），bit2 = 帧间差分
+  *   [4..7]   seq          帧序号
+  *   [8..11]  timestamp_us 帧开始扫描的时间（微秒，32位回绕）
+  *   [12]     rows
+  *   [13]     cols
+  *   [14]     value_bits   每个值的位数：原始值32，量化值 0-255 为8、0-1023 为10
+  *   [15]     reserved     0
+  *   [16..17] payload_len  rows x cols x value_bits / 8（1024 / 256 / 320）
+  *   [18..21] end_us       帧最后一点读取完成的时间（微秒，与 timestamp_us 同一时基）
+  * 数据按行优先排列：32/8位每个值按字节小端；
+  * 10位为位打包（flags.bit1），第 i 个值占小端位流的 [10i, 10i+10) 位，
+  * 即每4个值5字节：v0 | v1<<10 | v2<<20 | v3<<30（40位小端）；
+  * CRC-32（IEEE 802.3，反射，初值/结果异或 0xFFFFFFFF）覆盖帧头和数据，小端。
+  *
+  * 差分帧（SET_DELTA:<n>，flags.bit2）：数据 = base_seq(u32) + 按行优先的差分记号，
+  *   非0差分 d           : varint(zigzag(d))，d = 本帧值 - 参考帧值（32位回绕）
+  *   连续k个0差分        : 0x00 + varint(k)
+  * 参考帧为上一个完整发出的帧（seq = base_seq），主机持有的帧序号不同时需等待关键帧。
+  * 每 n 帧、KEYFRAME 命令、输出模式改变或差分不比完整帧短时发送关键帧（普通完整帧）。
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __FRAME_CODEC_H
+#define __FRAME_CODEC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "matrix_scan.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define FRAME_CODEC_MAGIC           0x5AA5
+#define FRAME_CODEC_VERSION         3
+#define FRAME_CODEC_HEADER_SIZE     22
+#define FRAME_CODEC_CRC_SIZE        4
+#define FRAME_CODEC_FLAG_QUANT      0x01
+#define FRAME_CODEC_FLAG_PACKED     0x02  /* 值按 value_bits 位打包（不按字节对齐） */
+#define FRAME_CODEC_FLAG_DELTA      0x04  /* 帧间差分：数据为 base_seq + 差分记号 */
+#define FRAME_CODEC_KEY_INTERVAL_MAX 1000 /* 关键帧间隔上限（帧） */
+#define FRAME_CODEC_BLOCK_MAX       255   /* 一个COBS块：1字节长度码 + 最多254字节数据 */
+
+/* Exported types ------------------------------------------------------------*/
+/* 编码器状态：按需从帧缓冲区取值，分多次写入发送缓冲区 */
+typedef struct {
+  const MatrixData_t *frame;
+  uint8_t header[FRAME_CODEC_HEADER_SIZE];
+  uint8_t bits;             /* 每个值的位数：32 / 8 / 10 */
+  uint8_t quant;            /* 取值时是否量化（Begin时锁存） */
+  uint8_t delta;            /* 本帧为差分帧 */
+  uint8_t track;            /* 差分模式：发送的同时更新参考帧 */
+  uint32_t q_min;           /* Begin时锁存的量化范围 */
+  uint32_t q_max;
+  uint8_t stage;            /* 起始分隔符 / COBS数据块 / 结束分隔符 / 完成 */
+  uint16_t total;           /* 帧头 + 数据 + CRC 字节数 */
+  uint16_t pos;             /* 下一个待编码字节（pos == total 为COBS末尾的隐含0） */
+  uint16_t value_index;     /* 缓存值的序号（10位打包时为4值一组的组号） */
+  uint32_t value;           /* 缓存值（10位打包时为一组40位的低32位） */
+  uint8_t value_hi;         /* 10位打包时一组的第5字节 */
+  uint16_t cell;            /* 差分帧：下一个待编码的单元 */
+  uint8_t pend[5];          /* 差分帧：base_seq 或当前记号的字节 */
+  uint8_t pend_len;
+  uint8_t pend_pos;
+  uint32_t crc;
+} FrameCodec_t;
+
+/* 编码统计 */
+typedef struct {
+  uint32_t key_frames;      /* 已发出的完整帧（含差分模式下的关键帧） */
+  uint32_t delta_frames;    /* 已发出的差分帧 */
+  uint16_t last_payload;    /* 最近一帧的数据字节数（不含帧头/CRC/COBS） */
+} FrameCodec_Stats_t;
+
+/* Exported functions prototypes ---------------------------------------------*/
+void Frame_Codec_Begin(FrameCodec_t *codec, const MatrixData_t *frame);
+uint16_t Frame_Codec_Encode(FrameCodec_t *codec, uint8_t *out, uint16_t space);  /* 写入尽可能多的完整COBS块，返回字节数 */
+uint8_t Frame_Codec_Done(const FrameCodec_t *codec);
+void Frame_Codec_Set_Delta(uint16_t key_interval);   /* 差分模式：每 key_interval 帧一个关键帧，0=关闭 */
+uint16_t Frame_Codec_Get_Delta(void);
+void Frame_Codec_Request_Keyframe(void);              /* 下一帧强制发送关键帧（主机重新同步） */
+void Frame_Codec_Get_Stats(FrameCodec_Stats_t *stats);
+uint32_t Frame_Codec_Crc32(uint32_t crc, const uint8_t *data, uint32_t len);      /* 增量计算，初值0 */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FRAME_CODEC_H */
@@ -0,0 +1,56 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    frame_sched.h
+  * @brief   TIM2-Driven Deterministic Frame Scheduler Header
+  *
+  * NORMAL 模式下由 TIM2 更新中断按固定周期启动每一帧扫描，
+  * 周期分辨率为微秒级，与主循环中发送/格式化的耗时无关。
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __FRAME_SCHED_H
+#define __FRAME_SCHED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define FRAME_SCHED_MIN_PERIOD_US   100U          /* 最小帧周期（微秒） */
+#define FRAME_SCHED_MAX_PERIOD_US   10000000U     /* 最大帧周期（10秒） */
+
+/* Exported types ------------------------------------------------------------*/
+/* 调度统计（抖动 = 实际帧起始间隔与设定周期之差的绝对值） */
+typedef struct {
+  uint32_t period_us;       /* 设定周期 */
+  uint32_t tick_us;         /* 定时器计数分辨率 */
+  uint32_t frames_started;  /* 按时启动的帧数 */
+  uint32_t overruns;        /* 周期到达时上一帧仍在扫描（或无空闲缓冲区）而跳过的次数 */
+  uint32_t last_jitter_us;  /* 最近一次起始抖动 */
+  uint32_t max_jitter_us;   /* 最大起始抖动 */
+  uint32_t mean_jitter_us;  /* 平均起始抖动 */
+  uint32_t min_interval_us; /* 最小实际起始间隔 */
+  uint32_t max_interval_us; /* 最大实际起始间隔 */
+} FrameSched_Stats_t;
+
+/* Exported functions prototypes ---------------------------------------------*/
+void Frame_Sched_Init(void);
+void Frame_Sched_Start(uint32_t period_us);   /* 以新周期（重新）启动，立即开始第一帧 */
+void Frame_Sched_Stop(void);
+void Frame_Sched_Hold(void);                  /* 暂缓帧起始中断（主循环执行命令期间） */
+void Frame_Sched_Release(void);
+uint8_t Frame_Sched_Running(void);
+uint32_t Frame_Sched_Period_Us(void);
+void Frame_Sched_Get_Stats(FrameSched_Stats_t *stats);
+void Frame_Sched_Reset_Stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FRAME_SCHED_H */
@@ -0,0 +1,98 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    frame_stream.h
+  * @brief   Ping-Pong Frame Buffers and Non-Blocking USB Frame Transmission
+  *
+  * 多个 MatrixData_t 缓冲区在扫描端和发送端之间交接所有权：
+  *   FREE -> SCANNING（扫描引擎填充）-> READY（等待发送）-> SENDING（USB逐行发送）-> FREE
+  * 扫描下一帧与发送上一帧同时进行，每帧耗时约为 max(扫描时间, 发送时间)。
+  *
+  * 主机读取跟不上时的背压策略（FrameStreamPolicy_t）：
+  *   BLOCK       : 没有空闲缓冲区时扫描等待（扫描节奏受主机影响）
+  *   DROP_OLDEST : 提交新帧后若无空闲缓冲区，丢弃最旧的待发送帧（默认）
+  *   DROP_NEWEST : 提交新帧后若无空闲缓冲区，丢弃刚提交的帧
+  * 丢弃策略下提交后总留有一个空闲缓冲区，扫描节奏与USB无关；丢弃以整帧为单位，
+  * 正在发送的帧不会被打断。
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __FRAME_STREAM_H
+#define __FRAME_STREAM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "matrix_scan.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define FRAME_STREAM_BUFFERS    3     /* 帧缓冲区个数：发送中 + 待发送 + 扫描中 */
+#define FRAME_STREAM_HISTORY    3     /* 额外保留的已发送帧（GET_FRAME重发），每帧约1KB，受20KB RAM限制 */
+#define FRAME_STREAM_POOL       (FRAME_STREAM_BUFFERS + FRAME_STREAM_HISTORY)
+#define FRAME_STREAM_TX_SIZE    256   /* 单次USB发送缓冲区大小（可容纳表格格式一整行，4包，双缓冲端点连续发送） */
+#define FRAME_STREAM_BENCH_MAX_KB 4096 /* BENCH 单次最多发送的数据量（KB） */
+#define FRAME_STREAM_REPLY_SIZE 1024  /* 命令回复队列缓冲区大小（需放得下整条STATUS回复） */
+#define FRAME_STREAM_REPLY_SLOTS 16   /* 命令回复队列最多排队的回复条数 */
+
+/* Exported types ------------------------------------------------------------*/
+/* 帧缓冲区状态 */
+typedef enum {
+  FRAME_FREE = 0,           /* 空闲 */
+  FRAME_SCANNING,           /* 扫描端持有 */
+  FRAME_READY,              /* 扫描完成，等待发送 */
+  FRAME_SENDING,            /* 发送端持有 */
+  FRAME_SENT,               /* 已发送，留作历史帧，没有空闲缓冲区时按序号从旧到新回收 */
+  FRAME_RESEND              /* 主机请求重发（GET_FRAME），优先于就绪帧发送，期间不回收 */
+} FrameState_t;
+
+/* 背压策略 */
+typedef enum {
+  FRAME_POLICY_BLOCK = 0,   /* 扫描等待空闲缓冲区 */
+  FRAME_POLICY_DROP_OLDEST, /* 丢弃最旧的待发送帧 */
+  FRAME_POLICY_DROP_NEWEST  /* 丢弃刚扫描完成的帧 */
+} FrameStreamPolicy_t;
+
+/* 帧流统计 */
+typedef struct {
+  uint32_t frames_scanned;  /* 已提交的帧数 */
+  uint32_t frames_sent;     /* 已完整发送的帧数 */
+  uint32_t scan_stalls;     /* 扫描端因无空闲缓冲区而等待的次数 */
+  uint32_t frames_dropped;  /* 因背压丢弃的整帧数 */
+  uint32_t last_sent_seq;   /* 最后发送完成的帧序号 */
+  uint32_t frames_resent;   /* 按 GET_FRAME 重发的帧数 */
+  uint32_t replies_dropped; /* 回复队列已满而丢弃的命令回复数 */
+} FrameStream_Stats_t;
+
+/* Exported functions prototypes ---------------------------------------------*/
+void Frame_Stream_Init(void);
+void Frame_Stream_Reset(void);                    /* 丢弃所有待发送帧（会话结束） */
+void Frame_Stream_Set_Policy(FrameStreamPolicy_t policy);
+FrameStreamPolicy_t Frame_Stream_Get_Policy(void);
+const char *Frame_Stream_Policy_Name(FrameStreamPolicy_t policy);
+
+/* 扫描端 */
+uint32_t Frame_Stream_Alloc_Seq(void);            /* 分配帧序号（Acquire内部使用） */
+MatrixData_t *Frame_Stream_Acquire(void);         /* 取得空闲缓冲区并分配帧序号，无空闲返回NULL */
+void Frame_Stream_Commit(MatrixData_t *frame);    /* 整帧扫描完成，交给发送端 */
+void Frame_Stream_Release(MatrixData_t *frame);   /* 放弃该帧（不发送） */
+
+/* 发送端 */
+void Frame_Stream_Tx_Task(void);                  /* USB空闲时发送下一批数据行（非阻塞） */
+uint8_t Frame_Stream_Idle(void);                  /* 没有待发送或正在发送的帧（含吞吐量测试、重发和命令回复） */
+uint8_t Frame_Stream_Request_Resend(uint32_t seq); /* 重发历史帧，不在历史中返回0（可在USB中断中调用） */
+uint8_t Frame_Stream_Send_Reply(const uint8_t *data, uint16_t len);  /* 命令回复排队，由发送任务插入帧之间（不等待），队列满返回0 */
+uint8_t Frame_Stream_History_Range(uint32_t *oldest, uint32_t *newest);  /* 可重发的序号范围，返回历史帧个数 */
+void Frame_Stream_Bench_Start(uint32_t bytes);    /* 吞吐量测试：以最快速度发送 bytes 字节测试图样（64的倍数） */
+uint8_t Frame_Stream_Bench_Active(void);
+
+void Frame_Stream_Get_Stats(FrameStream_Stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FRAME_STREAM_H */
@@ -109,6 +109,18 @@ void Error_Handler(void);
   #define PCAP04_COMM_MODE_SPI  1
 #endif
 
+/******************************************************************************/
+/* PCap04 INTN 转换完成中断引脚                                               */
+/******************************************************************************/
+/*
+ * 标准配置中 Register 30 的 PG5_INTN_EN = 1，INTN 输出在 PCap04 的 PG5 引脚。
+ * INTN 低电平有效：下降沿表示 RES0-RES7 有新结果，SSN 上升沿将其复位为高电平。
+ * PG5 接到下面定义的 MCU 引脚（下降沿 EXTI）；硬件不同时修改这里即可。
+ */
+#define PCAP04_INTN_Pin         GPIO_PIN_1
+#define PCAP04_INTN_GPIO_Port   GPIOA
+#define PCAP04_INTN_EXTI_IRQn   EXTI1_IRQn
+
 /* USER CODE END Private defines */
 
 #ifdef __cplusplus
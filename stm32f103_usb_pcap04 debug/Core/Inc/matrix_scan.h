@@ -23,17 +23,25 @@ extern "C" {
 /* Exported types ------------------------------------------------------------*/
 typedef struct {
   uint32_t capacitance[MATRIX_SIZE][MATRIX_SIZE];  /* 16x16电容值矩阵 */
+  uint32_t seq;                                     /* 帧序号（帧缓冲区分配时递增） */
+  uint32_t timestamp_us;                            /* 帧开始扫描的时间（微秒） */
+  uint32_t end_us;                                  /* 帧最后一点读取完成的时间（微秒） */
 } MatrixData_t;
 
 /* 量化函数 */
 uint32_t Quantize_Value(uint32_t raw_value, uint32_t min_val, uint32_t max_val, uint16_t level);
+uint32_t Matrix_Output_Value(uint32_t raw_value);  /* 按当前输出模式返回原始值或量化值 */
 
 /* Exported functions prototypes ---------------------------------------------*/
 void Matrix_Scan_Init(void);
 void Matrix_Scan_All(MatrixData_t *matrix);
 uint32_t Matrix_Scan_Point(uint8_t row, uint8_t col);
-void Matrix_Output_USB(MatrixData_t *matrix);
-void Matrix_Scan_And_Stream(MatrixData_t *matrix);  /* 流式扫描并传输：扫描一个点立即发送一个点 */
+
+/* 乒乓缓冲流水线：扫描当前帧的同时由 frame_stream 发送上一帧（均为非阻塞） */
+uint8_t Matrix_Stream_Start(void);    /* 开始扫描新的一帧：1=已开始, 0=正在扫描或无空闲缓冲区 */
+void Matrix_Stream_Poll(void);        /* 推进扫描并运行发送任务，需在主循环中反复调用 */
+uint8_t Matrix_Stream_Scanning(void); /* 是否有帧正在扫描 */
+void Matrix_Stream_Stop(void);        /* 会话结束：丢弃待发送帧 */
 
 #ifdef __cplusplus
 }
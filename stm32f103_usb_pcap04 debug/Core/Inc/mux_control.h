@@ -7,6 +7,10 @@
   * CD74HC4067SM96 16选1多路复用器控制
   * 列选16选1: SY0-SY3 (PA3,PA4,PA6,PA7), ENX (PA5) - 用户说ENX在PA5
   * 行选16选1: SX0-SX3 (PB1,PB0,PB10,PB2), ENY (PB11) - 用户说ENY在PB11
+  *
+  * 每个通道预先计算一个BSRR字（选择线置位/复位 + 使能拉低），
+  * 切换行或列只需一次寄存器写入，4根选择线与使能同时翻转。
+  * 列选引脚全部在GPIOA，行选引脚全部在GPIOB；表格也可作为DMA源直接写入 BSRR。
   ******************************************************************************
   */
 
@@ -24,6 +28,15 @@ extern "C" {
 /* Exported constants --------------------------------------------------------*/
 #define MUX_CHANNELS 16
 
+#define MUX_COL_PORT            GPIOA                 /* SY0-SY3 与列使能(PA5)所在端口 */
+#define MUX_ROW_PORT            GPIOB                 /* SX0-SX3 与行使能(PB11)所在端口 */
+#define MUX_COL_DISABLE_BSRR    ((uint32_t)ENY_Pin)   /* 写入 MUX_COL_PORT->BSRR 禁用列选 */
+#define MUX_ROW_DISABLE_BSRR    ((uint32_t)ENX_Pin)   /* 写入 MUX_ROW_PORT->BSRR 禁用行选 */
+
+/* Exported variables --------------------------------------------------------*/
+extern const uint32_t MUX_Col_BSRR[MUX_CHANNELS];     /* 列通道 -> GPIOA BSRR字（含使能） */
+extern const uint32_t MUX_Row_BSRR[MUX_CHANNELS];     /* 行通道 -> GPIOB BSRR字（含使能） */
+
 /* Exported functions prototypes ---------------------------------------------*/
 void MUX_Init(void);
 void MUX_Select_Column(uint8_t channel);  /* 列选16选1: 选择列 (0-15) */
@@ -31,6 +44,19 @@ void MUX_Select_Row(uint8_t channel);     /* 行选16选1: 选择行 (0-15) */
 void MUX_Disable_Column(void);            /* 禁用列选 */
 void MUX_Disable_Row(void);               /* 禁用行选 */
 
+/* 快速接口：不做范围检查（通道取低4位），供扫描关键路径使用 */
+__STATIC_INLINE void MUX_Fast_Select(uint8_t row, uint8_t col)
+{
+  MUX_ROW_PORT->BSRR = MUX_Row_BSRR[row & 0x0F];
+  MUX_COL_PORT->BSRR = MUX_Col_BSRR[col & 0x0F];
+}
+
+__STATIC_INLINE void MUX_Fast_Disable(void)
+{
+  MUX_ROW_PORT->BSRR = MUX_ROW_DISABLE_BSRR;
+  MUX_COL_PORT->BSRR = MUX_COL_DISABLE_BSRR;
+}
+
 #ifdef __cplusplus
 }
 #endif
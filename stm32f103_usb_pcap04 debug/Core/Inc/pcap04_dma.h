@@ -0,0 +1,88 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    pcap04_dma.h
+  * @brief   PCap04 SPI2 + DMA1 Asynchronous Transaction Engine Header
+  *
+  * 每个事务由一个描述符表示，按 "操作码 -> 地址 -> 数据" 的顺序链式发送：
+  *   1. 头部阶段：发送 header[0..header_len-1]（操作码 + 可选地址）
+  *   2. 数据阶段：发送 tx_data（写）或全双工读取到 rx_data（读）
+  *   3. 完成后在中断上下文中调用描述符的回调函数，并自动启动下一个描述符
+  *
+  * DMA映射（STM32F103）：SPI2_RX = DMA1_Channel4, SPI2_TX = DMA1_Channel5
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PCAP04_DMA_H
+#define __PCAP04_DMA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "spi.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define PCAP04_DMA_QUEUE_SIZE   8     /* 事务队列深度（环形队列，实际可用 N-1 个） */
+#define PCAP04_DMA_MAX_READ     64    /* 单次读取最大字节数（受哑元发送缓冲区限制） */
+#define PCAP04_DMA_TIMEOUT_MS   10    /* 阻塞包装函数的默认超时 */
+#define PCAP04_SSN_SETUP_US     2     /* SSN拉低到第一个时钟的最小间隔（数据手册 min. 1.7us） */
+
+/* 数据阶段方向 */
+#define PCAP04_XFER_NONE        0     /* 只有头部（如 CDC_START） */
+#define PCAP04_XFER_TX          1     /* 头部 + 写数据 */
+#define PCAP04_XFER_RX          2     /* 头部 + 读数据（全双工，tx_data 为空时发送0x00） */
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct PCap04_Xfer PCap04_Xfer_t;
+
+/* 完成回调：在DMA中断上下文中调用，xfer 指针只在回调期间有效 */
+typedef void (*PCap04_Xfer_Callback_t)(const PCap04_Xfer_t *xfer);
+
+struct PCap04_Xfer {
+  uint8_t header[2];                 /* header[0]=操作码, header[1]=地址 */
+  uint8_t header_len;                /* 0, 1 或 2 */
+  uint8_t dir;                       /* PCAP04_XFER_NONE / TX / RX */
+  uint8_t ssn_release;               /* 1=完成后拉高SSN（复位INTN，异步读模式下允许结果更新） */
+  const uint8_t *tx_data;            /* 写数据（调用方保证在完成前有效） */
+  uint8_t *rx_data;                  /* 读缓冲区（调用方保证在完成前有效） */
+  uint16_t length;                   /* 数据阶段字节数 */
+  PCap04_Xfer_Callback_t callback;   /* 完成回调，可为NULL */
+  void *context;                     /* 回调用户参数 */
+  HAL_StatusTypeDef status;          /* 完成状态：HAL_BUSY=进行中, HAL_OK, HAL_ERROR */
+};
+
+/* 引擎统计信息 */
+typedef struct {
+  uint32_t submitted;                /* 已提交事务数 */
+  uint32_t completed;                /* 已完成事务数（含失败） */
+  uint32_t errors;                   /* 失败事务数 */
+  uint32_t queue_full;               /* 队列满而被拒绝的次数 */
+} PCap04_DMA_Stats_t;
+
+/* Exported functions prototypes ---------------------------------------------*/
+void PCap04_DMA_Init(void);
+
+/* 异步接口：入队后立即返回，完成时调用回调 */
+HAL_StatusTypeDef PCap04_DMA_Submit(const PCap04_Xfer_t *xfer);
+HAL_StatusTypeDef PCap04_DMA_Queue_Opcode(uint8_t opcode, PCap04_Xfer_Callback_t callback, void *context);
+HAL_StatusTypeDef PCap04_DMA_Queue_Read(uint8_t rd_opcode, uint8_t address, uint8_t *rx_data, uint16_t length,
+                                        PCap04_Xfer_Callback_t callback, void *context);
+HAL_StatusTypeDef PCap04_DMA_Queue_Write(uint8_t wr_opcode, uint8_t address, const uint8_t *tx_data, uint16_t length,
+                                         PCap04_Xfer_Callback_t callback, void *context);
+
+/* 同步接口：入队并等待该事务完成（可在中断上下文中调用，此时使用轮询方式推进DMA） */
+HAL_StatusTypeDef PCap04_DMA_Transfer(const PCap04_Xfer_t *xfer, uint32_t timeout_ms);
+HAL_StatusTypeDef PCap04_DMA_Wait_Idle(uint32_t timeout_ms);
+
+uint8_t PCap04_DMA_Is_Busy(void);
+void PCap04_DMA_Get_Stats(PCap04_DMA_Stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PCAP04_DMA_H */
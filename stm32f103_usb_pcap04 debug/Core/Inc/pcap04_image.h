@@ -0,0 +1,60 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    pcap04_image.h
+  * @brief   PCap04 Firmware/Config Image and NVRAM Persistence Header
+  *
+  * 固件（存储器 0x000 起）和配置（0x3C0 起）合称"镜像"，CRC-32 在 PCap04_Image_Init()
+  * 中对 MCU 内的副本计算一次；上电时先 NV_RECALL，读回 SRAM 校验 CRC 一致则不再下载。
+  * PCAP04_PERSIST 命令把当前镜像写入 PCap04 的 NVRAM；PCAP04_UPLOAD 重新上传并逐字节读回比较。
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PCAP04_IMAGE_H
+#define __PCAP04_IMAGE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Exported types ------------------------------------------------------------*/
+/* 镜像来源（上电时） */
+typedef enum {
+  PCAP04_IMAGE_NONE = 0,      /* 尚未加载 */
+  PCAP04_IMAGE_NVRAM,         /* NV_RECALL 后CRC校验通过，未下载 */
+  PCAP04_IMAGE_DOWNLOAD       /* SPI下载 */
+} PCap04_Image_Source_t;
+
+/* 上传统计（PCap04_Image_Upload） */
+typedef struct {
+  uint16_t bytes;           /* 固件 + 配置字节数 */
+  uint32_t write_us;        /* 写入耗时（两次DMA突发） */
+  uint32_t verify_us;       /* 读回比较耗时 */
+  uint16_t mismatches;      /* 读回不一致的字节数 */
+  uint16_t first_addr;      /* 第一个不一致字节的存储器地址（mismatches > 0 时有效） */
+  uint8_t expected;         /* 该地址镜像中的值 */
+  uint8_t actual;           /* 该地址读回的值 */
+} PCap04_Upload_Stats_t;
+
+/* Exported functions prototypes ---------------------------------------------*/
+void PCap04_Image_Init(const uint8_t *fw, uint16_t fw_len, const uint8_t *cfg, uint8_t cfg_len);
+uint32_t PCap04_Image_Crc(void);                    /* MCU 内镜像的 CRC-32 */
+uint32_t PCap04_Image_Last_Read_Crc(void);          /* 最近一次从芯片读回的 CRC-32 */
+HAL_StatusTypeDef PCap04_Image_Write_Firmware(void);  /* WR_MEM 固件（地址0起） */
+HAL_StatusTypeDef PCap04_Image_Write_Config(void);    /* WR_CONFIG 配置（0x3C0起） */
+HAL_StatusTypeDef PCap04_Image_Download(void);      /* 固件 + 配置 */
+HAL_StatusTypeDef PCap04_Image_Upload(PCap04_Upload_Stats_t *stats);  /* 下载 + 逐字节读回比较 + INIT */
+HAL_StatusTypeDef PCap04_Image_Read_Crc(uint32_t *crc);  /* 读回芯片SRAM中的镜像并计算 CRC-32 */
+HAL_StatusTypeDef PCap04_Image_Verify(void);        /* 读回CRC与镜像一致返回 HAL_OK */
+HAL_StatusTypeDef PCap04_Image_Recall(void);        /* NV_RECALL：NVRAM -> SRAM */
+HAL_StatusTypeDef PCap04_Image_Persist(void);       /* 镜像写入 NVRAM 并回读校验（阻塞约100ms） */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PCAP04_IMAGE_H */
@@ -56,6 +56,56 @@ extern "C" {
 #define RD_CONFIG     0x23
 #define RD_RESULT     0x40
 
+/* 存储器访问：10位地址，高两位放在操作码低两位（WR_CONFIG/RD_CONFIG 即地址高位为11的 WR_MEM/RD_MEM） */
+#define PCAP04_WR_MEM_CMD(addr)       ((uint8_t)(WR_MEM | (((addr) >> 8) & 0x03)))
+#define PCAP04_RD_MEM_CMD(addr)       ((uint8_t)(RD_MEM | (((addr) >> 8) & 0x03)))
+#define PCAP04_MEM_SIZE               1024   /* 固件+配置 SRAM */
+#define PCAP04_CFG_MEM_BASE           0x3C0  /* 配置寄存器0的存储器地址 */
+#define PCAP04_CFG_SIZE               64     /* 配置寄存器 0-63（0x3C0-0x3FF） */
+#define PCAP04_CFG_ADDR(reg)          ((uint8_t)((PCAP04_CFG_MEM_BASE & 0xFF) + (reg)))  /* WR_CONFIG/RD_CONFIG 地址字节 */
+
+/* NVRAM：NV_STORE/NV_RECALL/NV_ERASE 之前向 MEM_CTRL 写入对应密钥 */
+#define PCAP04_MEM_CTRL_ADDR          0x3F6
+#define PCAP04_NV_KEY_STORE           0x2D
+#define PCAP04_NV_KEY_RECALL          0x59
+#define PCAP04_NV_KEY_ERASE           0xB8
+#define PCAP04_NV_ERASE_MS            50     /* 没有完成标志，按固定时间等待 */
+#define PCAP04_NV_STORE_MS            50
+
+/* 结果/状态寄存器字节地址（RD_RESULT 读取） */
+#define PCAP04_RES0_ADDR              0x00
+#define PCAP04_STATUS0_ADDR           0x20   /* 32: STATUS_0 */
+#define PCAP04_STATUS1_ADDR           0x21   /* 33: STATUS_1 */
+#define PCAP04_STATUS2_ADDR           0x22   /* 34: STATUS_2 */
+
+/* 结果突发读取：RD_RESULT 为单字节命令 0x40 | 地址<5:0>，之后地址自动递增。
+ * STATUS_0 位于 RES7 之后，一次读取 RES0..RES7 + STATUS_0..2 共35字节，
+ * 每个结果寄存器低字节在前（地址n = 位7..0）。 */
+#define PCAP04_RD_RESULT_CMD(addr)    ((uint8_t)(RD_RESULT | ((addr) & 0x3F)))
+#define PCAP04_RESULT_PORTS           6      /* RES0..RES5 对应电容端口 PC0..PC5 */
+#define PCAP04_RESULT_BURST_LEN       (PCAP04_STATUS2_ADDR + 1)
+#define PCAP04_PORT_MASK_ALL          0x3F
+
+/* STATUS_0 位定义 */
+#define PCAP04_STATUS0_RUNBIT         0x01
+#define PCAP04_STATUS0_CDC_ACTIVE     0x02   /* 1=CDC转换进行中 */
+#define PCAP04_STATUS0_RDC_READY      0x04
+#define PCAP04_STATUS0_AUTOBOOT       0x10
+#define PCAP04_STATUS0_IR_FLAG_COLL   0x20
+#define PCAP04_STATUS0_POR_FLAG_CFG   0x40
+#define PCAP04_STATUS0_POR_FLAG_WDG   0x80
+
+/* STATUS_2 位定义：C_PORTERR0..5 对应 PC0..PC5 */
+#define PCAP04_STATUS2_C_PORTERR_MASK 0x3F
+#define PCAP04_STATUS2_C_PORTERR_INT  0x40
+
+/* Exported types ------------------------------------------------------------*/
+/* 一次突发读取得到的结果和状态 */
+typedef struct {
+  uint32_t res[PCAP04_RESULT_PORTS];  /* RES0..RES5 */
+  uint8_t status[3];                  /* STATUS_0..STATUS_2 */
+} PCap04_Results_t;
+
 /* Exported functions prototypes ---------------------------------------------*/
 /* SPI 辅助函数 */
 void PCap04_Set_IIC_EN(uint8_t enable);  /* 设置 IIC_EN 引脚：1=I2C, 0=SPI */
@@ -65,15 +115,20 @@ void Set_SSN(uint8_t level);             /* 设置 SPI 片选信号（软件控
 void Write_Opcode(uint8_t one_byte);
 void Write_Opcode2(uint8_t byte1, uint8_t byte2);
 void Write_Dword(uint8_t opcode, uint8_t address, uint32_t dword);
-void Write_Dword_Auto_Incr(uint8_t opcode, uint8_t from_addr, uint32_t *dword_array, uint8_t to_addr);
+HAL_StatusTypeDef Write_Dword_Auto_Incr(uint8_t opcode, uint8_t from_addr, uint32_t *dword_array, uint8_t to_addr);  /* 最多16个双字，超出返回 HAL_ERROR */
 
 /* SPI 读操作函数 */
 uint32_t Read_Dword(uint8_t rd_opcode, uint8_t address);
 
 /* PCap04 专用函数 */
-HAL_StatusTypeDef PCap04_Memory_Access(uint8_t opcode, uint16_t address, uint8_t *byte, uint16_t size);
-HAL_StatusTypeDef PCap04_Config_Access(uint8_t opcode, uint8_t address, uint8_t *byte, uint8_t size);
+HAL_StatusTypeDef PCap04_Memory_Access(uint8_t opcode, uint16_t address, const uint8_t *byte, uint16_t size);  /* 单次DMA突发写入 */
+HAL_StatusTypeDef PCap04_Config_Access(uint8_t opcode, uint8_t address, const uint8_t *byte, uint8_t size);    /* 寄存器号 address 起 */
+HAL_StatusTypeDef PCap04_Read_Mem(uint16_t address, uint8_t *buf, uint16_t size);        /* RD_MEM 读取（10位地址） */
+HAL_StatusTypeDef PCap04_Write_Mem(uint16_t address, const uint8_t *data, uint16_t size); /* WR_MEM 写入（10位地址） */
+HAL_StatusTypeDef PCap04_NV_Command(uint8_t opcode);   /* 写入 MEM_CTRL 密钥并发送 NV_STORE/NV_RECALL/NV_ERASE */
 uint32_t PCap04_Read_Result(uint8_t rd_opcode, uint8_t address);
+HAL_StatusTypeDef PCap04_Read_Results(PCap04_Results_t *results);  /* 单次片选突发读取 RES0..5 + 状态 */
+void PCap04_Unpack_Results(const uint8_t *rx, PCap04_Results_t *results);  /* 解析35字节突发读取数据 */
 
 /* 随机数生成函数（用于模拟模式） */
 void PCap04_Random_Init(void);                    /* 初始化随机数生成器 */
@@ -0,0 +1,107 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    scan_engine.h
+  * @brief   Pipelined Matrix Scan Engine Header
+  *
+  * 流水线阶段（N为当前测量点）：
+  *   SELECT  N+1 : 切换多路复用器并等待建立时间
+  *   CONVERT N   : CDC_START 后等待转换完成
+  *   READ    N-1 : 通过DMA一次突发读取RES0..RES7和STATUS_0..2（35字节），完成中断中存入结果FIFO
+  * 点N转换完成后立即切到N+1开始建立，同时DMA读取点N的结果，
+  * 主循环在等待期间格式化/发送已完成的点。
+  *
+  * 转换完成的判定方式（ScanWaitMode_t）：
+  *   INTN   : PCap04 INTN 下降沿（EXTI）直接在中断中推进状态机（默认）
+  *   STATUS : 轮询 STATUS_0 的 CDC_ACTIVE 位（INTN未连接时的后备方式）
+  *   TIMED  : 固定等待 convert_us（模拟模式使用）
+  *
+  * 每个测量点采集端口掩码（Scan_Engine_Set_Port_Mask）中所有PCap04端口的结果，
+  * 再按端口/单元映射表（scan_layout）写入一个或多个矩阵单元；
+  * 多端口布局下每帧的测量点数为 16 x 列多路复用器位置数。
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SCAN_ENGINE_H
+#define __SCAN_ENGINE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "matrix_scan.h"
+#include "pcap04_spi.h"
+#include "scan_layout.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define SCAN_MUX_SETTLE_US      10    /* 多路复用器切换后的建立时间（微秒） */
+#define SCAN_CONVERT_TIME_US    100   /* CDC_START 到结果可读的等待时间（微秒），取决于PCap04配置 */
+#define SCAN_POINT_FIFO_SIZE    16    /* 已完成测量点FIFO深度（2的幂） */
+#define SCAN_CONVERT_TIMEOUT_US 5000  /* INTN/状态等待超时（微秒） */
+#define SCAN_INTN_FAIL_LIMIT    4     /* 连续INTN超时次数达到后自动切换为状态轮询 */
+#define SCAN_DSP_GUARD_US       10    /* CDC_ACTIVE清零后等待DSP写入结果的时间（微秒） */
+#define SCAN_PORT_MASK_DEFAULT  0x01  /* 默认只采集PC0 */
+
+/* Exported types ------------------------------------------------------------*/
+/* 流水线阶段 */
+typedef enum {
+  SCAN_STAGE_IDLE = 0,      /* 空闲 */
+  SCAN_STAGE_SETTLE,        /* 多路复用器已切换，等待建立 */
+  SCAN_STAGE_CONVERT,       /* 已发送CDC_START，等待转换完成 */
+  SCAN_STAGE_DRAIN,         /* 最后一点已发出读取，等待DMA完成 */
+  SCAN_STAGE_DONE           /* 整帧完成 */
+} ScanStage_t;
+
+/* 转换完成判定方式 */
+typedef enum {
+  SCAN_WAIT_TIMED = 0,      /* 固定等待 */
+  SCAN_WAIT_INTN = 1,       /* INTN 下降沿中断 */
+  SCAN_WAIT_STATUS = 2      /* 轮询 STATUS_0.CDC_ACTIVE */
+} ScanWaitMode_t;
+
+/* 扫描引擎统计 */
+typedef struct {
+  ScanWaitMode_t wait_mode; /* 当前判定方式 */
+  uint32_t intn_events;     /* INTN 中断次数 */
+  uint32_t intn_timeouts;   /* INTN 超时次数（该点改用状态轮询） */
+  uint32_t status_polls;    /* STATUS_0 读取次数 */
+  uint32_t status_timeouts; /* 状态轮询超时次数（超时后照常读取） */
+  uint32_t last_frame_us;   /* 上一帧扫描耗时（微秒） */
+  uint32_t port_errors;     /* 已采集端口中 STATUS_2.C_PORTERR 置位的次数 */
+} ScanEngine_Stats_t;
+
+/* 已完成的测量点 */
+typedef struct {
+  uint8_t row;
+  uint8_t col;              /* 列多路复用器位置（单端口布局下即矩阵列） */
+  uint8_t port_err;         /* STATUS_2.C_PORTERR0..5（仅已采集端口） */
+  uint8_t cell_ports;       /* 映射到矩阵单元的端口 */
+  uint32_t value;           /* 第一个映射端口的结果 */
+  uint32_t res[PCAP04_RESULT_PORTS];  /* 各端口结果，未采集的端口为0 */
+} ScanPoint_t;
+
+/* Exported functions prototypes ---------------------------------------------*/
+void Scan_Engine_Init(void);
+void Scan_Engine_Set_Timing(uint32_t settle_us, uint32_t convert_us);
+void Scan_Engine_Start(MatrixData_t *matrix);   /* 开始一帧扫描，matrix可为NULL */
+ScanStage_t Scan_Engine_Poll(void);             /* 推进状态机（非阻塞），返回当前阶段 */
+uint8_t Scan_Engine_Pop_Point(ScanPoint_t *point);  /* 取出一个已完成点：1=成功, 0=无数据 */
+uint8_t Scan_Engine_Is_Done(void);              /* 整帧已完成且FIFO已取空 */
+uint32_t Scan_Engine_Last_Frame_Us(void);       /* 上一帧扫描耗时（微秒） */
+void Scan_Engine_Set_Wait_Mode(ScanWaitMode_t mode);
+ScanWaitMode_t Scan_Engine_Get_Wait_Mode(void);
+void Scan_Engine_Get_Stats(ScanEngine_Stats_t *stats);
+void Scan_Engine_Set_Port_Mask(uint8_t mask);   /* 每点采集的PCap04端口（位0..5 = PC0..PC5，下一帧生效） */
+uint8_t Scan_Engine_Get_Port_Mask(void);
+uint32_t Scan_Engine_Measure_Point(uint8_t row, uint8_t col);  /* 阻塞式单点测量（按当前判定方式等待） */
+uint16_t Scan_Engine_Frame_Points(void);       /* 本帧测量点（转换）数 */
+uint8_t Scan_Engine_Point_Cells(const ScanPoint_t *point, uint8_t *cols, uint32_t *values);  /* 测量点对应的矩阵列和值，返回单元数 */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SCAN_ENGINE_H */
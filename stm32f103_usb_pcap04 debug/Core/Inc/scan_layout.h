@@ -0,0 +1,57 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    scan_layout.h
+  * @brief   Multi-Port Matrix Layout (PCap04 Port -> Matrix Cell Table)
+  *
+  * 矩阵列被分成若干组，每组接一个PCap04端口，各组共用列多路复用器的选择线：
+  *   矩阵列 = col_base[端口] + 列多路复用器位置
+  * 一次 CDC_START 同时得到所有端口的结果，每次转换写入多个矩阵单元：
+  *   SINGLE : PC0,           16个列位置，256次转换/帧（原接线）
+  *   DUAL   : PC0-PC1,       8个列位置，128次转换/帧
+  *   QUAD   : PC0-PC3,       4个列位置， 64次转换/帧
+  * SINGLE 布局下单元值取 SET_PORTS 端口掩码中编号最小的端口。
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SCAN_LAYOUT_H
+#define __SCAN_LAYOUT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "pcap04_spi.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define SCAN_LAYOUT_NO_CELL   0xFF    /* 该端口不对应矩阵单元 */
+
+/* Exported types ------------------------------------------------------------*/
+typedef enum {
+  SCAN_LAYOUT_SINGLE = 0,     /* 单端口（默认） */
+  SCAN_LAYOUT_DUAL,           /* 双端口，每端口8列 */
+  SCAN_LAYOUT_QUAD            /* 四端口，每端口4列 */
+} ScanLayoutId_t;
+
+/* 端口/单元映射表 */
+typedef struct {
+  uint8_t port_mask;                      /* 映射到矩阵单元的端口 */
+  uint8_t col_bits;                       /* 列多路复用器位置数 = 1 << col_bits */
+  uint8_t col_base[PCAP04_RESULT_PORTS];  /* 各端口的起始矩阵列，SCAN_LAYOUT_NO_CELL=不使用 */
+} ScanLayout_t;
+
+/* Exported functions prototypes ---------------------------------------------*/
+void Scan_Layout_Set(ScanLayoutId_t id);    /* 下一帧开始生效 */
+ScanLayoutId_t Scan_Layout_Get(void);
+const char *Scan_Layout_Name(ScanLayoutId_t id);
+void Scan_Layout_Build(ScanLayoutId_t id, uint8_t port_mask, ScanLayout_t *layout);
+uint8_t Scan_Layout_Locate(const ScanLayout_t *layout, uint8_t col, uint8_t *port, uint8_t *mux_col);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SCAN_LAYOUT_H */
@@ -0,0 +1,45 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    scan_order.h
+  * @brief   Matrix Scan Order Generator Header
+  *
+  * 扫描顺序（第step个测量点 -> 行/列）：
+  *   BINARY     : 行优先，列按二进制递增（0,1,2,...,15），行末列从15跳回0
+  *   SERPENTINE : 行优先，奇数行列反向，换行时列通道不变
+  *   GRAY       : 8位反射格雷码（高4位=行，低4位=列），相邻两点只有一根选择线翻转
+  * 无论采用哪种顺序，同一行的16个点都连续扫描，结果按行列写回 MatrixData_t。
+  * 多端口布局下每行只有 1 << col_bits 个列多路复用器位置，由 Scan_Order_Point_Cols 计算。
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SCAN_ORDER_H
+#define __SCAN_ORDER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Exported types ------------------------------------------------------------*/
+typedef enum {
+  SCAN_ORDER_BINARY = 0,      /* 二进制顺序 */
+  SCAN_ORDER_SERPENTINE,      /* 蛇形顺序 */
+  SCAN_ORDER_GRAY             /* 格雷码顺序（默认） */
+} ScanOrder_t;
+
+/* Exported functions prototypes ---------------------------------------------*/
+void Scan_Order_Set(ScanOrder_t order);     /* 下一帧开始生效 */
+ScanOrder_t Scan_Order_Get(void);
+const char *Scan_Order_Name(ScanOrder_t order);
+void Scan_Order_Point(ScanOrder_t order, uint16_t step, uint8_t *row, uint8_t *col);
+void Scan_Order_Point_Cols(ScanOrder_t order, uint16_t step, uint8_t col_bits, uint8_t *row, uint8_t *col);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SCAN_ORDER_H */
@@ -0,0 +1,41 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    text_format.h
+  * @brief   Fast Text Formatter for TABLE/SIMPLE Output Header
+  *
+  * 替代发送热路径中的 sprintf，输出与原格式逐字节相同：
+  *   "%lu" -> Text_Format_U32,  "X%02d"/"Y%02d" -> Text_Format_Label
+  * 所有函数直接写入调用方的缓冲区，返回写入后的末尾指针（不写结尾'\0'），
+  * 不使用堆，也不经过 newlib 的 printf。
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __TEXT_FORMAT_H
+#define __TEXT_FORMAT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define TEXT_FORMAT_U32_MAX     10    /* 32位无符号数最多10位十进制 */
+
+/* Exported functions prototypes ---------------------------------------------*/
+void Text_Format_Init(void);                                  /* 预生成列标题行 */
+char *Text_Format_U32(char *p, uint32_t value);               /* 十进制，等同 "%lu" */
+char *Text_Format_Label(char *p, char axis, uint8_t index);   /* "X07"，等同 "%c%02d"（index < 100） */
+char *Text_Format_Str(char *p, const char *s);                /* 复制字符串（不含'\0'） */
+char *Text_Format_Col_Header(char *p);                        /* "X00,X01,...,X15\r\n" */
+char *Text_Format_Simple_Point(char *p, uint8_t col, uint8_t row, uint32_t value);  /* "X00Y00:值\r\n" */
+char *Text_Format_Marker(char *p, const char *tag, uint32_t seq, uint32_t us);      /* "START:序号,微秒\r\n" */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TEXT_FORMAT_H */
@@ -0,0 +1,31 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    timebase.h
+  * @brief   Microsecond Timebase (Cortex-M3 DWT Cycle Counter) Header
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __TIMEBASE_H
+#define __TIMEBASE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Exported functions prototypes ---------------------------------------------*/
+void Timebase_Init(void);                 /* 使能DWT周期计数器 */
+uint32_t Timebase_Cycles(void);           /* 当前CPU周期计数（32位回绕） */
+uint32_t Timebase_Micros(void);           /* 系统运行微秒数（32位回绕，约71分钟） */
+uint32_t Timebase_Elapsed_Us(uint32_t start_cycles);  /* 自start_cycles以来经过的微秒数 */
+void Timebase_Delay_Us(uint32_t us);      /* 微秒级忙等待 */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TIMEBASE_H */
@@ -18,6 +18,9 @@ extern "C" {
 #include "main.h"
 
 /* Exported constants --------------------------------------------------------*/
+#define USB_CMD_RX_RING_SIZE  256   /* USB中断写入的接收环形缓冲区（2的幂） */
+#define USB_CMD_LINE_MAX      128   /* 单条命令最大长度（不含行结束符） */
+
 /* USB命令类型 */
 #define CMD_SET_RATE    0x01  /* 设置扫描速率: SET_RATE:<ms> (例如: SET_RATE:100) */
 #define CMD_FAST_MODE   0x02  /* 快速模式: FAST_MODE (收到就发送，一直循环) */
@@ -35,10 +38,24 @@ extern "C" {
 #define CMD_SET_MODE    0x0E  /* 设置输出模式: SET_MODE:<raw|quant> */
 #define CMD_SET_RANGE   0x0F  /* 设置量化范围: SET_RANGE:<min>:<max> */
 #define CMD_SET_LEVEL   0x10  /* 设置量化档位: SET_LEVEL:<255|1023> */
-#define CMD_SET_FORMAT  0x11  /* 设置输出格式: SET_FORMAT:<simple|table> */
+#define CMD_SET_FORMAT  0x11  /* 设置输出格式: SET_FORMAT:<simple|table|binary> */
 #define CMD_START       0x12  /* 会话开始: START （发送 START 标志，允许传输） */
 #define CMD_PCAP04_STATUS 0x13  /* 查询PCap04状态: PCAP04_STATUS */
 #define CMD_PCAP04_TEST 0x14  /* 测试PCap04通信: PCAP04_TEST */
+#define CMD_SET_WAIT    0x15  /* 设置转换完成判定方式: SET_WAIT:<intn|status|timed> */
+#define CMD_SET_ORDER   0x16  /* 设置扫描顺序: SET_ORDER:<binary|serpentine|gray> */
+#define CMD_SET_POLICY  0x17  /* 设置背压策略: SET_POLICY:<block|drop_oldest|drop_newest> */
+#define CMD_SET_PERIOD  0x18  /* 设置帧周期: SET_PERIOD:<us> (微秒分辨率) */
+#define CMD_SCHED_STATS 0x19  /* 查询帧调度抖动统计: SCHED_STATS[:RESET] */
+#define CMD_SET_PORTS   0x1A  /* 设置每点采集的PCap04端口: SET_PORTS:<mask> (位0..5 = PC0..PC5) */
+#define CMD_SET_LAYOUT  0x1B  /* 设置多端口布局: SET_LAYOUT:<single|dual|quad> */
+#define CMD_SET_DELTA   0x1C  /* 二进制帧间差分: SET_DELTA:<关键帧间隔|0=关闭> */
+#define CMD_KEYFRAME    0x1D  /* 下一帧发送关键帧: KEYFRAME */
+#define CMD_BENCH       0x1E  /* USB吞吐量测试: BENCH:<KB> */
+#define CMD_GET_FRAME   0x1F  /* 重发历史帧: GET_FRAME:<seq> */
+#define CMD_BOOT_STATS  0x20  /* 上电各阶段耗时: BOOT_STATS */
+#define CMD_PCAP04_PERSIST 0x21  /* 当前固件/配置写入PCap04 NVRAM: PCAP04_PERSIST */
+#define CMD_PCAP04_UPLOAD  0x22  /* 重新上传固件/配置并读回比较: PCAP04_UPLOAD */
 
 /* 工作模式 */
 typedef enum {
@@ -57,7 +74,8 @@ typedef enum {
 /* 输出格式 */
 typedef enum {
   FORMAT_SIMPLE = 0,   /* 简洁格式：X00Y00:值 (每行一个点) */
-  FORMAT_TABLE = 1     /* 表格格式：带行列标记，用逗号分隔 */
+  FORMAT_TABLE = 1,    /* 表格格式：带行列标记，用逗号分隔 */
+  FORMAT_BINARY = 2    /* 二进制格式：COBS分帧 + CRC-32（见 frame_codec.h） */
 } OutputFormat_t;
 
 /* 量化档位 */
@@ -69,6 +87,7 @@ typedef enum {
 /* Exported variables --------------------------------------------------------*/
 extern WorkMode_t g_work_mode;
 extern uint32_t g_scan_delay_ms;
+extern uint32_t g_scan_period_us;       /* 普通模式帧周期（微秒），由定时器调度 */
 extern uint8_t g_current_row;  /* 当前行通道 (0-15) */
 extern uint8_t g_current_col;  /* 当前列通道 (0-15) */
 extern OutputMode_t g_output_mode;      /* 输出模式：原始值/量化值 */
@@ -80,6 +99,9 @@ extern volatile uint8_t g_stream_enabled; /* 是否允许流式传输，会话
 
 /* Exported functions prototypes ---------------------------------------------*/
 void USB_Command_Init(void);
+void USB_Command_Receive(const uint8_t *buf, uint32_t len);  /* USB接收中断中调用：只把字节放入环形缓冲区 */
+void USB_Command_Task(void);                                /* 主循环中调用：拼行并在帧边界执行命令 */
+uint32_t USB_Command_Rx_Dropped(void);                      /* 接收缓冲区满而丢弃的USB包数 */
 void USB_Command_Process(uint8_t *buf, uint32_t len);
 uint8_t USB_Command_Parse(const char *cmd);
 
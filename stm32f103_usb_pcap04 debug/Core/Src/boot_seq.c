@@ -0,0 +1,201 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    boot_seq.c
+  * @brief   PCap04 Status-Polled Boot Sequencer
+  *
+  * @verbatim
+  * 原上电流程在进入主循环前固定等待约1.9秒：
+  *   USB 1000ms -> POR 500ms -> INIT 100ms -> 固件 100ms -> 配置 100ms -> INIT 100ms
+  * 这些延时都是按最坏情况估计的。这里每步之后轮询芯片是否就绪：
+  *   - POR/INIT/NV_RECALL/写固件/写配置之后发送 TEST_READ，应答 0x11 即接口已可用；
+  *   - 第二次 INIT 之后读取 STATUS_0，RUNBIT 置位即DSP已按新配置运行。
+  * 轮询间隔 BOOT_POLL_INTERVAL_US，每步有独立的超时，超时只记录并继续下一步
+  * （与原流程一样不因传感器异常而停机）。
+  * NV_RECALL 之后读回 SRAM 校验镜像 CRC（pcap04_image.c），一致则跳过固件/配置下载。
+  * USB 在 MX_USB_DEVICE_Init() 之后由中断自行枚举，与传感器上电并行，
+  * 主循环中 Boot_Seq_Usb_Ready() 在枚举完成后发送一次启动信息。
+  * @endverbatim
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "boot_seq.h"
+#include "pcap04_spi.h"
+#include "pcap04_dma.h"
+#include "pcap04_image.h"
+#include "timebase.h"
+#include "usbd_cdc_if.h"
+#include <string.h>
+
+/* Private variables ---------------------------------------------------------*/
+static Boot_Stats_t s_boot;
+static uint8_t s_usb_reported = 0;
+
+static const char * const s_stage_names[BOOT_STAGE_COUNT] = {
+  "POR", "INIT", "NV Recall", "Firmware", "Config", "INIT+RUN"
+};
+
+/* Private function prototypes -----------------------------------------------*/
+static uint8_t Test_Read(void);
+static uint8_t Run_Bit_Set(void);
+static void Wait_Ready(BootStage_t stage, uint32_t start, uint32_t timeout_us, uint8_t (*ready)(void));
+
+/******************************************************************************/
+/*                              Boot Sequence                                 */
+/******************************************************************************/
+/**
+  * @brief  PCap04 上电序列：POR -> INIT -> NV_RECALL -> [写固件 -> 写配置] -> INIT，每步轮询就绪
+  * @note   镜像由 PCap04_Image_Init() 登记；NVRAM 读回 CRC 一致时不下载
+  */
+void Boot_Seq_Run(void)
+{
+  uint32_t start;
+
+  memset(&s_boot.stage, 0, sizeof(s_boot.stage));
+  s_boot.image_source = PCAP04_IMAGE_NONE;
+  s_boot.sensor_start_ms = HAL_GetTick();
+  s_boot.image_crc = PCap04_Image_Crc();
+
+  /* 1. Power-On Reset */
+  start = Timebase_Cycles();
+  Write_Opcode(POR);
+  Wait_Ready(BOOT_STAGE_POR, start, BOOT_POR_TIMEOUT_US, Test_Read);
+
+  /* 2. INIT */
+  start = Timebase_Cycles();
+  Write_Opcode(INIT);
+  Wait_Ready(BOOT_STAGE_INIT, start, BOOT_STEP_TIMEOUT_US, Test_Read);
+
+  /* 3. 从 NVRAM 取回镜像，读回校验 */
+  start = Timebase_Cycles();
+  PCap04_Image_Recall();
+  Wait_Ready(BOOT_STAGE_RECALL, start, BOOT_STEP_TIMEOUT_US, Test_Read);
+  if(PCap04_Image_Verify() == HAL_OK) {
+    s_boot.image_source = PCAP04_IMAGE_NVRAM;
+  }
+  s_boot.recall_crc = PCap04_Image_Last_Read_Crc();
+  s_boot.stage[BOOT_STAGE_RECALL].us = Timebase_Elapsed_Us(start);
+
+  if(s_boot.image_source == PCAP04_IMAGE_NVRAM) {
+    s_boot.stage[BOOT_STAGE_FIRMWARE].skipped = 1;
+    s_boot.stage[BOOT_STAGE_CONFIG].skipped = 1;
+  } else {
+    s_boot.image_source = PCAP04_IMAGE_DOWNLOAD;
+
+    /* 4. 写入固件 */
+    start = Timebase_Cycles();
+    PCap04_Image_Write_Firmware();
+    Wait_Ready(BOOT_STAGE_FIRMWARE, start, BOOT_STEP_TIMEOUT_US, Test_Read);
+
+    /* 5. 写入配置 */
+    start = Timebase_Cycles();
+    PCap04_Image_Write_Config();
+    Wait_Ready(BOOT_STAGE_CONFIG, start, BOOT_STEP_TIMEOUT_US, Test_Read);
+  }
+
+  /* 6. 再次初始化，等待DSP按新配置运行 */
+  start = Timebase_Cycles();
+  Write_Opcode(INIT);
+  Wait_Ready(BOOT_STAGE_RUN, start, BOOT_RUN_TIMEOUT_US, Run_Bit_Set);
+
+  s_boot.sensor_ready_ms = HAL_GetTick();
+}
+
+void Boot_Seq_Main_Loop(void)
+{
+  s_boot.main_loop_ms = HAL_GetTick();
+}
+
+/**
+  * @brief  USB首次枚举完成时返回1（只返回一次），并记录时刻
+  */
+uint8_t Boot_Seq_Usb_Ready(void)
+{
+  if(s_usb_reported || !CDC_Configured_FS()) {
+    return 0;
+  }
+  s_usb_reported = 1;
+  s_boot.usb_config_ms = HAL_GetTick();
+  return 1;
+}
+
+void Boot_Seq_Get_Stats(Boot_Stats_t *stats)
+{
+  *stats = s_boot;
+}
+
+const char *Boot_Stage_Name(BootStage_t stage)
+{
+  return (stage < BOOT_STAGE_COUNT) ? s_stage_names[stage] : "UNKNOWN";
+}
+
+/******************************************************************************/
+/*                              Private Functions                             */
+/******************************************************************************/
+/**
+  * @brief  轮询直到 ready() 返回1或超时，记录该阶段耗时
+  */
+static void Wait_Ready(BootStage_t stage, uint32_t start, uint32_t timeout_us, uint8_t (*ready)(void))
+{
+  BootStage_Stats_t *st = &s_boot.stage[stage];
+
+  for(;;) {
+    st->polls++;
+    if(ready()) {
+      break;
+    }
+    if(Timebase_Elapsed_Us(start) >= timeout_us) {
+      st->timeout = 1;
+      break;
+    }
+    Timebase_Delay_Us(BOOT_POLL_INTERVAL_US);
+  }
+  st->us = Timebase_Elapsed_Us(start);
+}
+
+/**
+  * @brief  TEST_READ：操作码之后读1字节，接口就绪时应答 0x11
+  */
+static uint8_t Test_Read(void)
+{
+#if (USE_SIMULATION_MODE != 0)
+  s_boot.test_read = BOOT_TEST_READ_VALUE;
+#else
+  PCap04_Xfer_t xfer = {0};
+
+  s_boot.test_read = 0;
+  xfer.header[0] = TEST_READ;
+  xfer.header_len = 1;
+  xfer.dir = PCAP04_XFER_RX;
+  xfer.rx_data = &s_boot.test_read;
+  xfer.length = 1;
+  if(PCap04_DMA_Transfer(&xfer, PCAP04_DMA_TIMEOUT_MS) != HAL_OK) {
+    return 0;
+  }
+#endif
+  return (s_boot.test_read == BOOT_TEST_READ_VALUE) ? 1 : 0;
+}
+
+/**
+  * @brief  读取 STATUS_0，RUNBIT 置位表示DSP已开始运行
+  */
+static uint8_t Run_Bit_Set(void)
+{
+#if (USE_SIMULATION_MODE != 0)
+  s_boot.status0 = PCAP04_STATUS0_RUNBIT;
+#else
+  PCap04_Xfer_t xfer = {0};
+
+  s_boot.status0 = 0;
+  xfer.header[0] = PCAP04_RD_RESULT_CMD(PCAP04_STATUS0_ADDR);
+  xfer.header_len = 1;
+  xfer.dir = PCAP04_XFER_RX;
+  xfer.rx_data = &s_boot.status0;
+  xfer.length = 1;
+  if(PCap04_DMA_Transfer(&xfer, PCAP04_DMA_TIMEOUT_MS) != HAL_OK) {
+    return 0;
+  }
+#endif
+  return (s_boot.status0 & PCAP04_STATUS0_RUNBIT) ? 1 : 0;
+}
@@ -0,0 +1,440 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    frame_codec.c
+  * @brief   Binary Matrix Frame Encoder (COBS Framing + CRC-32)
+  *
+  * @verbatim
+  * 文本格式每个值要 sprintf 成十进制，16x16帧约 2~4KB；二进制帧为
+  * 22 + 负载 + 4 字节（帧头 + 数据 + CRC，原始值负载1024字节），COBS每254字节只多1字节开销。
+  * 量化模式只传量化后的位数：8位档每帧256字节，10位档每4个值打包成5字节共320字节，
+  * 同一个64字节批量端点上帧率约为原始值的4倍。
+  *
+  * 差分模式在RAM中保留上一个发出帧的值（s_ref，1KB），相邻帧大部分单元不变时
+  * 每帧只有几十字节。差分帧长度在 Begin 时先扫描一遍算出（帧头中的 payload_len
+  * 在数据之前发送），发送时再按同样的规则逐个生成记号并更新参考帧。
+  *
+  * 编码器不另外保存整帧的编码结果（RAM只有20KB）：帧内第 pos 个字节按需从
+  * 帧头数组、帧缓冲区或CRC计算得到，每次 Encode 只写出完整的COBS块
+  * （块长度码在块结束时回填），因此发送缓冲区至少需要 FRAME_CODEC_BLOCK_MAX + 1 字节。
+  * @endverbatim
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "frame_codec.h"
+#include "usb_command.h"
+
+/* Private define ------------------------------------------------------------*/
+#define CODEC_STAGE_OPEN    0   /* 待写起始分隔符 */
+#define CODEC_STAGE_BODY    1   /* 写COBS数据块 */
+#define CODEC_STAGE_CLOSE   2   /* 待写结束分隔符 */
+#define CODEC_STAGE_DONE    3
+
+#define CODEC_CELLS         (MATRIX_SIZE * MATRIX_SIZE)
+#define CODEC_DELTA_BASE    4   /* 差分帧数据开头的 base_seq */
+
+/* Private variables ---------------------------------------------------------*/
+/* 多项式 0xEDB88320（反射）的半字节查表，Flash中只占64字节 */
+static const uint32_t s_crc32_nibble[16] = {
+  0x00000000UL, 0x1DB71064UL, 0x3B6E20C8UL, 0x26D930ACUL,
+  0x76DC4190UL, 0x6B6B51F4UL, 0x4DB26158UL, 0x5005713CUL,
+  0xEDB88320UL, 0xF00F9344UL, 0xD6D6A3E8UL, 0xCB61B38CUL,
+  0x9B64C2B0UL, 0x86D3D2D4UL, 0xA00AE278UL, 0xBDBDF21CUL
+};
+
+/* 差分模式参考帧：上一个完整发出的帧 */
+static uint32_t s_ref[CODEC_CELLS];
+static uint8_t s_ref_valid = 0;
+static uint32_t s_ref_seq = 0;
+static uint8_t s_ref_bits = 0;
+static uint8_t s_ref_quant = 0;
+
+static uint16_t s_key_interval = 0;         /* 0=关闭差分 */
+static uint16_t s_since_key = 0;            /* 上一个关键帧之后的差分帧数 */
+static volatile uint8_t s_key_request = 0;
+
+static FrameCodec_Stats_t s_stats;
+
+/* Private function prototypes -----------------------------------------------*/
+static uint32_t Crc32_Byte(uint32_t reg, uint8_t b);
+static uint8_t Byte_At(FrameCodec_t *codec, uint16_t pos);
+static uint8_t Delta_Byte(FrameCodec_t *codec);
+static uint8_t Delta_Token(const FrameCodec_t *codec, uint16_t cell, uint8_t *out, uint16_t *cells);
+static uint16_t Delta_Payload_Len(const FrameCodec_t *codec);
+static uint8_t Put_Varint(uint8_t *out, uint32_t v);
+static uint32_t Cell_Value(const FrameCodec_t *codec, uint16_t index);
+static uint32_t Value_At(const FrameCodec_t *codec, uint16_t index);
+static void Put_U16(uint8_t *p, uint16_t v);
+static void Put_U32(uint8_t *p, uint32_t v);
+
+/******************************************************************************/
+/*                                   CRC-32                                   */
+/******************************************************************************/
+static uint32_t Crc32_Byte(uint32_t reg, uint8_t b)
+{
+  reg ^= b;
+  reg = (reg >> 4) ^ s_crc32_nibble[reg & 0x0F];
+  reg = (reg >> 4) ^ s_crc32_nibble[reg & 0x0F];
+  return reg;
+}
+
+/**
+  * @brief  CRC-32 (IEEE 802.3)，与 zlib.crc32 相同：crc 传入上次的结果，首次为0
+  */
+uint32_t Frame_Codec_Crc32(uint32_t crc, const uint8_t *data, uint32_t len)
+{
+  uint32_t reg = ~crc;
+
+  while(len--) {
+    reg = Crc32_Byte(reg, *data++);
+  }
+  return ~reg;
+}
+
+/******************************************************************************/
+/*                               Delta Control                                */
+/******************************************************************************/
+/**
+  * @brief  设置差分模式（下一帧为关键帧）
+  * @param  key_interval: 每多少帧发送一个关键帧，0=关闭差分
+  */
+void Frame_Codec_Set_Delta(uint16_t key_interval)
+{
+  if(key_interval > FRAME_CODEC_KEY_INTERVAL_MAX) {
+    key_interval = FRAME_CODEC_KEY_INTERVAL_MAX;
+  }
+  s_key_interval = key_interval;
+  s_ref_valid = 0;
+}
+
+uint16_t Frame_Codec_Get_Delta(void)
+{
+  return s_key_interval;
+}
+
+void Frame_Codec_Request_Keyframe(void)
+{
+  s_key_request = 1;
+}
+
+void Frame_Codec_Get_Stats(FrameCodec_Stats_t *stats)
+{
+  *stats = s_stats;
+}
+
+/******************************************************************************/
+/*                                  Encoder                                   */
+/******************************************************************************/
+/**
+  * @brief  开始编码一帧，锁存当前输出模式（原始值/量化值）
+  * @note   差分模式下决定本帧为关键帧还是差分帧
+  */
+void Frame_Codec_Begin(FrameCodec_t *codec, const MatrixData_t *frame)
+{
+  uint16_t payload;
+  uint16_t delta_len;
+
+  codec->frame = frame;
+  codec->quant = (g_output_mode == OUTPUT_QUANT) ? 1 : 0;
+  if(codec->quant) {
+    codec->bits = (g_quant_level > 255) ? 10 : 8;
+  } else {
+    codec->bits = 32;
+  }
+  codec->q_min = g_quant_min;
+  codec->q_max = g_quant_max;
+  payload = (uint16_t)(CODEC_CELLS * codec->bits / 8);
+
+  /* 参考帧有效且输出模式未变时尝试差分，差分不比完整帧短则发关键帧 */
+  codec->track = (s_key_interval != 0) ? 1 : 0;
+  codec->delta = 0;
+  if(codec->track && s_ref_valid && !s_key_request &&
+     s_since_key + 1 < s_key_interval &&
+     s_ref_bits == codec->bits && s_ref_quant == codec->quant) {
+    delta_len = Delta_Payload_Len(codec);
+    if(delta_len < payload) {
+      codec->delta = 1;
+      payload = delta_len;
+    }
+  }
+  if(codec->track) {
+    if(codec->delta) {
+      s_since_key++;
+    } else {
+      s_since_key = 0;
+      s_key_request = 0;
+    }
+    /* 发送过程中逐个更新参考帧，完整发出之前参考帧无效 */
+    s_ref_valid = 0;
+  }
+  codec->cell = 0;
+  Put_U32(codec->pend, s_ref_seq);
+  codec->pend_len = CODEC_DELTA_BASE;
+  codec->pend_pos = 0;
+
+  Put_U16(&codec->header[0], FRAME_CODEC_MAGIC);
+  codec->header[2] = FRAME_CODEC_VERSION;
+  codec->header[3] = (codec->quant ? FRAME_CODEC_FLAG_QUANT : 0) |
+                     ((codec->bits % 8) ? FRAME_CODEC_FLAG_PACKED : 0) |
+                     (codec->delta ? FRAME_CODEC_FLAG_DELTA : 0);
+  Put_U32(&codec->header[4], frame->seq);
+  Put_U32(&codec->header[8], frame->timestamp_us);
+  codec->header[12] = MATRIX_SIZE;
+  codec->header[13] = MATRIX_SIZE;
+  codec->header[14] = codec->bits;
+  codec->header[15] = 0;
+  Put_U16(&codec->header[16], payload);
+  Put_U32(&codec->header[18], frame->end_us);
+
+  codec->total = (uint16_t)(FRAME_CODEC_HEADER_SIZE + payload + FRAME_CODEC_CRC_SIZE);
+  codec->pos = 0;
+  codec->value_index = 0xFFFF;
+  codec->crc = 0xFFFFFFFFUL;
+  codec->stage = CODEC_STAGE_OPEN;
+}
+
+/**
+  * @brief  写入分隔符和尽可能多的完整COBS块
+  * @param  out: 输出缓冲区
+  * @param  space: 输出缓冲区可用字节数
+  * @retval 写入字节数（剩余空间不足一个块时可能为0）
+  */
+uint16_t Frame_Codec_Encode(FrameCodec_t *codec, uint8_t *out, uint16_t space)
+{
+  uint16_t len = 0;
+  uint16_t code_pos;
+  uint16_t need;
+  uint8_t run;
+  uint8_t b;
+
+  if(codec->stage == CODEC_STAGE_OPEN && space > 0) {
+    out[len++] = 0x00;
+    codec->stage = CODEC_STAGE_BODY;
+  }
+
+  while(codec->stage == CODEC_STAGE_BODY) {
+    /* 本块最多需要的字节数：长度码 + min(254, 剩余字节 + 隐含0) */
+    need = (uint16_t)(codec->total + 1 - codec->pos);
+    if(need > FRAME_CODEC_BLOCK_MAX - 1) {
+      need = FRAME_CODEC_BLOCK_MAX - 1;
+    }
+    if(space - len < need + 1) {
+      break;
+    }
+
+    code_pos = len++;
+    run = 0;
+    while(run < FRAME_CODEC_BLOCK_MAX - 1) {
+      /* COBS在数据末尾隐含一个0，遇到0时块结束（0本身不输出） */
+      b = (codec->pos < codec->total) ? Byte_At(codec, codec->pos) : 0x00;
+      codec->pos++;
+      if(b == 0x00) {
+        break;
+      }
+      out[len++] = b;
+      run++;
+    }
+    out[code_pos] = (uint8_t)(run + 1);
+
+    if(codec->pos > codec->total) {
+      codec->stage = CODEC_STAGE_CLOSE;
+    }
+  }
+
+  if(codec->stage == CODEC_STAGE_CLOSE && space - len > 0) {
+    out[len++] = 0x00;
+    codec->stage = CODEC_STAGE_DONE;
+
+    /* 整帧已编码，参考帧与主机收到的本帧一致 */
+    if(codec->track) {
+      s_ref_valid = 1;
+      s_ref_seq = codec->frame->seq;
+      s_ref_bits = codec->bits;
+      s_ref_quant = codec->quant;
+    }
+    if(codec->delta) {
+      s_stats.delta_frames++;
+    } else {
+      s_stats.key_frames++;
+    }
+    s_stats.last_payload = (uint16_t)(codec->total - FRAME_CODEC_HEADER_SIZE - FRAME_CODEC_CRC_SIZE);
+  }
+
+  return len;
+}
+
+uint8_t Frame_Codec_Done(const FrameCodec_t *codec)
+{
+  return (codec->stage == CODEC_STAGE_DONE) ? 1 : 0;
+}
+
+/******************************************************************************/
+/*                              Private Helpers                               */
+/******************************************************************************/
+/**
+  * @brief  帧内第 pos 个字节（必须按顺序调用，CRC随之累加）
+  */
+static uint8_t Byte_At(FrameCodec_t *codec, uint16_t pos)
+{
+  uint16_t data_end = (uint16_t)(codec->total - FRAME_CODEC_CRC_SIZE);
+  uint16_t offset, index;
+  uint8_t width, k;
+  uint8_t b;
+
+  if(pos >= data_end) {
+    /* CRC低字节在前，CRC本身不参与计算 */
+    return (uint8_t)(~codec->crc >> (8 * (pos - data_end)));
+  }
+
+  offset = (uint16_t)(pos - FRAME_CODEC_HEADER_SIZE);
+  if(pos < FRAME_CODEC_HEADER_SIZE) {
+    b = codec->header[pos];
+  }
+  else if(codec->delta) {
+    b = Delta_Byte(codec);
+  }
+  else if(codec->bits == 10) {
+    /* 4个10位值 = 5字节：v0 | v1<<10 | v2<<20 | v3<<30 */
+    index = (uint16_t)(offset / 5);
+    if(index != codec->value_index) {
+      uint32_t v3 = Value_At(codec, (uint16_t)(index * 4 + 3));
+
+      codec->value_index = index;
+      codec->value = Value_At(codec, (uint16_t)(index * 4))
+                   | (Value_At(codec, (uint16_t)(index * 4 + 1)) << 10)
+                   | (Value_At(codec, (uint16_t)(index * 4 + 2)) << 20)
+                   | (v3 << 30);
+      codec->value_hi = (uint8_t)(v3 >> 2);
+    }
+    k = (uint8_t)(offset % 5);
+    b = (k < 4) ? (uint8_t)(codec->value >> (8 * k)) : codec->value_hi;
+  }
+  else {
+    width = (uint8_t)(codec->bits / 8);
+    index = (uint16_t)(offset / width);
+    if(index != codec->value_index) {
+      codec->value_index = index;
+      codec->value = Value_At(codec, index);
+    }
+    b = (uint8_t)(codec->value >> (8 * (offset % width)));
+  }
+
+  codec->crc = Crc32_Byte(codec->crc, b);
+  return b;
+}
+
+/**
+  * @brief  行优先第 index 个值（量化值已限制在 0..level，不超过 bits 位）
+  */
+static uint32_t Cell_Value(const FrameCodec_t *codec, uint16_t index)
+{
+  uint32_t value = codec->frame->capacitance[index / MATRIX_SIZE][index % MATRIX_SIZE];
+
+  if(codec->quant) {
+    value = Quantize_Value(value, codec->q_min, codec->q_max, (codec->bits == 8) ? 255 : 1023);
+  }
+  return value;
+}
+
+/**
+  * @brief  完整帧取值，差分模式下同时记入参考帧
+  */
+static uint32_t Value_At(const FrameCodec_t *codec, uint16_t index)
+{
+  uint32_t value = Cell_Value(codec, index);
+
+  if(codec->track) {
+    s_ref[index] = value;
+  }
+  return value;
+}
+
+/**
+  * @brief  差分帧数据区的下一个字节：base_seq，然后逐个生成记号
+  */
+static uint8_t Delta_Byte(FrameCodec_t *codec)
+{
+  uint16_t cells;
+
+  if(codec->pend_pos >= codec->pend_len) {
+    codec->pend_len = Delta_Token(codec, codec->cell, codec->pend, &cells);
+    codec->pend_pos = 0;
+    if(codec->pend[0] != 0x00) {
+      /* 非0差分：参考帧更新为本帧值（0差分的单元参考值不变） */
+      s_ref[codec->cell] = Cell_Value(codec, codec->cell);
+    }
+    codec->cell = (uint16_t)(codec->cell + cells);
+  }
+  return codec->pend[codec->pend_pos++];
+}
+
+/**
+  * @brief  生成从 cell 开始的一个差分记号
+  * @param  cells: 返回该记号覆盖的单元数
+  * @retval 记号字节数（非0差分最多5字节，0差分游程最多3字节）
+  */
+static uint8_t Delta_Token(const FrameCodec_t *codec, uint16_t cell, uint8_t *out, uint16_t *cells)
+{
+  int32_t d = (int32_t)(Cell_Value(codec, cell) - s_ref[cell]);
+  uint16_t run = 1;
+
+  if(d != 0) {
+    /* zigzag：0,-1,1,-2,2... -> 0,1,2,3,4...，非0差分编码后不为0 */
+    *cells = 1;
+    return Put_Varint(out, (d < 0) ? ~((uint32_t)d << 1) : ((uint32_t)d << 1));
+  }
+
+  while(cell + run < CODEC_CELLS && Cell_Value(codec, (uint16_t)(cell + run)) == s_ref[cell + run]) {
+    run++;
+  }
+  *cells = run;
+  out[0] = 0x00;
+  return (uint8_t)(1 + Put_Varint(&out[1], run));
+}
+
+/**
+  * @brief  差分帧数据长度（base_seq + 全部记号），不修改参考帧
+  */
+static uint16_t Delta_Payload_Len(const FrameCodec_t *codec)
+{
+  uint8_t token[5];
+  uint16_t cell = 0;
+  uint16_t cells;
+  uint16_t len = CODEC_DELTA_BASE;
+
+  while(cell < CODEC_CELLS) {
+    len += Delta_Token(codec, cell, token, &cells);
+    cell = (uint16_t)(cell + cells);
+  }
+  return len;
+}
+
+/**
+  * @brief  LEB128无符号变长整数（每字节7位，低位在前）
+  */
+static uint8_t Put_Varint(uint8_t *out, uint32_t v)
+{
+  uint8_t n = 0;
+
+  while(v >= 0x80) {
+    out[n++] = (uint8_t)(v | 0x80);
+    v >>= 7;
+  }
+  out[n++] = (uint8_t)v;
+  return n;
+}
+
+static void Put_U16(uint8_t *p, uint16_t v)
+{
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static void Put_U32(uint8_t *p, uint32_t v)
+{
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+}
@@ -0,0 +1,222 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    frame_sched.c
+  * @brief   TIM2-Driven Deterministic Frame Scheduler
+  *
+  * @verbatim
+  * 原 NORMAL 模式在主循环中比较 HAL_GetTick() - last_scan_ms，分辨率1ms，
+  * 且上一帧打印越久，下一帧开始越晚，帧周期随发送耗时漂移。
+  *
+  * 这里由 TIM2 更新中断直接调用 Matrix_Stream_Start() 启动一帧：
+  *   - 定时器计数分辨率 tick 取 1/10/100/500 us 中能容纳该周期的最小值，
+  *     以毫秒为单位的周期总能整除，不产生累积误差；
+  *   - 每帧起始时刻用 DWT 记录，与上一帧起始之差即实际间隔，
+  *     与设定周期之差的绝对值计为抖动；
+  *   - 周期到达时上一帧仍在扫描（或BLOCK策略下无空闲缓冲区）则跳过该周期并计为超限，
+  *     下一帧仍对齐到定时器节拍，不会顺延。
+  * TIM2 中断优先级为1，低于USB/SPI DMA/INTN（0）。
+  * @endverbatim
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "frame_sched.h"
+#include "tim.h"
+#include "timebase.h"
+#include "matrix_scan.h"
+#include <string.h>
+
+/* Private variables ---------------------------------------------------------*/
+static volatile uint8_t s_running = 0;
+static uint32_t s_period_us = 0;
+static uint32_t s_tick_us = 1;
+static uint8_t s_have_last = 0;             /* 已有上一帧起始时刻 */
+static uint32_t s_last_start = 0;           /* 上一帧起始时刻（DWT周期） */
+static uint64_t s_jitter_sum = 0;
+static uint32_t s_jitter_count = 0;        /* 参与抖动统计的间隔数 */
+static FrameSched_Stats_t s_stats;
+
+/* Private function prototypes -----------------------------------------------*/
+static void Record_Start(void);
+
+/******************************************************************************/
+/*                              Initialization                                */
+/******************************************************************************/
+void Frame_Sched_Init(void)
+{
+  MX_TIM2_Init();   /* usb.ioc 中 MX_TIM2_Init 设为不在 main 生成调用，由这里初始化 */
+  s_running = 0;
+  Frame_Sched_Reset_Stats();
+}
+
+/**
+  * @brief  以指定周期启动调度，第一帧立即开始
+  * @param  period_us: 帧周期（微秒），限制在 FRAME_SCHED_MIN_PERIOD_US 到 FRAME_SCHED_MAX_PERIOD_US
+  */
+void Frame_Sched_Start(uint32_t period_us)
+{
+  static const uint16_t tick_table[] = {1, 10, 100, 500};
+  uint32_t timer_clk;
+  uint32_t ticks;
+  uint8_t i;
+
+  if(period_us < FRAME_SCHED_MIN_PERIOD_US) {
+    period_us = FRAME_SCHED_MIN_PERIOD_US;
+  }
+  if(period_us > FRAME_SCHED_MAX_PERIOD_US) {
+    period_us = FRAME_SCHED_MAX_PERIOD_US;
+  }
+
+  Frame_Sched_Stop();
+
+  /* APB1分频不为1时定时器时钟为PCLK1的2倍 */
+  timer_clk = HAL_RCC_GetPCLK1Freq();
+  if((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1) {
+    timer_clk *= 2;
+  }
+
+  /* 选择能容纳该周期的最小计数分辨率；判断与装载值使用同一四舍五入计数，
+   * 否则略低于分辨率边界的周期会得到 65537 个计数，ARR 溢出为0 */
+  for(i = 0; i < sizeof(tick_table) / sizeof(tick_table[0]) - 1; i++) {
+    if((period_us + tick_table[i] / 2) / tick_table[i] <= 65536U) {
+      break;
+    }
+  }
+  s_tick_us = tick_table[i];
+  ticks = (period_us + s_tick_us / 2) / s_tick_us;
+  if(ticks > 65536U) {
+    ticks = 65536U;
+  }
+
+  s_period_us = period_us;
+  s_have_last = 0;
+  s_stats.period_us = period_us;
+  s_stats.tick_us = s_tick_us;
+
+  __HAL_TIM_SET_PRESCALER(&htim2, (timer_clk / 1000000U) * s_tick_us - 1U);
+  __HAL_TIM_SET_AUTORELOAD(&htim2, ticks - 1U);
+  __HAL_TIM_SET_COUNTER(&htim2, 0);
+  /* 产生更新事件装载预分频值，并清除由此置位的更新标志 */
+  htim2.Instance->EGR = TIM_EGR_UG;
+  __HAL_TIM_CLEAR_FLAG(&htim2, TIM_FLAG_UPDATE);
+
+  s_running = 1;
+  HAL_TIM_Base_Start_IT(&htim2);
+
+  /* 第一帧立即开始，之后每个更新中断开始一帧 */
+  if(Matrix_Stream_Start()) {
+    Record_Start();
+  }
+}
+
+void Frame_Sched_Stop(void)
+{
+  if(s_running) {
+    HAL_TIM_Base_Stop_IT(&htim2);
+    s_running = 0;
+  }
+}
+
+/**
+  * @brief  暂缓/恢复帧起始：主循环执行命令（可能访问SPI）期间不让TIM2中断开始新帧
+  * @note   期间到期的周期在 Release 后立即开始，延迟计入抖动统计；多个周期到期只开始一帧
+  */
+void Frame_Sched_Hold(void)
+{
+  HAL_NVIC_DisableIRQ(TIM2_IRQn);
+}
+
+void Frame_Sched_Release(void)
+{
+  HAL_NVIC_EnableIRQ(TIM2_IRQn);
+}
+
+uint8_t Frame_Sched_Running(void)
+{
+  return s_running;
+}
+
+uint32_t Frame_Sched_Period_Us(void)
+{
+  return s_period_us;
+}
+
+void Frame_Sched_Get_Stats(FrameSched_Stats_t *stats)
+{
+  *stats = s_stats;
+  if(s_jitter_count > 0) {
+    stats->mean_jitter_us = (uint32_t)(s_jitter_sum / s_jitter_count);
+  } else {
+    stats->min_interval_us = 0;
+  }
+}
+
+void Frame_Sched_Reset_Stats(void)
+{
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  memset(&s_stats, 0, sizeof(s_stats));
+  s_stats.period_us = s_period_us;
+  s_stats.tick_us = s_tick_us;
+  s_stats.min_interval_us = 0xFFFFFFFFU;
+  s_jitter_sum = 0;
+  s_jitter_count = 0;
+  s_have_last = 0;
+  __set_PRIMASK(primask);
+}
+
+/******************************************************************************/
+/*                              Timer Interrupt                               */
+/******************************************************************************/
+/**
+  * @brief  TIM2 更新中断：按周期启动一帧
+  */
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+{
+  if(htim->Instance != TIM2 || !s_running) {
+    return;
+  }
+
+  if(Matrix_Stream_Start()) {
+    Record_Start();
+  } else {
+    s_stats.overruns++;
+    /* 跳过的周期不参与间隔统计 */
+    s_have_last = 0;
+  }
+}
+
+/**
+  * @brief  记录帧起始时刻并更新抖动统计
+  */
+static void Record_Start(void)
+{
+  uint32_t now = Timebase_Cycles();
+  uint32_t interval;
+  uint32_t jitter;
+
+  s_stats.frames_started++;
+
+  if(s_have_last) {
+    interval = (now - s_last_start) / (SystemCoreClock / 1000000U);
+    jitter = (interval > s_period_us) ? (interval - s_period_us) : (s_period_us - interval);
+
+    s_stats.last_jitter_us = jitter;
+    if(jitter > s_stats.max_jitter_us) {
+      s_stats.max_jitter_us = jitter;
+    }
+    if(interval < s_stats.min_interval_us) {
+      s_stats.min_interval_us = interval;
+    }
+    if(interval > s_stats.max_interval_us) {
+      s_stats.max_interval_us = interval;
+    }
+    s_jitter_sum += jitter;
+    s_jitter_count++;
+  }
+
+  s_last_start = now;
+  s_have_last = 1;
+}
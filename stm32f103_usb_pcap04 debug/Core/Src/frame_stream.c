@@ -0,0 +1,673 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    frame_stream.c
+  * @brief   Ping-Pong Frame Buffers and Non-Blocking USB Frame Transmission
+  *
+  * @verbatim
+  * 原流程在每行数据后 while(CDC_Transmit_FS(...) == USBD_BUSY) 忙等，
+  * 主机读取端点较慢时扫描也随之停顿，每帧耗时 = 扫描时间 + 发送时间。
+  *
+  * 这里把发送拆成主循环中的非阻塞任务：
+  *   - 扫描端从 Frame_Stream_Acquire() 取得空闲缓冲区，扫描完成后 Commit；
+  *   - Frame_Stream_Tx_Task() 取序号最小的就绪帧，每次格式化尽可能多的完整行，
+  *     USB忙则直接返回，下次再试；
+  *   - 发送缓冲区也是两个：一个交给USB在发送中，另一个用于格式化下一批，
+  *     CDC_Transmit_FS 返回OK之前不会覆盖正在发送的数据。
+  * 文本输出格式：START -> (列标题) -> 数据行 -> END，
+  * 文本帧标记带帧序号和时间戳："START:<seq>,<扫描开始us>" / "END:<seq>,<扫描结束us>"；
+  * 二进制格式由 frame_codec 每批写出若干完整的COBS块。
+  *
+  * 厂商批量接口：主机对接口2选择备用设置1后，二进制帧改从 EP 0x84 发出，
+  * 虚拟串口只剩命令响应；发送端在帧开始时锁存端点，切换时先等原端点发完
+  * （两个发送缓冲区不能分别被两个端点占用），并请求关键帧让新读取端重新同步。
+  *
+  * BENCH（停止扫描时）：发送任务改为发送测试图样，每64字节一行
+  * （62个相同字母 + "\r\n"，字母按行号 A..Z 循环），最后一行
+  * "BENCH_DONE:<字节数>,<微秒>" 报告设备端耗时，主机据此核对丢包/重复并计算吞吐量。
+  *
+  * 背压：丢弃策略在 Commit 时保证仍有空闲缓冲区，扫描端 Acquire 永远成功，
+  * 因此主机停止读取时传感器采样节奏不变，只是中间的整帧被丢弃并计数。
+  *
+  * 历史帧：缓冲区池比流水线所需多 FRAME_STREAM_HISTORY 个，发送完的帧不立即释放，
+  * 而是标记为 SENT 留在原处（不复制），Acquire 没有空闲缓冲区时回收序号最旧的一个。
+  * 主机发现丢帧/缺行后发送 GET_FRAME:<seq>，该帧标记为 RESEND，发送任务优先重发
+  * （原序号和时间戳；二进制格式强制为关键帧，差分参考随之更新，与主机解码端一致）。
+  *
+  * 命令回复：命令在主循环中执行（期间暂缓TIM2开始新帧），Frame_Stream_Send_Reply()
+  * 只把回复放进队列，不等待USB；发送任务在帧边界先发完队列中的回复再开始下一帧，
+  * 回复不会插在帧的两批数据之间。RAM中的回复复制进 s_reply_buf，Flash中的常量字符串
+  * （HELP等）直接引用；队列放不下整条回复时丢弃该回复并计数。
+  * @endverbatim
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "frame_stream.h"
+#include "frame_codec.h"
+#include "text_format.h"
+#include "usb_command.h"
+#include "usbd_cdc_if.h"
+#include "timebase.h"
+#include <string.h>
+
+/* Private define ------------------------------------------------------------*/
+#define FRAME_LINE_MAX      184   /* 表格格式最长一行："Y00" + 16 x ",4294967295" + "\r\n" */
+#define TX_NONE             0xFF  /* 当前没有正在发送的帧 */
+#define BENCH_LINE          64    /* 测试图样一行（= 一个全速USB包） */
+
+/* Private variables ---------------------------------------------------------*/
+static MatrixData_t s_frames[FRAME_STREAM_POOL];
+static volatile FrameState_t s_state[FRAME_STREAM_POOL];
+static uint32_t s_next_seq = 0;
+static FrameStreamPolicy_t s_policy = FRAME_POLICY_DROP_OLDEST;
+
+/* 发送端状态 */
+static uint8_t s_tx_frame = TX_NONE;          /* 正在发送的帧缓冲区 */
+static uint16_t s_tx_step = 0;                /* 帧内下一行的序号 */
+static uint32_t s_tx_seq = 0;                 /* 正在发送的帧序号 */
+static uint8_t s_tx_last = 0;                 /* 待发送批次包含该帧的END */
+static uint8_t s_tx_resend = 0;               /* 正在发送的是重发帧 */
+static OutputFormat_t s_tx_format = FORMAT_TABLE;  /* 帧开始发送时锁存输出格式 */
+static FrameCodec_t s_tx_codec;               /* 二进制格式编码器状态 */
+static uint8_t s_tx_vendor = 0;               /* 1=当前经厂商批量端点发送，0=经CDC */
+static uint8_t s_tx_buf[2][FRAME_STREAM_TX_SIZE];
+static uint8_t s_tx_sel = 0;                  /* 下一批使用的发送缓冲区 */
+static uint16_t s_tx_len = 0;                 /* 已格式化但尚未被USB接受的字节数 */
+
+static FrameStream_Stats_t s_stats;
+
+/* 命令回复队列：s_reply_buf 按FIFO顺序分配，每条回复占一段连续空间（放不下时跳过缓冲区末尾） */
+typedef struct {
+  const uint8_t *data;                        /* 指向 s_reply_buf 或Flash */
+  uint16_t len;
+  uint16_t cost;                              /* 占用 s_reply_buf 的字节数（含跳过的末尾） */
+} ReplySlot_t;
+
+static uint8_t s_reply_buf[FRAME_STREAM_REPLY_SIZE];
+static ReplySlot_t s_reply_q[FRAME_STREAM_REPLY_SLOTS];
+static uint8_t s_reply_head = 0;              /* 队首（下一条要发送的回复） */
+static uint8_t s_reply_count = 0;             /* 排队的回复条数 */
+static uint16_t s_reply_wr = 0;               /* s_reply_buf 下一次写入位置 */
+static uint16_t s_reply_used = 0;             /* s_reply_buf 已占用字节数（含USB发送中的一条） */
+static uint16_t s_reply_inflight = 0;         /* 已交给USB、尚未确认发完的回复占用的字节数 */
+
+/* 吞吐量测试状态 */
+static volatile uint8_t s_bench_state = 0;   /* 0=空闲, 1=发送图样, 2=待发送结束行 */
+static uint32_t s_bench_left = 0;             /* 尚未格式化的图样字节数 */
+static uint32_t s_bench_sent = 0;             /* 已格式化的图样字节数 */
+static uint32_t s_bench_start_us = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+static int8_t Index_Of(const MatrixData_t *frame);
+static uint8_t Pick_Ready(void);
+static uint8_t Pick_Oldest(FrameState_t state);
+static uint8_t Has_Free(void);
+static uint16_t Format_Batch(const MatrixData_t *frame, uint8_t *buf);
+static uint16_t Bench_Batch(uint8_t *buf);
+static uint8_t Select_Sink(uint8_t vendor);
+static void Reply_Reclaim(void);
+static void Reply_Task(void);
+
+/******************************************************************************/
+/*                              Initialization                                */
+/******************************************************************************/
+void Frame_Stream_Init(void)
+{
+  s_next_seq = 0;
+  memset(&s_stats, 0, sizeof(s_stats));
+  for(uint8_t i = 0; i < FRAME_STREAM_POOL; i++) {
+    s_state[i] = FRAME_FREE;
+  }
+  s_tx_frame = TX_NONE;
+  s_tx_len = 0;
+  s_reply_head = 0;
+  s_reply_count = 0;
+  s_reply_wr = 0;
+  s_reply_used = 0;
+  s_reply_inflight = 0;
+}
+
+/**
+  * @brief  丢弃所有就绪和正在发送的帧（扫描端持有的帧不受影响）
+  */
+void Frame_Stream_Reset(void)
+{
+  /* 扫描端可能在帧调度中断中取得缓冲区，判断和改写需要原子执行 */
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  for(uint8_t i = 0; i < FRAME_STREAM_POOL; i++) {
+    if(s_state[i] == FRAME_SENT || s_state[i] == FRAME_RESEND) {
+      s_state[i] = FRAME_SENT;       /* 历史帧保留，STOP之后仍可 GET_FRAME */
+    } else if(s_state[i] != FRAME_SCANNING) {
+      s_state[i] = FRAME_FREE;
+    }
+  }
+  s_tx_frame = TX_NONE;
+  s_tx_len = 0;
+  s_bench_state = 0;
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  设置背压策略（立即生效）
+  */
+void Frame_Stream_Set_Policy(FrameStreamPolicy_t policy)
+{
+  if(policy > FRAME_POLICY_DROP_NEWEST) {
+    policy = FRAME_POLICY_BLOCK;
+  }
+  s_policy = policy;
+}
+
+FrameStreamPolicy_t Frame_Stream_Get_Policy(void)
+{
+  return s_policy;
+}
+
+const char *Frame_Stream_Policy_Name(FrameStreamPolicy_t policy)
+{
+  switch(policy) {
+    case FRAME_POLICY_DROP_OLDEST: return "DROP_OLDEST";
+    case FRAME_POLICY_DROP_NEWEST: return "DROP_NEWEST";
+    default: return "BLOCK";
+  }
+}
+
+/******************************************************************************/
+/*                                Scan Side                                   */
+/******************************************************************************/
+/**
+  * @brief  分配帧序号，主机按序号跳变统计丢帧
+  */
+uint32_t Frame_Stream_Alloc_Seq(void)
+{
+  return s_next_seq++;
+}
+
+MatrixData_t *Frame_Stream_Acquire(void)
+{
+  uint8_t pick = TX_NONE;
+
+  for(uint8_t i = 0; i < FRAME_STREAM_POOL; i++) {
+    if(s_state[i] == FRAME_FREE) {
+      pick = i;
+      break;
+    }
+  }
+  if(pick == TX_NONE) {
+    /* 回收最旧的历史帧 */
+    pick = Pick_Oldest(FRAME_SENT);
+  }
+  if(pick == TX_NONE) {
+    s_stats.scan_stalls++;
+    return NULL;
+  }
+
+  s_state[pick] = FRAME_SCANNING;
+  s_frames[pick].seq = Frame_Stream_Alloc_Seq();
+  return &s_frames[pick];
+}
+
+void Frame_Stream_Commit(MatrixData_t *frame)
+{
+  int8_t i = Index_Of(frame);
+
+  uint8_t drop;
+
+  if(i < 0) {
+    return;
+  }
+
+  s_state[i] = FRAME_READY;
+  s_stats.frames_scanned++;
+
+  /* 背压：没有空闲缓冲区留给下一帧时按策略丢弃一个整帧 */
+  if(s_policy == FRAME_POLICY_BLOCK || Has_Free()) {
+    return;
+  }
+
+  if(s_policy == FRAME_POLICY_DROP_NEWEST) {
+    drop = (uint8_t)i;
+  } else {
+    drop = Pick_Ready();   /* 最旧的待发送帧（正在发送的帧不在其中） */
+  }
+  s_state[drop] = FRAME_FREE;
+  s_stats.frames_dropped++;
+}
+
+void Frame_Stream_Release(MatrixData_t *frame)
+{
+  int8_t i = Index_Of(frame);
+
+  if(i >= 0) {
+    s_state[i] = FRAME_FREE;
+  }
+}
+
+/******************************************************************************/
+/*                                 TX Side                                    */
+/******************************************************************************/
+/**
+  * @brief  发送任务：在主循环中反复调用，从不等待USB
+  */
+void Frame_Stream_Tx_Task(void)
+{
+  /* 上一批已被USB接受，格式化下一批 */
+  uint8_t result;
+
+  /* 命令回复：与帧共用CDC时只在帧边界发送，发完再开始下一帧；帧走厂商端点时随时发送 */
+  if(s_tx_vendor || (s_tx_len == 0 && s_tx_frame == TX_NONE)) {
+    Reply_Task();
+    if(!s_tx_vendor && s_reply_count != 0) {
+      return;
+    }
+  }
+
+  if(s_tx_len == 0 && s_tx_frame == TX_NONE && s_bench_state != 0) {
+    /* 吞吐量测试（帧之间插入，BENCH只在停止扫描时接受），测的是CDC端点 */
+    if(!Select_Sink(0)) {
+      return;
+    }
+    s_tx_len = Bench_Batch(s_tx_buf[s_tx_sel]);
+  } else if(s_tx_len == 0) {
+    if(s_tx_frame == TX_NONE) {
+      /* 只有二进制帧走厂商端点，文本格式的START/END行留在虚拟串口 */
+      if(!Select_Sink((g_output_format == FORMAT_BINARY) ? Vendor_Stream_Active() : 0)) {
+        return;
+      }
+      /* 主机请求的重发帧优先 */
+      s_tx_frame = Pick_Oldest(FRAME_RESEND);
+      s_tx_resend = (s_tx_frame != TX_NONE) ? 1 : 0;
+      if(!s_tx_resend) {
+        s_tx_frame = Pick_Ready();
+      }
+      if(s_tx_frame == TX_NONE) {
+        return;
+      }
+      s_state[s_tx_frame] = FRAME_SENDING;
+      s_tx_seq = s_frames[s_tx_frame].seq;
+      s_tx_step = 0;
+      s_tx_format = g_output_format;
+      if(s_tx_resend) {
+        Frame_Codec_Request_Keyframe();
+      }
+    }
+
+    s_tx_len = Format_Batch(&s_frames[s_tx_frame], s_tx_buf[s_tx_sel]);
+
+    /* 整帧已复制到发送缓冲区，帧缓冲区转为历史帧，可被扫描端回收 */
+    s_tx_last = (s_tx_step == 0xFFFF) ? 1 : 0;
+    if(s_tx_last) {
+      s_state[s_tx_frame] = FRAME_SENT;
+      s_tx_frame = TX_NONE;
+    }
+  }
+
+  if(s_tx_vendor) {
+    result = Vendor_Transmit_FS(s_tx_buf[s_tx_sel], s_tx_len);
+    if(result == USBD_FAIL) {
+      /* 主机在帧中途关闭了厂商接口（端点已关，缓冲区不再占用），余下部分改走CDC */
+      s_tx_vendor = 0;
+      Frame_Codec_Request_Keyframe();
+      result = CDC_Transmit_FS(s_tx_buf[s_tx_sel], s_tx_len);
+    }
+  } else {
+    result = CDC_Transmit_FS(s_tx_buf[s_tx_sel], s_tx_len);
+  }
+  if(result != USBD_OK) {
+    return;
+  }
+
+  /* USB已接管该缓冲区，下一批写入另一个 */
+  s_tx_sel ^= 1;
+  s_tx_len = 0;
+  if(s_tx_last) {
+    s_tx_last = 0;
+    if(s_tx_resend) {
+      s_stats.frames_resent++;
+    } else {
+      s_stats.frames_sent++;
+      s_stats.last_sent_seq = s_tx_seq;
+    }
+  }
+}
+
+uint8_t Frame_Stream_Idle(void)
+{
+  if(s_tx_frame != TX_NONE || s_tx_len != 0 || s_bench_state != 0 || s_reply_count != 0) {
+    return 0;
+  }
+  for(uint8_t i = 0; i < FRAME_STREAM_POOL; i++) {
+    if(s_state[i] == FRAME_READY || s_state[i] == FRAME_RESEND) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/**
+  * @brief  命令回复排队（主循环中调用，不等待USB）
+  * @note   调用方的缓冲区可以在栈上：RAM中的回复复制进 s_reply_buf，Flash中的常量字符串直接引用。
+  *         回复由发送任务在帧边界发送（二进制帧经厂商端点发送时与回复不共用端点，随时发送）；
+  *         队列放不下整条回复时丢弃并计数，不发送残缺的回复
+  * @retval 1=已排队，0=队列已满而丢弃
+  */
+uint8_t Frame_Stream_Send_Reply(const uint8_t *data, uint16_t len)
+{
+  ReplySlot_t *slot;
+  uint16_t skip = 0;
+
+  if(len == 0) {
+    return 1;
+  }
+  Reply_Reclaim();
+  if(s_reply_count >= FRAME_STREAM_REPLY_SLOTS) {
+    s_stats.replies_dropped++;
+    return 0;
+  }
+  slot = &s_reply_q[(s_reply_head + s_reply_count) % FRAME_STREAM_REPLY_SLOTS];
+
+  if((uint32_t)data < SRAM_BASE) {
+    /* Flash中的常量不会改变，不占用队列缓冲区 */
+    slot->data = data;
+    slot->cost = 0;
+  } else {
+    /* 每条回复占连续空间，USB直接从队列缓冲区发送 */
+    if(s_reply_wr + len > FRAME_STREAM_REPLY_SIZE) {
+      skip = FRAME_STREAM_REPLY_SIZE - s_reply_wr;
+    }
+    if(s_reply_used + skip + len > FRAME_STREAM_REPLY_SIZE) {
+      s_stats.replies_dropped++;
+      return 0;
+    }
+    if(skip != 0) {
+      s_reply_wr = 0;
+    }
+    memcpy(&s_reply_buf[s_reply_wr], data, len);
+    slot->data = &s_reply_buf[s_reply_wr];
+    slot->cost = skip + len;
+    s_reply_wr = (s_reply_wr + len) % FRAME_STREAM_REPLY_SIZE;
+    s_reply_used += skip + len;
+  }
+  slot->len = len;
+  s_reply_count++;
+  return 1;
+}
+
+/**
+  * @brief  请求重发一帧（GET_FRAME命令）
+  * @retval 1=已在发送队列中（历史帧已标记重发，或该帧本来就在等待/正在发送），
+  *         0=不在缓冲区中（已被回收、被背压丢弃或尚未扫描）
+  */
+uint8_t Frame_Stream_Request_Resend(uint32_t seq)
+{
+  uint32_t primask = __get_PRIMASK();
+  uint8_t found = 0;
+
+  __disable_irq();
+  for(uint8_t i = 0; i < FRAME_STREAM_POOL; i++) {
+    if(s_frames[i].seq != seq) {
+      continue;
+    }
+    if(s_state[i] == FRAME_SENT) {
+      s_state[i] = FRAME_RESEND;
+      found = 1;
+    } else if(s_state[i] == FRAME_READY || s_state[i] == FRAME_SENDING || s_state[i] == FRAME_RESEND) {
+      found = 1;
+    }
+  }
+  __set_PRIMASK(primask);
+
+  return found;
+}
+
+/**
+  * @brief  当前可重发的历史帧序号范围（STATUS显示，主机据此判断还能否补帧）
+  * @retval 历史帧个数，为0时 oldest/newest 不修改
+  */
+uint8_t Frame_Stream_History_Range(uint32_t *oldest, uint32_t *newest)
+{
+  uint8_t count = 0;
+
+  for(uint8_t i = 0; i < FRAME_STREAM_POOL; i++) {
+    if(s_state[i] != FRAME_SENT && s_state[i] != FRAME_RESEND) {
+      continue;
+    }
+    if(count == 0 || (int32_t)(s_frames[i].seq - *oldest) < 0) {
+      *oldest = s_frames[i].seq;
+    }
+    if(count == 0 || (int32_t)(s_frames[i].seq - *newest) > 0) {
+      *newest = s_frames[i].seq;
+    }
+    count++;
+  }
+  return count;
+}
+
+void Frame_Stream_Get_Stats(FrameStream_Stats_t *stats)
+{
+  *stats = s_stats;
+}
+
+/**
+  * @brief  开始吞吐量测试，bytes 向下取整为64的倍数
+  */
+void Frame_Stream_Bench_Start(uint32_t bytes)
+{
+  s_bench_left = bytes - (bytes % BENCH_LINE);
+  s_bench_sent = 0;
+  s_bench_state = 1;
+}
+
+uint8_t Frame_Stream_Bench_Active(void)
+{
+  return (s_bench_state != 0) ? 1 : 0;
+}
+
+/******************************************************************************/
+/*                              Private Helpers                               */
+/******************************************************************************/
+static int8_t Index_Of(const MatrixData_t *frame)
+{
+  for(uint8_t i = 0; i < FRAME_STREAM_POOL; i++) {
+    if(frame == &s_frames[i]) {
+      return (int8_t)i;
+    }
+  }
+  return -1;
+}
+
+static uint8_t Has_Free(void)
+{
+  for(uint8_t i = 0; i < FRAME_STREAM_POOL; i++) {
+    if(s_state[i] == FRAME_FREE || s_state[i] == FRAME_SENT) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**
+  * @brief  帧开始前选择发送端点
+  * @param  vendor: 1=厂商批量端点，0=CDC
+  * @retval 0 表示原端点仍有数据在发送，本次不开始新帧
+  */
+static uint8_t Select_Sink(uint8_t vendor)
+{
+  if(vendor == s_tx_vendor) {
+    return 1;
+  }
+  if(s_tx_vendor ? Vendor_Tx_Busy_FS() : CDC_Tx_Busy_FS()) {
+    return 0;
+  }
+  s_tx_vendor = vendor;
+  Frame_Codec_Request_Keyframe();
+  return 1;
+}
+
+/**
+  * @brief  CDC空闲说明上一条已交给USB的回复已经发完，释放它占用的队列缓冲区
+  */
+static void Reply_Reclaim(void)
+{
+  if(s_reply_inflight != 0 && !CDC_Tx_Busy_FS()) {
+    s_reply_used -= s_reply_inflight;
+    s_reply_inflight = 0;
+  }
+  if(s_reply_used == 0) {
+    s_reply_wr = 0;
+  }
+}
+
+/**
+  * @brief  把队首的一条回复整条交给CDC，端点忙则下次再试
+  */
+static void Reply_Task(void)
+{
+  ReplySlot_t *slot;
+
+  Reply_Reclaim();
+  if(s_reply_count == 0) {
+    return;
+  }
+  slot = &s_reply_q[s_reply_head];
+  if(CDC_Transmit_FS((uint8_t*)slot->data, slot->len) != USBD_OK) {
+    return;
+  }
+  /* 新的一条被接受时上一条一定已经发完 */
+  s_reply_used -= s_reply_inflight;
+  s_reply_inflight = slot->cost;
+  s_reply_head = (s_reply_head + 1) % FRAME_STREAM_REPLY_SLOTS;
+  s_reply_count--;
+}
+
+/**
+  * @brief  选择序号最小的就绪帧
+  */
+static uint8_t Pick_Ready(void)
+{
+  return Pick_Oldest(FRAME_READY);
+}
+
+/**
+  * @brief  选择处于 state 的序号最小的缓冲区
+  */
+static uint8_t Pick_Oldest(FrameState_t state)
+{
+  uint8_t pick = TX_NONE;
+
+  for(uint8_t i = 0; i < FRAME_STREAM_POOL; i++) {
+    if(s_state[i] != state) {
+      continue;
+    }
+    if(pick == TX_NONE || (int32_t)(s_frames[i].seq - s_frames[pick].seq) < 0) {
+      pick = i;
+    }
+  }
+  return pick;
+}
+
+/**
+  * @brief  格式化一批测试图样；图样发完后写结束行并结束测试
+  * @retval 写入字节数
+  */
+static uint16_t Bench_Batch(uint8_t *buf)
+{
+  uint16_t len = 0;
+  char *p;
+
+  if(s_bench_state == 2 || s_bench_left == 0) {
+    /* 图样已全部交给USB，耗时从第一批开始计 */
+    p = Text_Format_Str((char *)buf, "BENCH_DONE:");
+    p = Text_Format_U32(p, s_bench_sent);
+    *p++ = ',';
+    p = Text_Format_U32(p, Timebase_Micros() - s_bench_start_us);
+    p = Text_Format_Str(p, "\r\n");
+    s_bench_state = 0;
+    return (uint16_t)(p - (char *)buf);
+  }
+
+  if(s_bench_sent == 0) {
+    s_bench_start_us = Timebase_Micros();
+  }
+  while(len + BENCH_LINE <= FRAME_STREAM_TX_SIZE && s_bench_left != 0) {
+    memset(&buf[len], 'A' + (s_bench_sent / BENCH_LINE) % 26, BENCH_LINE - 2);
+    buf[len + BENCH_LINE - 2] = '\r';
+    buf[len + BENCH_LINE - 1] = '\n';
+    len += BENCH_LINE;
+    s_bench_sent += BENCH_LINE;
+    s_bench_left -= BENCH_LINE;
+  }
+  if(s_bench_left == 0) {
+    s_bench_state = 2;
+  }
+  return len;
+}
+
+/**
+  * @brief  从 s_tx_step 开始格式化尽可能多的完整行
+  * @note   行序号：0=START，表格格式 1=列标题、2..17=数据行；简洁格式 1..256=各点；最后为END。
+  *         写完END后 s_tx_step 置为 0xFFFF
+  *         二进制格式：step 0 开始编码，之后每批写满缓冲区，编码完成后置为 0xFFFF
+  * @retval 写入字节数
+  */
+static uint16_t Format_Batch(const MatrixData_t *frame, uint8_t *buf)
+{
+  char *out = (char *)buf;
+  uint16_t len = 0;
+  uint16_t data_lines = (s_tx_format == FORMAT_TABLE) ? (1 + MATRIX_SIZE) : (MATRIX_SIZE * MATRIX_SIZE);
+  uint8_t row, col;
+  char *p;
+
+  if(s_tx_format == FORMAT_BINARY) {
+    if(s_tx_step == 0) {
+      Frame_Codec_Begin(&s_tx_codec, frame);
+      s_tx_step = 1;
+    }
+    len = Frame_Codec_Encode(&s_tx_codec, buf, FRAME_STREAM_TX_SIZE);
+    if(Frame_Codec_Done(&s_tx_codec)) {
+      s_tx_step = 0xFFFF;
+    }
+    return len;
+  }
+
+  while(s_tx_step != 0xFFFF && len + FRAME_LINE_MAX <= FRAME_STREAM_TX_SIZE) {
+    p = out + len;
+    if(s_tx_step == 0) {
+      p = Text_Format_Marker(p, "START", frame->seq, frame->timestamp_us);
+    }
+    else if(s_tx_step > data_lines) {
+      p = Text_Format_Marker(p, "END", frame->seq, frame->end_us);
+      len = (uint16_t)(p - out);
+      s_tx_step = 0xFFFF;
+      break;
+    }
+    else if(s_tx_format == FORMAT_TABLE) {
+      if(s_tx_step == 1) {
+        /* 列标题：X00,X01,X02,...,X15 */
+        p = Text_Format_Col_Header(p);
+      } else {
+        /* 数据行：Y00,值,值,值,...,值 */
+        row = (uint8_t)(s_tx_step - 2);
+        p = Text_Format_Label(p, 'Y', row);
+        for(col = 0; col < MATRIX_SIZE; col++) {
+          *p++ = ',';
+          p = Text_Format_U32(p, Matrix_Output_Value(frame->capacitance[row][col]));
+        }
+        p = Text_Format_Str(p, "\r\n");
+      }
+    }
+    else {
+      /* 简洁格式：X00Y00:值 */
+      row = (uint8_t)((s_tx_step - 1) / MATRIX_SIZE);
+      col = (uint8_t)((s_tx_step - 1) % MATRIX_SIZE);
+      p = Text_Format_Simple_Point(p, col, row, Matrix_Output_Value(frame->capacitance[row][col]));
+    }
+    len = (uint16_t)(p - out);
+    s_tx_step++;
+  }
+
+  return len;
+}
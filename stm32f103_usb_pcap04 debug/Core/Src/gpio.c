@@ -78,5 +78,23 @@ void MX_GPIO_Init(void)
 }
 
 /* USER CODE BEGIN 2 */
+/**
+  * @brief  配置PCap04 INTN输入（下降沿中断），用于转换完成触发扫描
+  */
+void MX_GPIO_INTN_Init(void)
+{
+  GPIO_InitTypeDef GPIO_InitStruct = {0};
 
+  __HAL_RCC_GPIOA_CLK_ENABLE();
+
+  /*Configure GPIO pin : PCAP04_INTN_Pin */
+  GPIO_InitStruct.Pin = PCAP04_INTN_Pin;
+  GPIO_InitStruct.Mode = GPIO_MODE_IT_FALLING;
+  GPIO_InitStruct.Pull = GPIO_PULLUP;
+  HAL_GPIO_Init(PCAP04_INTN_GPIO_Port, &GPIO_InitStruct);
+
+  /* EXTI interrupt init*/
+  HAL_NVIC_SetPriority(PCAP04_INTN_EXTI_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(PCAP04_INTN_EXTI_IRQn);
+}
 /* USER CODE END 2 */
@@ -27,10 +27,16 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 #include "pcap04_spi.h"
+#include "pcap04_dma.h"
+#include "timebase.h"
 #include "mux_control.h"
 #include "matrix_scan.h"
+#include "frame_stream.h"
+#include "frame_sched.h"
 #include "usbd_cdc_if.h"
 #include "usb_command.h"
+#include "boot_seq.h"
+#include "pcap04_image.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -51,8 +57,8 @@
 /* Private variables ---------------------------------------------------------*/
 
 /* USER CODE BEGIN PV */
-/* PCap04 固件数据 (Standard Firmware - 548 bytes) */
-uint8_t standard_fw[548] = {
+/* PCap04 固件数据 (Standard Firmware - 548 bytes)，const 放在Flash中，上传时直接作为DMA源 */
+const uint8_t standard_fw[548] = {
   0x24, 0x05, 0xA0, 0x01, 0x20, 0x55, 0x42, 0x5C, 0x48, 0xB1, 0x07, 0x92, 0x02, 0x20, 0x13, 0x02,
   0x20, 0x93, 0x02, 0xB2, 0x02, 0x78, 0x20, 0x54, 0xB3, 0x06, 0x91, 0x00, 0x7F, 0x20, 0x86, 0x20,
   0x54, 0xB6, 0x03, 0x72, 0x62, 0x20, 0x54, 0xB7, 0x00, 0x00, 0x42, 0x5C, 0xA1, 0x00, 0x49, 0xB0,
@@ -91,7 +97,7 @@ uint8_t standard_fw[548] = {
 };
 
 /* PCap04 配置数据 (Standard Configuration - 52 bytes) */
-uint8_t standard_cfg_bytewise[52] = {
+const uint8_t standard_cfg_bytewise[52] = {
   0x1D, 0x00, 0x58, 0x10,
   0x10, 0x00, 0x0F, 0x20,
   0x00, 0xD0, 0x07, 0x00,
@@ -107,15 +113,13 @@ uint8_t standard_cfg_bytewise[52] = {
   0x00, 0x00, 0x00, 0x00
 };
 
-/* 矩阵数据 */
-MatrixData_t matrix_data;
-HAL_StatusTypeDef ret;
 
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
 /* USER CODE BEGIN PFP */
+static void Send_Banner(void);
 
 /* USER CODE END PFP */
 
@@ -158,6 +162,15 @@ int main(void)
   MX_USART1_UART_Init();
   /* USER CODE BEGIN 2 */
   
+  /* 初始化PCap04 SPI DMA事务队列（DMA通道已在HAL_SPI_MspInit中配置） */
+  PCap04_DMA_Init();
+  
+  /* 初始化微秒时基（DWT周期计数器，用于扫描流水线计时） */
+  Timebase_Init();
+  
+  /* 配置PCap04 INTN转换完成中断输入 */
+  MX_GPIO_INTN_Init();
+  
   /* 配置IIC_EN引脚：根据USE_I2C_MODE宏自动设置 */
 #if PCAP04_COMM_MODE_I2C
   PCap04_Set_IIC_EN(1);  /* I2C模式：高电平使能 */
@@ -165,38 +178,16 @@ int main(void)
   PCap04_Set_IIC_EN(0);  /* SPI模式：低电平使能 */
 #endif
   
-  /* 等待USB连接 */
-  HAL_Delay(1000);
-  
   /* 初始化多路复用器 */
   Matrix_Scan_Init();
   
-  /* PCap04 初始化序列 */
-  /* 1. Power-On Reset (POR) */
-  Write_Opcode(POR);
-  HAL_Delay(500);
-  
-  /* 2. Initialize (INIT) */
-  Write_Opcode(INIT);
-  HAL_Delay(100);
-  
-  /* 3. 写入固件 */
-  ret = PCap04_Memory_Access(WR_MEM, 0x00, standard_fw, 548);
-  if(ret != HAL_OK) {
-    /* 错误处理 */
-  }
-  HAL_Delay(100);
-  
-  /* 4. 写入配置 */
-  ret = PCap04_Config_Access(WR_CONFIG, 0x00, standard_cfg_bytewise, 52);
-  if(ret != HAL_OK) {
-    /* 错误处理 */
-  }
-  HAL_Delay(100);
+  /* 初始化帧调度定时器（TIM2，普通模式下按周期启动每帧） */
+  Frame_Sched_Init();
   
-  /* 5. 再次初始化 */
-  Write_Opcode(INIT);
-  HAL_Delay(100);
+  /* PCap04 初始化序列：POR -> INIT -> 写固件 -> 写配置 -> INIT，每步轮询就绪（不再固定延时），
+   * USB 枚举同时在中断中进行，启动信息在主循环中枚举完成后发送 */
+  PCap04_Image_Init(standard_fw, sizeof(standard_fw), standard_cfg_bytewise, sizeof(standard_cfg_bytewise));
+  Boot_Seq_Run();
   
   /* 初始化USB命令处理 */
   USB_Command_Init();
@@ -204,27 +195,9 @@ int main(void)
 #if (USE_SIMULATION_MODE != 0)
   /* 初始化随机数生成器（用于模拟PCap04数据） */
   PCap04_Random_Init();
-  
-  /* USB输出初始化完成信息 */
-  {
-    uint8_t msg[] = "PCap04 Initialization Complete!\r\n"
-                    "16x16 Matrix Scan Ready...\r\n"
-                    "Note: Running in SIMULATION MODE (random data generation)\r\n"
-                    "Type 'HELP' or '?' for available commands.\r\n\r\n";
-    CDC_Transmit_FS(msg, sizeof(msg)-1);
-    HAL_Delay(100);
-  }
-#else
-  /* USB输出初始化完成信息 */
-  {
-    uint8_t msg[] = "PCap04 Initialization Complete!\r\n"
-                    "16x16 Matrix Scan Ready...\r\n"
-                    "Running in REAL MODE (SPI data acquisition)\r\n"
-                    "Type 'HELP' or '?' for available commands.\r\n\r\n";
-    CDC_Transmit_FS(msg, sizeof(msg)-1);
-    HAL_Delay(100);
-  }
 #endif
+  
+  Boot_Seq_Main_Loop();
 
   /* USER CODE END 2 */
 
@@ -233,55 +206,73 @@ int main(void)
   while (1)
   {
     static uint8_t session_open = 0;
-    static uint32_t last_scan_ms = 0;
-    static uint8_t scanning_in_progress = 0;
+    static uint8_t single_started = 0;
+
+    /* 扫描流水线和USB发送任务均为非阻塞，每轮循环推进一次 */
+    Matrix_Stream_Poll();
 
-    /* 会话开始/结束标志管理（会话级别，由Matrix_Scan_And_Stream内部管理的START/END是数据级别的） */
-    /* 注意：Matrix_Scan_And_Stream内部已经管理每次扫描的START/END，这里只管理会话状态 */
+    /* USB中断只接收字节，命令在这里（帧边界）执行，回复不会插在帧中间 */
+    USB_Command_Task();
+
+    /* USB枚举完成后发送一次启动信息 */
+    if(Boot_Seq_Usb_Ready()) {
+      Send_Banner();
+    }
+
+    /* 会话开始/结束标志管理：会话结束时丢弃尚未发送的帧 */
     if(g_stream_enabled && session_open == 0) {
       session_open = 1;
     } else if(!g_stream_enabled && session_open == 1) {
       session_open = 0;
+      single_started = 0;
+      Frame_Sched_Stop();
+      Matrix_Stream_Stop();
     }
 
-    /* 未启用流式传输则不传输 */
+    /* 未启用流式传输则不传输（正在扫描的帧需要继续推进直到完成） */
     if(!g_stream_enabled) {
-      HAL_Delay(10);
+      if(!Matrix_Stream_Scanning() && Frame_Stream_Idle()) {
+        HAL_Delay(10);
+      }
       continue;
     }
 
-    /* 根据工作模式执行扫描（非阻塞调度） */
+    /* 普通模式由定时器中断启动每帧，其他模式由主循环启动 */
+    if(g_work_mode != MODE_NORMAL) {
+      Frame_Sched_Stop();
+    }
+
+    /* 根据工作模式决定何时开始下一帧：扫描当前帧与发送上一帧同时进行 */
     switch(g_work_mode) {
       case MODE_NORMAL:
-        /* 普通模式：按设置速率循环扫描（非阻塞基于系统节拍） */
-        if(!scanning_in_progress && (HAL_GetTick() - last_scan_ms >= g_scan_delay_ms)) {
-          scanning_in_progress = 1;
-          Matrix_Scan_And_Stream(&matrix_data);  /* 函数内部等待USB发送完成 */
-          scanning_in_progress = 0;
-          last_scan_ms = HAL_GetTick();
+        /* 普通模式：TIM2按设定周期在中断中启动每帧，周期改变时重新装载 */
+        if(!Frame_Sched_Running() || Frame_Sched_Period_Us() != g_scan_period_us) {
+          Frame_Sched_Start(g_scan_period_us);
         }
         break;
         
       case MODE_FAST:
-        /* 快速模式：尽可能快地扫描（避免阻塞延时） */
-        if(!scanning_in_progress) {
-          scanning_in_progress = 1;
-          Matrix_Scan_And_Stream(&matrix_data);
-          scanning_in_progress = 0;
-        }
+        /* 快速模式：上一帧扫描完且有空闲缓冲区就立即开始下一帧 */
+        Matrix_Stream_Start();
         break;
         
       case MODE_SINGLE:
-        /* 单次模式：只扫描一次后停止；Matrix_Scan_And_Stream内部已经管理START/END */
-        Matrix_Scan_And_Stream(&matrix_data);
-        g_work_mode = MODE_STOP;  /* 扫描完成后停止 */
-        g_stream_enabled = 0;      /* 禁用流式传输 */
+        /* 单次模式：扫描一帧，发送完成后停止 */
+        if(!single_started) {
+          single_started = Matrix_Stream_Start();
+        } else if(!Matrix_Stream_Scanning() && Frame_Stream_Idle()) {
+          single_started = 0;
+          g_work_mode = MODE_STOP;  /* 扫描完成后停止 */
+          g_stream_enabled = 0;      /* 禁用流式传输 */
+        }
         break;
         
       case MODE_STOP:
       default:
-        /* 停止模式：不扫描，等待命令 */
-        HAL_Delay(10);
+        /* 停止模式：不扫描，等待命令（已扫描的帧继续发送） */
+        if(!Matrix_Stream_Scanning() && Frame_Stream_Idle()) {
+          HAL_Delay(10);
+        }
         break;
     }
     /* USER CODE END WHILE */
@@ -338,6 +329,24 @@ void SystemClock_Config(void)
 }
 
 /* USER CODE BEGIN 4 */
+/**
+  * @brief  USB枚举完成后输出初始化完成信息
+  */
+static void Send_Banner(void)
+{
+#if (USE_SIMULATION_MODE != 0)
+  static const char msg[] = "PCap04 Initialization Complete!\r\n"
+                            "16x16 Matrix Scan Ready...\r\n"
+                            "Note: Running in SIMULATION MODE (random data generation)\r\n"
+                            "Type 'HELP' or '?' for available commands.\r\n\r\n";
+#else
+  static const char msg[] = "PCap04 Initialization Complete!\r\n"
+                            "16x16 Matrix Scan Ready...\r\n"
+                            "Running in REAL MODE (SPI data acquisition)\r\n"
+                            "Type 'HELP' or '?' for available commands.\r\n\r\n";
+#endif
+  Frame_Stream_Send_Reply((const uint8_t*)msg, sizeof(msg) - 1);
+}
 
 /* USER CODE END 4 */
 
@@ -10,12 +10,15 @@
 #include "matrix_scan.h"
 #include "pcap04_spi.h"
 #include "mux_control.h"
-#include "usbd_cdc_if.h"
 #include "usb_command.h"
+#include "scan_engine.h"
+#include "frame_stream.h"
+#include "text_format.h"
+#include "timebase.h"
 #include <string.h>
-#include <stdio.h>
 
 /* Private variables ---------------------------------------------------------*/
+static MatrixData_t * volatile s_scan_frame = NULL;   /* 乒乓流水线中扫描端当前持有的帧缓冲区 */
 
 /******************************************************************************/
 /*                           Matrix Scan Initialization                      */
@@ -28,6 +31,12 @@ void Matrix_Scan_Init(void)
   /* 禁用所有多路复用器 */
   MUX_Disable_Column();
   MUX_Disable_Row();
+  
+  /* 初始化流水线扫描引擎和乒乓帧缓冲区 */
+  Scan_Engine_Init();
+  Frame_Stream_Init();
+  Text_Format_Init();
+  s_scan_frame = NULL;
 }
 
 /******************************************************************************/
@@ -41,23 +50,8 @@ uint32_t Matrix_Scan_Point(uint8_t row, uint8_t col)
   if(row >= MATRIX_SIZE) row = MATRIX_SIZE - 1;
   if(col >= MATRIX_SIZE) col = MATRIX_SIZE - 1;
   
-  /* 选择行列 */
-  MUX_Select_Row(row);
-  MUX_Select_Column(col);
-
-  
-  /* 触发PCap04测量 */
-  Write_Opcode(CDC_START);  /* 0x8C */
-  
-
-  
-  /* 读取PCap04电容值 */
-  /* RD_RESULT opcode: 0x40, 地址0x00读取RES0 */
-  result = PCap04_Read_Result(RD_RESULT, 0x00);
-  
-  /* 禁用多路复用器 */
-  MUX_Disable_Row();
-  MUX_Disable_Column();
+  /* 选通 -> CDC_START -> 等待转换完成（INTN/状态/定时） -> 突发读取结果 */
+  result = Scan_Engine_Measure_Point(row, col);
   
   return result;
 }
@@ -119,266 +113,105 @@ uint32_t Quantize_Value(uint32_t raw_value, uint32_t min_val, uint32_t max_val,
 /******************************************************************************/
 void Matrix_Scan_All(MatrixData_t *matrix)
 {
-  uint8_t row, col;
+  ScanPoint_t point;
   
   if(matrix == NULL) {
     return;
   }
   
-  /* 扫描所有16x16点 */
-  for(row = 0; row < MATRIX_SIZE; row++) {
-    for(col = 0; col < MATRIX_SIZE; col++) {
-      /* 选择行列 */
-      MUX_Select_Row(row);
-      MUX_Select_Column(col);
-      
-  
-      
-      /* 触发PCap04测量 */
-      Write_Opcode(CDC_START);  /* 0x8C */
-      
-  
-      
-      /* 读取电容值 */
-      matrix->capacitance[row][col] = PCap04_Read_Result(RD_RESULT, 0x00);
-      
-      /* 禁用多路复用器 */
-      MUX_Disable_Row();
-      MUX_Disable_Column();
-      
- 
+  /* 流水线扫描所有16x16点，结果由扫描引擎直接写入matrix */
+  Scan_Engine_Start(matrix);
+  while(!Scan_Engine_Is_Done()) {
+    Scan_Engine_Poll();
+    while(Scan_Engine_Pop_Point(&point)) {
+      /* 只需取空FIFO，数值已存入matrix */
     }
   }
 }
 
 /******************************************************************************/
-/*                     Scan and Stream Output via USB                         */
+/*                          Output Value                                      */
 /******************************************************************************/
 /**
-  * @brief  流式扫描并传输：扫描一个点立即发送一个点
-  * @param  matrix: 矩阵数据指针（可选，用于存储数据）
-  * @retval None
-  * 
-  * @note   此函数在扫描每个点的同时立即发送数据，不需要等待全部扫描完成
-  *         格式：START -> 数据行... -> END
+  * @brief  根据输出模式选择原始值或量化值
   */
-void Matrix_Scan_And_Stream(MatrixData_t *matrix)
+uint32_t Matrix_Output_Value(uint32_t raw_value)
 {
-  uint8_t tx_buffer[256];  /* USB CDC单次最多64字节 */
-  uint16_t len;
-  uint8_t row, col;
-  uint32_t output_value;
-  uint32_t raw_value;
-  
-  /* 发送开头标记 START */
-  len = sprintf((char*)tx_buffer, "START\r\n");
-  while(CDC_Transmit_FS(tx_buffer, len) == USBD_BUSY) {
- 
-  }
-  
-  /* 根据输出格式选择不同的输出方式 */
-  if(g_output_format == FORMAT_TABLE) {
-    /* 表格格式：带行列标记，用逗号分隔 */
-    
-    /* 发送列标题：X00,X01,X02,...,X15 */
-    len = 0;
-    len += sprintf((char*)tx_buffer + len, "X00");
-    for(col = 1; col < MATRIX_SIZE; col++) {
-      len += sprintf((char*)tx_buffer + len, ",X%02d", col);
-    }
-    len += sprintf((char*)tx_buffer + len, "\r\n");
-    
-    while(CDC_Transmit_FS(tx_buffer, len) == USBD_BUSY) {
- 
-    }
-    
-    /* 扫描并流式发送每一行数据：Y00,值,值,值,...,值 */
-    for(row = 0; row < MATRIX_SIZE; row++) {
-      len = 0;
-      len += sprintf((char*)tx_buffer + len, "Y%02d", row);
-      
-      for(col = 0; col < MATRIX_SIZE; col++) {
-        /* 扫描当前点 */
-        MUX_Select_Row(row);
-        MUX_Select_Column(col);
-      
-        Write_Opcode(CDC_START);
-       
-        raw_value = PCap04_Read_Result(RD_RESULT, 0x00);
-        MUX_Disable_Row();
-        MUX_Disable_Column();
-     
-        
-        /* 存储到矩阵（如果提供） */
-        if(matrix != NULL) {
-          matrix->capacitance[row][col] = raw_value;
-        }
-        
-        /* 根据输出模式选择原始值或量化值 */
-        if(g_output_mode == OUTPUT_QUANT) {
-          output_value = Quantize_Value(raw_value, 
-                                        g_quant_min, 
-                                        g_quant_max, 
-                                        (uint16_t)g_quant_level);
-        } else {
-          output_value = raw_value;
-        }
-        
-        /* 用逗号分隔，立即添加到发送缓冲区 */
-        len += sprintf((char*)tx_buffer + len, ",%lu", output_value);
-      }
-      len += sprintf((char*)tx_buffer + len, "\r\n");
-      
-      /* 立即发送该行数据 */
-      while(CDC_Transmit_FS(tx_buffer, len) == USBD_BUSY) {
-      
-      }
-      
- 
-    }
-  } else {
-    /* 简洁格式：X00Y00:值 (每行一个点) */
-    for(row = 0; row < MATRIX_SIZE; row++) {
-      for(col = 0; col < MATRIX_SIZE; col++) {
-        /* 扫描当前点 */
-        MUX_Select_Row(row);
-        MUX_Select_Column(col);
-     
-        Write_Opcode(CDC_START);
-        raw_value = PCap04_Read_Result(RD_RESULT, 0x00);
-        MUX_Disable_Row();
-        MUX_Disable_Column();
-      
-        
-        /* 存储到矩阵（如果提供） */
-        if(matrix != NULL) {
-          matrix->capacitance[row][col] = raw_value;
-        }
-        
-        /* 根据输出模式选择原始值或量化值 */
-        if(g_output_mode == OUTPUT_QUANT) {
-          output_value = Quantize_Value(raw_value, 
-                                        g_quant_min, 
-                                        g_quant_max, 
-                                        (uint16_t)g_quant_level);
-        } else {
-          output_value = raw_value;
-        }
-        
-        /* 格式：X00Y00:值 - 立即发送 */
-        len = sprintf((char*)tx_buffer, "X%02dY%02d:%lu\r\n", col, row, output_value);
-        
-        /* 立即发送该点数据 */
-        while(CDC_Transmit_FS(tx_buffer, len) == USBD_BUSY) {
-        
-        }
-      }
-   
-    }
-  }
-  
-  /* 发送结尾标记 END */
-  len = sprintf((char*)tx_buffer, "END\r\n");
-  while(CDC_Transmit_FS(tx_buffer, len) == USBD_BUSY) {
- 
+  if(g_output_mode == OUTPUT_QUANT) {
+    return Quantize_Value(raw_value, 
+                          g_quant_min, 
+                          g_quant_max, 
+                          (uint16_t)g_quant_level);
   }
+  return raw_value;
 }
 
 /******************************************************************************/
-/*                          Output Matrix via USB                             */
+/*                     Ping-Pong Frame Stream (Non-Blocking)                  */
 /******************************************************************************/
-void Matrix_Output_USB(MatrixData_t *matrix)
+/**
+  * @brief  取得空闲帧缓冲区并开始扫描
+  * @retval 1=已开始, 0=上一帧尚未扫描完或没有空闲缓冲区
+  * @note   可在主循环或帧调度定时器中断中调用
+  */
+uint8_t Matrix_Stream_Start(void)
 {
-  uint8_t tx_buffer[512];  /* USB CDC单次最多64字节，使用512字节缓冲足够 */
-  uint16_t len;
-  uint8_t row, col;
-  uint32_t output_value;
-  
-  if(matrix == NULL) {
-    return;
+  uint32_t primask = __get_PRIMASK();
+  MatrixData_t *frame;
+
+  __disable_irq();
+  if(s_scan_frame != NULL) {
+    __set_PRIMASK(primask);
+    return 0;
   }
-  
-  /* 发送开头标记 */
-  len = sprintf((char*)tx_buffer, "START\r\n");
-  while(CDC_Transmit_FS(tx_buffer, len) == USBD_BUSY) {
 
+  frame = Frame_Stream_Acquire();
+  if(frame != NULL) {
+    Scan_Engine_Start(frame);
+    s_scan_frame = frame;
   }
-  
-  /* 根据输出格式选择不同的输出方式 */
-  if(g_output_format == FORMAT_TABLE) {
-    /* 表格格式：带行列标记，用逗号分隔 */
-    
-    /* 发送列标题：X00,X01,X02,...,X15 */
-    len = 0;
-    len += sprintf((char*)tx_buffer + len, "X00");
-    for(col = 1; col < MATRIX_SIZE; col++) {
-      len += sprintf((char*)tx_buffer + len, ",X%02d", col);
-    }
-    len += sprintf((char*)tx_buffer + len, "\r\n");
-    
-    while(CDC_Transmit_FS(tx_buffer, len) == USBD_BUSY) {
-      
-    }
-    
-    /* 发送每一行数据：Y00,值,值,值,...,值 */
-    for(row = 0; row < MATRIX_SIZE; row++) {
-      len = 0;
-      len += sprintf((char*)tx_buffer + len, "Y%02d", row);
-      
-      for(col = 0; col < MATRIX_SIZE; col++) {
-        /* 根据输出模式选择原始值或量化值 */
-        if(g_output_mode == OUTPUT_QUANT) {
-          output_value = Quantize_Value(matrix->capacitance[row][col], 
-                                        g_quant_min, 
-                                        g_quant_max, 
-                                        (uint16_t)g_quant_level);
-        } else {
-          output_value = matrix->capacitance[row][col];
-        }
-        
-        /* 用逗号分隔 */
-        len += sprintf((char*)tx_buffer + len, ",%lu", output_value);
-      }
-      len += sprintf((char*)tx_buffer + len, "\r\n");
-      
-      /* 等待USB发送缓冲区可用并发送 */
-      while(CDC_Transmit_FS(tx_buffer, len) == USBD_BUSY) {
-      
-      }
-      
+  __set_PRIMASK(primask);
+
+  return (frame != NULL) ? 1 : 0;
+}
 
+/**
+  * @brief  推进扫描流水线，整帧完成后交给发送端；同时运行USB发送任务
+  */
+void Matrix_Stream_Poll(void)
+{
+  ScanPoint_t point;
+
+  if(s_scan_frame != NULL) {
+    Scan_Engine_Poll();
+    while(Scan_Engine_Pop_Point(&point)) {
+      /* 数值已由扫描引擎写入帧缓冲区 */
     }
-  } else {
-    /* 简洁格式：X00Y00:值 (每行一个点) */
-    for(row = 0; row < MATRIX_SIZE; row++) {
-      for(col = 0; col < MATRIX_SIZE; col++) {
-        /* 根据输出模式选择原始值或量化值 */
-        if(g_output_mode == OUTPUT_QUANT) {
-          output_value = Quantize_Value(matrix->capacitance[row][col], 
-                                        g_quant_min, 
-                                        g_quant_max, 
-                                        (uint16_t)g_quant_level);
-        } else {
-          output_value = matrix->capacitance[row][col];
-        }
-        
-        /* 格式：X00Y00:值 */
-        len = sprintf((char*)tx_buffer, "X%02dY%02d:%lu\r\n", col, row, output_value);
-        
-        /* 等待USB发送缓冲区可用并发送 */
-        while(CDC_Transmit_FS(tx_buffer, len) == USBD_BUSY) {
-    
-        }
+    if(Scan_Engine_Is_Done()) {
+      if(g_stream_enabled) {
+        Frame_Stream_Commit(s_scan_frame);
+      } else {
+        Frame_Stream_Release(s_scan_frame);
       }
-      
-
+      s_scan_frame = NULL;
     }
   }
-  
-  /* 发送结尾标记 */
-  len = sprintf((char*)tx_buffer, "END\r\n");
-  while(CDC_Transmit_FS(tx_buffer, len) == USBD_BUSY) {
 
+  /* 停止扫描后仍需发送吞吐量测试图样和 GET_FRAME 重发帧 */
+  if(g_stream_enabled || !Frame_Stream_Idle()) {
+    Frame_Stream_Tx_Task();
   }
 }
 
+uint8_t Matrix_Stream_Scanning(void)
+{
+  return (s_scan_frame != NULL) ? 1 : 0;
+}
+
+/**
+  * @brief  会话结束：丢弃所有待发送帧，正在扫描的帧完成后直接释放
+  */
+void Matrix_Stream_Stop(void)
+{
+  Frame_Stream_Reset();
+}
@@ -9,11 +9,45 @@
 /* Includes ------------------------------------------------------------------*/
 #include "mux_control.h"
 
+/* Private macro -------------------------------------------------------------*/
+/* 通道第b位为1则置位引脚，否则复位（BSRR高16位为复位） */
+#define BSRR_BIT(ch, b, pin)  ((((ch) >> (b)) & 1U) ? (uint32_t)(pin) : ((uint32_t)(pin) << 16))
+
+/* 列选：SY0-SY3 按通道值，ENY 拉低使能 */
+#define COL_WORD(ch)  (BSRR_BIT(ch, 0, SY0_Pin) | BSRR_BIT(ch, 1, SY1_Pin) | \
+                       BSRR_BIT(ch, 2, SY2_Pin) | BSRR_BIT(ch, 3, SY3_Pin) | ((uint32_t)ENY_Pin << 16))
+
+/* 行选：SX0-SX3 按通道值，ENX 拉低使能 */
+#define ROW_WORD(ch)  (BSRR_BIT(ch, 0, SX0_Pin) | BSRR_BIT(ch, 1, SX1_Pin) | \
+                       BSRR_BIT(ch, 2, SX2_Pin) | BSRR_BIT(ch, 3, SX3_Pin) | ((uint32_t)ENX_Pin << 16))
+
+/* Exported variables --------------------------------------------------------*/
+/* 编译期生成，存放在Flash中 */
+const uint32_t MUX_Col_BSRR[MUX_CHANNELS] = {
+  COL_WORD(0),  COL_WORD(1),  COL_WORD(2),  COL_WORD(3),
+  COL_WORD(4),  COL_WORD(5),  COL_WORD(6),  COL_WORD(7),
+  COL_WORD(8),  COL_WORD(9),  COL_WORD(10), COL_WORD(11),
+  COL_WORD(12), COL_WORD(13), COL_WORD(14), COL_WORD(15)
+};
+
+const uint32_t MUX_Row_BSRR[MUX_CHANNELS] = {
+  ROW_WORD(0),  ROW_WORD(1),  ROW_WORD(2),  ROW_WORD(3),
+  ROW_WORD(4),  ROW_WORD(5),  ROW_WORD(6),  ROW_WORD(7),
+  ROW_WORD(8),  ROW_WORD(9),  ROW_WORD(10), ROW_WORD(11),
+  ROW_WORD(12), ROW_WORD(13), ROW_WORD(14), ROW_WORD(15)
+};
+
 /******************************************************************************/
 /*                              MUX Initialization                            */
 /******************************************************************************/
 void MUX_Init(void)
 {
+  /* 查找表假定同一多路复用器的选择线和使能在同一端口 */
+  assert_param(SY0_GPIO_Port == MUX_COL_PORT && SY1_GPIO_Port == MUX_COL_PORT &&
+               SY2_GPIO_Port == MUX_COL_PORT && SY3_GPIO_Port == MUX_COL_PORT && ENY_GPIO_Port == MUX_COL_PORT);
+  assert_param(SX0_GPIO_Port == MUX_ROW_PORT && SX1_GPIO_Port == MUX_ROW_PORT &&
+               SX2_GPIO_Port == MUX_ROW_PORT && SX3_GPIO_Port == MUX_ROW_PORT && ENX_GPIO_Port == MUX_ROW_PORT);
+
   /* 初始化时禁用所有多路复用器 */
   MUX_Disable_Column();
   MUX_Disable_Row();
@@ -30,17 +64,9 @@ void MUX_Select_Column(uint8_t channel)
   }
   
   /* CD74HC4067SM96 需要4个选择信号: S0-S3 */
-  /* 列选16选1: SY0-SY3 (PA3,PA4,PA6,PA7), ENX (PA5) - 使能信号 */
-  /* 注意：用户说ENX在PA5，ENY在PB11 */
-  
-  /* 设置选择信号 (S0-S3) */
-  HAL_GPIO_WritePin(SY0_GPIO_Port, SY0_Pin, (channel & 0x01) ? GPIO_PIN_SET : GPIO_PIN_RESET);  /* S0 */
-  HAL_GPIO_WritePin(SY1_GPIO_Port, SY1_Pin, (channel & 0x02) ? GPIO_PIN_SET : GPIO_PIN_RESET);  /* S1 */
-  HAL_GPIO_WritePin(SY2_GPIO_Port, SY2_Pin, (channel & 0x04) ? GPIO_PIN_SET : GPIO_PIN_RESET);  /* S2 */
-  HAL_GPIO_WritePin(SY3_GPIO_Port, SY3_Pin, (channel & 0x08) ? GPIO_PIN_SET : GPIO_PIN_RESET);  /* S3 */
-  
-  /* 使能列选多路复用器 (ENX在PA5，低电平使能) */
-  HAL_GPIO_WritePin(ENY_GPIO_Port, ENY_Pin, GPIO_PIN_RESET);  /* 注意：CubeMX配置中ENY在PA5 */
+  /* 列选16选1: SY0-SY3 (PA3,PA4,PA6,PA7), ENY (PA5) - 使能信号，低电平有效 */
+  /* 选择线与使能在一次BSRR写入中同时更新 */
+  MUX_COL_PORT->BSRR = MUX_Col_BSRR[channel];
 }
 
 /******************************************************************************/
@@ -53,16 +79,9 @@ void MUX_Select_Row(uint8_t channel)
     channel = MUX_CHANNELS - 1;
   }
   
-  /* 行选16选1: SX0-SX3 (PB1,PB0,PB10,PB2), ENY (PB11) - 使能信号 */
-  
-  /* 设置选择信号 (S0-S3) */
-  HAL_GPIO_WritePin(SX0_GPIO_Port, SX0_Pin, (channel & 0x01) ? GPIO_PIN_SET : GPIO_PIN_RESET);  /* S0 */
-  HAL_GPIO_WritePin(SX1_GPIO_Port, SX1_Pin, (channel & 0x02) ? GPIO_PIN_SET : GPIO_PIN_RESET);  /* S1 */
-  HAL_GPIO_WritePin(SX2_GPIO_Port, SX2_Pin, (channel & 0x04) ? GPIO_PIN_SET : GPIO_PIN_RESET);  /* S2 */
-  HAL_GPIO_WritePin(SX3_GPIO_Port, SX3_Pin, (channel & 0x08) ? GPIO_PIN_SET : GPIO_PIN_RESET);  /* S3 */
-  
-  /* 使能行选多路复用器 (ENY在PB11，低电平使能) */
-  HAL_GPIO_WritePin(ENX_GPIO_Port, ENX_Pin, GPIO_PIN_RESET);  /* 注意：CubeMX配置中ENX在PB11 */
+  /* 行选16选1: SX0-SX3 (PB1,PB0,PB10,PB2), ENX (PB11) - 使能信号，低电平有效 */
+  /* 选择线与使能在一次BSRR写入中同时更新 */
+  MUX_ROW_PORT->BSRR = MUX_Row_BSRR[channel];
 }
 
 /******************************************************************************/
@@ -72,7 +91,7 @@ void MUX_Disable_Column(void)
 {
   /* 禁用列选多路复用器 (ENX在PA5，高电平禁用) */
   /* 注意：用户说ENX在PA5，CubeMX配置中ENY在PA5，所以使用ENY_GPIO_Port和ENY_Pin */
-  HAL_GPIO_WritePin(ENY_GPIO_Port, ENY_Pin, GPIO_PIN_SET);
+  MUX_COL_PORT->BSRR = MUX_COL_DISABLE_BSRR;
 }
 
 /******************************************************************************/
@@ -82,6 +101,6 @@ void MUX_Disable_Row(void)
 {
   /* 禁用行选多路复用器 (ENY在PB11，高电平禁用) */
   /* 注意：CubeMX配置中ENX在PB11，但用户说ENY在PB11，所以使用ENX_GPIO_Port和ENX_Pin */
-  HAL_GPIO_WritePin(ENX_GPIO_Port, ENX_Pin, GPIO_PIN_SET);
+  MUX_ROW_PORT->BSRR = MUX_ROW_DISABLE_BSRR;
 }
 
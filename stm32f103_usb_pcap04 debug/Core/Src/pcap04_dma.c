@@ -0,0 +1,448 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    pcap04_dma.c
+  * @brief   PCap04 SPI2 + DMA1 Asynchronous Transaction Engine
+  *
+  * @verbatim
+  * 事务队列为单生产者环形队列，可在主循环和中断中提交（提交时短暂关中断）。
+  * 每个描述符分两个DMA阶段完成：
+  *   PHASE_HEADER : HAL_SPI_Transmit_DMA(header)         -> HAL_SPI_TxCpltCallback
+  *   PHASE_PAYLOAD: HAL_SPI_Transmit_DMA(tx_data)        -> HAL_SPI_TxCpltCallback
+  *                  HAL_SPI_TransmitReceive_DMA(rx_data) -> HAL_SPI_TxRxCpltCallback
+  * 描述符完成后调用其回调，再从队列中取下一个描述符启动，CPU不参与逐字节传输。
+  *
+  * SSN保持项目约定：默认拉低，不在事务之间拉高。
+  * 例外：描述符设置 ssn_release 时，完成后拉高SSN以复位INTN（PCap04在SSN上升沿
+  * 释放INTN，EN_ASYNC_READ模式下结果寄存器也只在此之后更新），下一个事务开始时
+  * 重新拉低并等待 PCAP04_SSN_SETUP_US。
+  * @endverbatim
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "pcap04_dma.h"
+#include "pcap04_spi.h"
+#include "timebase.h"
+
+/* Private define ------------------------------------------------------------*/
+#define PHASE_IDLE      0
+#define PHASE_HEADER    1
+#define PHASE_PAYLOAD   2
+
+/* Private variables ---------------------------------------------------------*/
+extern SPI_HandleTypeDef hspi2;
+extern DMA_HandleTypeDef hdma_spi2_rx;
+extern DMA_HandleTypeDef hdma_spi2_tx;
+
+static PCap04_Xfer_t s_queue[PCAP04_DMA_QUEUE_SIZE];
+static volatile uint8_t s_head = 0;    /* 下一个写入位置 */
+static volatile uint8_t s_tail = 0;    /* 当前正在传输的描述符 */
+static volatile uint8_t s_phase = PHASE_IDLE;
+static volatile uint8_t s_ssn_released = 0;  /* SSN当前被拉高，下次启动前需重新拉低并等待建立 */
+static PCap04_DMA_Stats_t s_stats;
+
+/* 读操作的哑元发送数据（全0） */
+static const uint8_t s_dummy_tx[PCAP04_DMA_MAX_READ] = {0};
+
+/* Private function prototypes -----------------------------------------------*/
+static HAL_StatusTypeDef Engine_Start_Payload(PCap04_Xfer_t *xfer);
+static void Engine_Start_Next(void);
+static void Engine_Complete(HAL_StatusTypeDef status);
+static void Engine_Flush(HAL_StatusTypeDef status);
+static void Engine_Poll(void);
+static void Sync_Done(const PCap04_Xfer_t *xfer);
+
+/******************************************************************************/
+/*                              Engine Initialization                         */
+/******************************************************************************/
+/**
+  * @brief  初始化事务队列
+  * @note   DMA通道本身在 HAL_SPI_MspInit 中配置并与 hspi2 关联
+  */
+void PCap04_DMA_Init(void)
+{
+  s_head = 0;
+  s_tail = 0;
+  s_phase = PHASE_IDLE;
+  s_stats.submitted = 0;
+  s_stats.completed = 0;
+  s_stats.errors = 0;
+  s_stats.queue_full = 0;
+}
+
+/******************************************************************************/
+/*                              Submit Transaction                            */
+/******************************************************************************/
+/**
+  * @brief  提交一个事务描述符（描述符被复制进队列）
+  * @retval HAL_OK=已入队, HAL_BUSY=队列满, HAL_ERROR=参数错误
+  */
+HAL_StatusTypeDef PCap04_DMA_Submit(const PCap04_Xfer_t *xfer)
+{
+  uint32_t primask;
+  uint8_t next;
+
+  if(xfer == NULL || xfer->header_len > 2) {
+    return HAL_ERROR;
+  }
+  if(xfer->dir == PCAP04_XFER_RX && (xfer->rx_data == NULL || xfer->length == 0 ||
+     (xfer->tx_data == NULL && xfer->length > PCAP04_DMA_MAX_READ))) {
+    return HAL_ERROR;
+  }
+  if(xfer->dir == PCAP04_XFER_TX && (xfer->tx_data == NULL || xfer->length == 0)) {
+    return HAL_ERROR;
+  }
+  if(xfer->dir == PCAP04_XFER_NONE && xfer->header_len == 0) {
+    return HAL_ERROR;
+  }
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+
+  next = (uint8_t)((s_head + 1) % PCAP04_DMA_QUEUE_SIZE);
+  if(next == s_tail) {
+    s_stats.queue_full++;
+    __set_PRIMASK(primask);
+    return HAL_BUSY;
+  }
+
+  s_queue[s_head] = *xfer;
+  s_queue[s_head].status = HAL_BUSY;
+  s_head = next;
+  s_stats.submitted++;
+
+  /* 引擎空闲时立即启动；否则由完成中断链式启动 */
+  if(s_phase == PHASE_IDLE) {
+    Engine_Start_Next();
+  }
+
+  __set_PRIMASK(primask);
+  return HAL_OK;
+}
+
+/******************************************************************************/
+/*                          Convenience Queue Helpers                         */
+/******************************************************************************/
+HAL_StatusTypeDef PCap04_DMA_Queue_Opcode(uint8_t opcode, PCap04_Xfer_Callback_t callback, void *context)
+{
+  PCap04_Xfer_t xfer = {0};
+
+  xfer.header[0] = opcode;
+  xfer.header_len = 1;
+  xfer.dir = PCAP04_XFER_NONE;
+  xfer.callback = callback;
+  xfer.context = context;
+
+  return PCap04_DMA_Submit(&xfer);
+}
+
+HAL_StatusTypeDef PCap04_DMA_Queue_Read(uint8_t rd_opcode, uint8_t address, uint8_t *rx_data, uint16_t length,
+                                        PCap04_Xfer_Callback_t callback, void *context)
+{
+  PCap04_Xfer_t xfer = {0};
+
+  xfer.header[0] = rd_opcode;
+  xfer.header[1] = address;
+  xfer.header_len = 2;
+  xfer.dir = PCAP04_XFER_RX;
+  xfer.rx_data = rx_data;
+  xfer.length = length;
+  xfer.callback = callback;
+  xfer.context = context;
+
+  return PCap04_DMA_Submit(&xfer);
+}
+
+HAL_StatusTypeDef PCap04_DMA_Queue_Write(uint8_t wr_opcode, uint8_t address, const uint8_t *tx_data, uint16_t length,
+                                         PCap04_Xfer_Callback_t callback, void *context)
+{
+  PCap04_Xfer_t xfer = {0};
+
+  xfer.header[0] = wr_opcode;
+  xfer.header[1] = address;
+  xfer.header_len = 2;
+  xfer.dir = PCAP04_XFER_TX;
+  xfer.tx_data = tx_data;
+  xfer.length = length;
+  xfer.callback = callback;
+  xfer.context = context;
+
+  return PCap04_DMA_Submit(&xfer);
+}
+
+/******************************************************************************/
+/*                            Synchronous Transfer                            */
+/******************************************************************************/
+/**
+  * @brief  提交事务并等待其完成（描述符中的callback/context会被忽略）
+  * @note   在中断上下文中调用时（如USB接收回调），DMA中断无法抢占，
+  *         此时直接轮询DMA标志推进状态机
+  * @note   超时按DWT周期计算：中断上下文中SysTick可能被屏蔽，HAL_GetTick()不再前进，
+  *         线程和中断上下文都必须有上限，否则SPI/DMA卡住时会停在调用方的中断里
+  */
+HAL_StatusTypeDef PCap04_DMA_Transfer(const PCap04_Xfer_t *xfer, uint32_t timeout_ms)
+{
+  volatile HAL_StatusTypeDef result = HAL_BUSY;
+  PCap04_Xfer_t sync_xfer;
+  HAL_StatusTypeDef status;
+  uint32_t start = Timebase_Cycles();
+  uint32_t timeout_us = timeout_ms * 1000U;
+
+  if(xfer == NULL) {
+    return HAL_ERROR;
+  }
+
+  sync_xfer = *xfer;
+  sync_xfer.callback = Sync_Done;
+  sync_xfer.context = (void *)&result;
+
+  /* 队列满时等待空位 */
+  while((status = PCap04_DMA_Submit(&sync_xfer)) == HAL_BUSY) {
+    if(__get_IPSR() != 0U) {
+      Engine_Poll();
+    }
+    if(Timebase_Elapsed_Us(start) > timeout_us) {
+      return HAL_TIMEOUT;
+    }
+  }
+  if(status != HAL_OK) {
+    return status;
+  }
+
+  while(result == HAL_BUSY) {
+    if(__get_IPSR() != 0U) {
+      Engine_Poll();
+    }
+    if(result == HAL_BUSY && Timebase_Elapsed_Us(start) > timeout_us) {
+      /* 超时：终止当前传输并清空队列，确保不会再回写到本函数的栈变量 */
+      Engine_Flush(HAL_TIMEOUT);
+    }
+  }
+
+  return result;
+}
+
+/**
+  * @brief  等待队列中所有事务完成（超时计算同 PCap04_DMA_Transfer）
+  */
+HAL_StatusTypeDef PCap04_DMA_Wait_Idle(uint32_t timeout_ms)
+{
+  uint32_t start = Timebase_Cycles();
+  uint32_t timeout_us = timeout_ms * 1000U;
+
+  while(s_phase != PHASE_IDLE) {
+    if(__get_IPSR() != 0U) {
+      Engine_Poll();
+    }
+    if(s_phase != PHASE_IDLE && Timebase_Elapsed_Us(start) > timeout_us) {
+      Engine_Flush(HAL_TIMEOUT);
+      return HAL_TIMEOUT;
+    }
+  }
+
+  return HAL_OK;
+}
+
+uint8_t PCap04_DMA_Is_Busy(void)
+{
+  return (s_phase != PHASE_IDLE) ? 1 : 0;
+}
+
+void PCap04_DMA_Get_Stats(PCap04_DMA_Stats_t *stats)
+{
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  *stats = s_stats;
+  __set_PRIMASK(primask);
+}
+
+/******************************************************************************/
+/*                              Engine Internals                              */
+/******************************************************************************/
+/**
+  * @brief  启动数据阶段
+  */
+static HAL_StatusTypeDef Engine_Start_Payload(PCap04_Xfer_t *xfer)
+{
+  s_phase = PHASE_PAYLOAD;
+
+  if(xfer->dir == PCAP04_XFER_TX) {
+    return HAL_SPI_Transmit_DMA(&hspi2, (uint8_t *)xfer->tx_data, xfer->length);
+  }
+
+  /* 读：全双工，主机发送哑元字节（或调用方给定的数据）并同时接收 */
+  return HAL_SPI_TransmitReceive_DMA(&hspi2,
+                                     (uint8_t *)((xfer->tx_data != NULL) ? xfer->tx_data : s_dummy_tx),
+                                     xfer->rx_data, xfer->length);
+}
+
+/**
+  * @brief  从队列中取出下一个描述符并启动（须在关中断或中断上下文中调用）
+  */
+static void Engine_Start_Next(void)
+{
+  while(s_tail != s_head) {
+    PCap04_Xfer_t *xfer = &s_queue[s_tail];
+    HAL_StatusTypeDef status;
+
+    /* SSN默认拉低使能，只需确保为LOW */
+    Set_SSN(LOW);
+    if(s_ssn_released) {
+      s_ssn_released = 0;
+      Timebase_Delay_Us(PCAP04_SSN_SETUP_US);
+    }
+
+    if(xfer->header_len > 0) {
+      s_phase = PHASE_HEADER;
+      status = HAL_SPI_Transmit_DMA(&hspi2, xfer->header, xfer->header_len);
+    } else {
+      status = Engine_Start_Payload(xfer);
+    }
+
+    if(status == HAL_OK) {
+      return;
+    }
+
+    /* 启动失败：报告错误并继续下一个 */
+    xfer->status = HAL_ERROR;
+    s_stats.errors++;
+    s_stats.completed++;
+    if(xfer->callback != NULL) {
+      xfer->callback(xfer);
+    }
+    s_tail = (uint8_t)((s_tail + 1) % PCAP04_DMA_QUEUE_SIZE);
+  }
+
+  s_phase = PHASE_IDLE;
+}
+
+/**
+  * @brief  当前描述符完成：回调、出队并启动下一个
+  */
+static void Engine_Complete(HAL_StatusTypeDef status)
+{
+  PCap04_Xfer_t *xfer;
+
+  if(s_tail == s_head) {
+    s_phase = PHASE_IDLE;
+    return;
+  }
+
+  xfer = &s_queue[s_tail];
+  xfer->status = status;
+  if(status != HAL_OK) {
+    s_stats.errors++;
+  }
+  s_stats.completed++;
+
+  if(xfer->ssn_release) {
+    Set_SSN(HIGH);
+    s_ssn_released = 1;
+  }
+
+  /* 回调中可以继续提交事务：此时 s_phase 非空闲，新事务只入队不启动 */
+  if(xfer->callback != NULL) {
+    xfer->callback(xfer);
+  }
+
+  s_tail = (uint8_t)((s_tail + 1) % PCAP04_DMA_QUEUE_SIZE);
+  Engine_Start_Next();
+}
+
+/**
+  * @brief  终止当前传输并以给定状态结束队列中的全部事务
+  */
+static void Engine_Flush(HAL_StatusTypeDef status)
+{
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+
+  if(s_phase != PHASE_IDLE) {
+    HAL_SPI_Abort(&hspi2);
+  }
+
+  while(s_tail != s_head) {
+    PCap04_Xfer_t *xfer = &s_queue[s_tail];
+    xfer->status = status;
+    s_stats.errors++;
+    s_stats.completed++;
+    if(xfer->callback != NULL) {
+      xfer->callback(xfer);
+    }
+    s_tail = (uint8_t)((s_tail + 1) % PCAP04_DMA_QUEUE_SIZE);
+  }
+  s_phase = PHASE_IDLE;
+
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  轮询方式推进DMA（中断上下文中等待时使用）
+  * @note   暂时屏蔽DMA通道中断，避免与真实中断重入同一HAL句柄
+  */
+static void Engine_Poll(void)
+{
+  HAL_NVIC_DisableIRQ(DMA1_Channel4_IRQn);
+  HAL_NVIC_DisableIRQ(DMA1_Channel5_IRQn);
+
+  HAL_DMA_IRQHandler(&hdma_spi2_rx);
+  HAL_DMA_IRQHandler(&hdma_spi2_tx);
+
+  HAL_NVIC_EnableIRQ(DMA1_Channel4_IRQn);
+  HAL_NVIC_EnableIRQ(DMA1_Channel5_IRQn);
+}
+
+static void Sync_Done(const PCap04_Xfer_t *xfer)
+{
+  *(volatile HAL_StatusTypeDef *)xfer->context = xfer->status;
+}
+
+/******************************************************************************/
+/*                             HAL SPI Callbacks                              */
+/******************************************************************************/
+/**
+  * @brief  发送完成：头部阶段结束则进入数据阶段，写数据阶段结束则完成描述符
+  */
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+  PCap04_Xfer_t *xfer;
+
+  if(hspi->Instance != SPI2) {
+    return;
+  }
+
+  xfer = &s_queue[s_tail];
+  if(s_phase == PHASE_HEADER && xfer->dir != PCAP04_XFER_NONE) {
+    if(Engine_Start_Payload(xfer) != HAL_OK) {
+      Engine_Complete(HAL_ERROR);
+    }
+    return;
+  }
+
+  Engine_Complete(HAL_OK);
+}
+
+/**
+  * @brief  全双工读取完成
+  */
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+  if(hspi->Instance != SPI2) {
+    return;
+  }
+
+  Engine_Complete(HAL_OK);
+}
+
+/**
+  * @brief  SPI/DMA错误
+  */
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+{
+  if(hspi->Instance != SPI2) {
+    return;
+  }
+
+  Engine_Complete(HAL_ERROR);
+}
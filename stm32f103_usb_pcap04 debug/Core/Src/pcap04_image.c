@@ -0,0 +1,311 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    pcap04_image.c
+  * @brief   PCap04 Firmware/Config Image and NVRAM Persistence
+  *
+  * @verbatim
+  * PCap04 的固件和配置保存在 1KB SRAM 中，掉电丢失；NVRAM 是它的非易失副本：
+  *   NV_RECALL  NVRAM -> SRAM（约几十微秒）
+  *   NV_ERASE / NV_STORE  擦除 / SRAM -> NVRAM（毫秒级，没有完成标志）
+  * 每条 NV 命令之前先向 MEM_CTRL(0x3F6) 写入对应密钥。
+  *
+  * 上电时 boot_seq 先 NV_RECALL，再用 RD_MEM 读回固件区和配置区计算 CRC-32，
+  * 与 MCU 内镜像的 CRC 相同即认为 NVRAM 内容就是当前镜像，跳过约600字节的下载；
+  * 不同（NVRAM 空白、旧版本固件或配置改过）则照常下载。
+  * 因为比较的是 CRC，MCU 固件里的镜像改了之后会自动回到下载路径，
+  * 需要再执行一次 PCAP04_PERSIST 才能重新走快速路径。
+  *
+  * PCap04_Image_Upload() 是完整的上传路径：固件、配置各一次DMA突发直接从Flash发送，
+  * 再用 RD_MEM 分段读回逐字节比较，统计写入/读回耗时和不一致的字节。
+  *
+  * 模拟模式下不访问芯片，用两个标志模拟 SRAM/NVRAM 中是否为当前镜像。
+  * @endverbatim
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "pcap04_image.h"
+#include "pcap04_spi.h"
+#include "pcap04_dma.h"
+#include "frame_codec.h"
+#include "timebase.h"
+#include <string.h>
+
+/* Private variables ---------------------------------------------------------*/
+static const uint8_t *s_fw = NULL;
+static const uint8_t *s_cfg = NULL;
+static uint16_t s_fw_len = 0;
+static uint8_t s_cfg_len = 0;
+static uint32_t s_crc = 0;
+static uint32_t s_read_crc = 0;
+
+#if (USE_SIMULATION_MODE != 0)
+static uint8_t s_sim_sram = 0;    /* 模拟：SRAM 中为当前镜像 */
+static uint8_t s_sim_nvram = 0;   /* 模拟：NVRAM 中为当前镜像 */
+#endif
+
+/* Private function prototypes -----------------------------------------------*/
+#if (USE_SIMULATION_MODE == 0)
+static HAL_StatusTypeDef Crc_Region(uint16_t address, uint16_t size, uint32_t *crc);
+static HAL_StatusTypeDef Compare_Region(uint16_t address, const uint8_t *image, uint16_t size,
+                                        PCap04_Upload_Stats_t *stats);
+#endif
+
+/******************************************************************************/
+/*                              Image Functions                               */
+/******************************************************************************/
+/**
+  * @brief  登记固件/配置镜像并计算 CRC-32（固件在前、配置在后，与读回顺序相同）
+  * @note   镜像不复制，fw/cfg 必须一直有效
+  */
+void PCap04_Image_Init(const uint8_t *fw, uint16_t fw_len, const uint8_t *cfg, uint8_t cfg_len)
+{
+  s_fw = fw;
+  s_fw_len = fw_len;
+  s_cfg = cfg;
+  s_cfg_len = cfg_len;
+
+  s_crc = Frame_Codec_Crc32(0, fw, fw_len);
+  s_crc = Frame_Codec_Crc32(s_crc, cfg, cfg_len);
+}
+
+uint32_t PCap04_Image_Crc(void)
+{
+  return s_crc;
+}
+
+uint32_t PCap04_Image_Last_Read_Crc(void)
+{
+  return s_read_crc;
+}
+
+HAL_StatusTypeDef PCap04_Image_Write_Firmware(void)
+{
+  if(s_fw == NULL) {
+    return HAL_ERROR;
+  }
+  return PCap04_Memory_Access(WR_MEM, 0x000, s_fw, s_fw_len);
+}
+
+HAL_StatusTypeDef PCap04_Image_Write_Config(void)
+{
+  if(s_cfg == NULL) {
+    return HAL_ERROR;
+  }
+#if (USE_SIMULATION_MODE != 0)
+  s_sim_sram = 1;
+#endif
+  return PCap04_Config_Access(WR_CONFIG, 0, s_cfg, s_cfg_len);
+}
+
+/**
+  * @brief  下载镜像：WR_MEM 固件（地址0起）+ WR_CONFIG 配置（0x3C0起），各一次DMA突发
+  */
+HAL_StatusTypeDef PCap04_Image_Download(void)
+{
+  HAL_StatusTypeDef status;
+
+  status = PCap04_Image_Write_Firmware();
+  if(status == HAL_OK) {
+    status = PCap04_Image_Write_Config();
+  }
+  return status;
+}
+
+/**
+  * @brief  上传镜像并逐字节读回比较，之后 INIT 使新配置生效
+  * @param  stats: 字节数、写入/读回耗时、不一致字节数及第一个不一致的位置
+  * @retval HAL_OK: 读回与镜像完全一致
+  * @note   SPI 约 18MHz 下 600 字节写入约 0.3ms、读回约 1ms，只在停止扫描时调用
+  */
+HAL_StatusTypeDef PCap04_Image_Upload(PCap04_Upload_Stats_t *stats)
+{
+  HAL_StatusTypeDef status;
+  uint32_t start;
+
+  memset(stats, 0, sizeof(*stats));
+  if(s_fw == NULL) {
+    return HAL_ERROR;
+  }
+  stats->bytes = s_fw_len + s_cfg_len;
+
+  start = Timebase_Cycles();
+  status = PCap04_Image_Download();
+  stats->write_us = Timebase_Elapsed_Us(start);
+  if(status != HAL_OK) {
+    return status;
+  }
+
+  start = Timebase_Cycles();
+#if (USE_SIMULATION_MODE == 0)
+  status = Compare_Region(0x000, s_fw, s_fw_len, stats);
+  if(status == HAL_OK) {
+    status = Compare_Region(PCAP04_CFG_MEM_BASE, s_cfg, s_cfg_len, stats);
+  }
+#endif
+  stats->verify_us = Timebase_Elapsed_Us(start);
+
+  Write_Opcode(INIT);
+  if(status != HAL_OK) {
+    return status;
+  }
+  return (stats->mismatches == 0) ? HAL_OK : HAL_ERROR;
+}
+
+/**
+  * @brief  读回芯片 SRAM 中的固件区和配置区，计算 CRC-32（逐段读取，不占用整块缓冲区）
+  */
+HAL_StatusTypeDef PCap04_Image_Read_Crc(uint32_t *crc)
+{
+#if (USE_SIMULATION_MODE != 0)
+  *crc = s_sim_sram ? s_crc : 0;
+  return HAL_OK;
+#else
+  HAL_StatusTypeDef status;
+
+  *crc = 0;
+  status = Crc_Region(0x000, s_fw_len, crc);
+  if(status == HAL_OK) {
+    status = Crc_Region(PCAP04_CFG_MEM_BASE, s_cfg_len, crc);
+  }
+  return status;
+#endif
+}
+
+/**
+  * @brief  校验芯片 SRAM 中的镜像：读回 CRC 与 MCU 内镜像一致返回 HAL_OK
+  */
+HAL_StatusTypeDef PCap04_Image_Verify(void)
+{
+  HAL_StatusTypeDef status;
+
+  if(s_fw == NULL) {
+    return HAL_ERROR;
+  }
+  status = PCap04_Image_Read_Crc(&s_read_crc);
+  if(status != HAL_OK) {
+    return status;
+  }
+  return (s_read_crc == s_crc) ? HAL_OK : HAL_ERROR;
+}
+
+/**
+  * @brief  NV_RECALL：NVRAM 内容装入 SRAM（之后需 INIT 才按新配置运行）
+  */
+HAL_StatusTypeDef PCap04_Image_Recall(void)
+{
+#if (USE_SIMULATION_MODE != 0)
+  s_sim_sram = s_sim_nvram;
+  return HAL_OK;
+#else
+  return PCap04_NV_Command(NV_RECALL);
+#endif
+}
+
+/**
+  * @brief  把当前镜像写入 NVRAM：
+  *         确认 SRAM 为当前镜像（不是则先下载）-> NV_ERASE -> NV_STORE
+  *         -> NV_RECALL 读回校验 -> INIT
+  * @retval HAL_OK: NVRAM 读回 CRC 与镜像一致；结果 CRC 见 PCap04_Image_Last_Read_Crc()
+  * @note   阻塞 PCAP04_NV_ERASE_MS + PCAP04_NV_STORE_MS，只在停止扫描时调用
+  */
+HAL_StatusTypeDef PCap04_Image_Persist(void)
+{
+  HAL_StatusTypeDef status;
+
+  if(PCap04_Image_Verify() != HAL_OK) {
+    status = PCap04_Image_Download();
+    if(status != HAL_OK) {
+      return status;
+    }
+    status = PCap04_Image_Verify();
+    if(status != HAL_OK) {
+      return status;
+    }
+  }
+
+#if (USE_SIMULATION_MODE != 0)
+  s_sim_nvram = 1;
+#else
+  status = PCap04_NV_Command(NV_ERASE);
+  if(status != HAL_OK) {
+    return status;
+  }
+  HAL_Delay(PCAP04_NV_ERASE_MS);
+
+  status = PCap04_NV_Command(NV_STORE);
+  if(status != HAL_OK) {
+    return status;
+  }
+  HAL_Delay(PCAP04_NV_STORE_MS);
+#endif
+
+  /* 从 NVRAM 取回再校验，确认写入的就是当前镜像 */
+  status = PCap04_Image_Recall();
+  if(status == HAL_OK) {
+    status = PCap04_Image_Verify();
+  }
+  Write_Opcode(INIT);
+  return status;
+}
+
+/******************************************************************************/
+/*                              Private Functions                             */
+/******************************************************************************/
+#if (USE_SIMULATION_MODE == 0)
+/**
+  * @brief  RD_MEM 逐段读取一个存储器区域并累加 CRC-32
+  */
+static HAL_StatusTypeDef Crc_Region(uint16_t address, uint16_t size, uint32_t *crc)
+{
+  uint8_t buf[PCAP04_DMA_MAX_READ];
+  uint16_t chunk;
+  HAL_StatusTypeDef status;
+
+  while(size > 0) {
+    chunk = (size < sizeof(buf)) ? size : sizeof(buf);
+    status = PCap04_Read_Mem(address, buf, chunk);
+    if(status != HAL_OK) {
+      return status;
+    }
+    *crc = Frame_Codec_Crc32(*crc, buf, chunk);
+    address += chunk;
+    size -= chunk;
+  }
+  return HAL_OK;
+}
+
+/**
+  * @brief  RD_MEM 逐段读取一个存储器区域并与镜像逐字节比较
+  */
+static HAL_StatusTypeDef Compare_Region(uint16_t address, const uint8_t *image, uint16_t size,
+                                        PCap04_Upload_Stats_t *stats)
+{
+  uint8_t buf[PCAP04_DMA_MAX_READ];
+  uint16_t chunk;
+  HAL_StatusTypeDef status;
+
+  while(size > 0) {
+    chunk = (size < sizeof(buf)) ? size : sizeof(buf);
+    status = PCap04_Read_Mem(address, buf, chunk);
+    if(status != HAL_OK) {
+      return status;
+    }
+    for(uint16_t i = 0; i < chunk; i++) {
+      if(buf[i] != image[i]) {
+        if(stats->mismatches == 0) {
+          stats->first_addr = address + i;
+          stats->expected = image[i];
+          stats->actual = buf[i];
+        }
+        stats->mismatches++;
+      }
+    }
+    address += chunk;
+    image += chunk;
+    size -= chunk;
+  }
+  return HAL_OK;
+}
+#endif
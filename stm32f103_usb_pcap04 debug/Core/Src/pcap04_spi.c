@@ -18,6 +18,7 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "pcap04_spi.h"
+#include "pcap04_dma.h"
 #include "spi.h"
 #include "usbd_cdc_if.h"
 
@@ -27,7 +28,14 @@ extern SPI_HandleTypeDef hspi2;
 /* 随机数生成器状态（用于模拟PCap04数据） */
 static uint32_t g_random_seed = 1;
 
+/* 双字自动递增写入的发送缓冲区（DMA在传输期间直接读取，不能放在栈上被覆盖）；
+ * 固件/配置等字节块由 PCap04_Memory_Access/Config_Access 直接从源数据发送，不经过这里 */
+#define PCAP04_TX_STAGE_SIZE  64
+static uint8_t s_tx_stage[PCAP04_TX_STAGE_SIZE];
+
 /* Private function prototypes -----------------------------------------------*/
+static HAL_StatusTypeDef Write_Block(uint8_t opcode, uint8_t address, const uint8_t *data, uint16_t size);
+
 /* 随机数生成器函数 */
 static uint32_t Random_Generate(void);
 static void Random_Init(uint32_t seed);
@@ -64,15 +72,14 @@ void Set_SSN(uint8_t level)
 /******************************************************************************/
 void Write_Opcode(uint8_t one_byte)
 {
-  uint8_t timeout = 10;
-  
-  /* SSN默认拉低使能，只需确保为LOW */
-  Set_SSN(LOW);
-  
-  /* 发送操作码 */
-  HAL_SPI_Transmit(&hspi2, &one_byte, 1, timeout); 
-  
-  /* SSN默认拉低使能，不需要拉高 */
+  PCap04_Xfer_t xfer = {0};
+
+  /* 操作码通过DMA事务队列发送，等待完成后返回 */
+  xfer.header[0] = one_byte;
+  xfer.header_len = 1;
+  xfer.dir = PCAP04_XFER_NONE;
+
+  PCap04_DMA_Transfer(&xfer, PCAP04_DMA_TIMEOUT_MS);
 }
 
 /******************************************************************************/
@@ -80,19 +87,14 @@ void Write_Opcode(uint8_t one_byte)
 /******************************************************************************/
 void Write_Opcode2(uint8_t byte1, uint8_t byte2)
 {
-  uint8_t timeout = 10;
-  uint8_t spiTX[2];
+  PCap04_Xfer_t xfer = {0};
 
-  spiTX[0] = byte1;
-  spiTX[1] = byte2;
-      
-  /* SSN默认拉低使能，只需确保为LOW */
-  Set_SSN(LOW);
-  
-  /* 发送两个字节 */
-  HAL_SPI_Transmit(&hspi2, spiTX, 2, timeout);
-  
-  /* SSN默认拉低使能，不需要拉高 */
+  xfer.header[0] = byte1;
+  xfer.header[1] = byte2;
+  xfer.header_len = 2;
+  xfer.dir = PCAP04_XFER_NONE;
+
+  PCap04_DMA_Transfer(&xfer, PCAP04_DMA_TIMEOUT_MS);
 }
 
 /******************************************************************************/
@@ -100,171 +102,198 @@ void Write_Opcode2(uint8_t byte1, uint8_t byte2)
 /******************************************************************************/
 void Write_Dword(uint8_t opcode, uint8_t address, uint32_t dword)
 {
-  uint8_t timeout = 10;
-  uint8_t spiTX[6];
-
-  spiTX[0] = opcode;
-  spiTX[1] = address;
-  spiTX[2] = (uint8_t)(dword >> 24);
-  spiTX[3] = (uint8_t)(dword >> 16);
-  spiTX[4] = (uint8_t)(dword >> 8);
-  spiTX[5] = (uint8_t)(dword);
-      
-  /* SSN默认拉低使能，只需确保为LOW */
-  Set_SSN(LOW);
-  
-  /* 发送寄存器地址和数据 */
-  HAL_SPI_Transmit(&hspi2, spiTX, 6, timeout);
-  
-  /* SSN默认拉低使能，不需要拉高 */
+  uint8_t spiTX[4];
+
+  spiTX[0] = (uint8_t)(dword >> 24);
+  spiTX[1] = (uint8_t)(dword >> 16);
+  spiTX[2] = (uint8_t)(dword >> 8);
+  spiTX[3] = (uint8_t)(dword);
+
+  /* 操作码 -> 地址 -> 数据，一个事务内完成；spiTX在等待返回前一直有效 */
+  Write_Block(opcode, address, spiTX, 4);
 }
 
 /******************************************************************************/
 /*                    Write double words auto incrementally                   */
 /******************************************************************************/
-void Write_Dword_Auto_Incr(uint8_t opcode, uint8_t from_addr, uint32_t *dword_array, uint8_t to_addr)
+/**
+  * @brief  自动递增写入 from_addr..to_addr 共 (to_addr - from_addr + 1) 个双字
+  * @retval HAL_ERROR: 范围为空或超过发送缓冲区（PCAP04_TX_STAGE_SIZE / 4 个双字），不发送任何数据
+  */
+HAL_StatusTypeDef Write_Dword_Auto_Incr(uint8_t opcode, uint8_t from_addr, uint32_t *dword_array, uint8_t to_addr)
 {
-  uint8_t timeout = 10;
-  uint8_t spiTX[4];
   uint32_t temp_u32 = 0;
-  uint8_t spiTX_addr[2];
-
-  spiTX_addr[0] = opcode;
-  spiTX_addr[1] = from_addr;
-
-  /* 1. Put SSN low - Activate */
-  Set_SSN(LOW);
+  uint16_t count;
+  uint16_t n = 0;
 
-  /* 2.a Transmit register address */
-  HAL_SPI_Transmit(&hspi2, spiTX_addr, 2, timeout); 
-    
-  /* 2.b Transmit register address incrementally */
-  for (int i = from_addr; i <= to_addr; i++) {
-    temp_u32 = *dword_array;
-    spiTX[0] = (uint8_t)(temp_u32 >> 24);
-    spiTX[1] = (uint8_t)(temp_u32 >> 16);
-    spiTX[2] = (uint8_t)(temp_u32 >> 8);
-    spiTX[3] = (uint8_t)(temp_u32);
-
-    HAL_SPI_Transmit(&hspi2, spiTX, 4, timeout);
+  if(dword_array == NULL || to_addr < from_addr) {
+    return HAL_ERROR;
+  }
+  count = (uint16_t)(to_addr - from_addr + 1U);
+  if(count > sizeof(s_tx_stage) / 4U) {
+    return HAL_ERROR;
+  }
 
-    dword_array++;
+  /* 将所有双字按MSB优先展开到发送缓冲区，整块一次DMA发送 */
+  for (uint16_t i = 0; i < count; i++) {
+    temp_u32 = dword_array[i];
+    s_tx_stage[n++] = (uint8_t)(temp_u32 >> 24);
+    s_tx_stage[n++] = (uint8_t)(temp_u32 >> 16);
+    s_tx_stage[n++] = (uint8_t)(temp_u32 >> 8);
+    s_tx_stage[n++] = (uint8_t)(temp_u32);
   }
-  
-  /* SSN默认拉低使能，不需要拉高 */
+
+  return Write_Block(opcode, from_addr, s_tx_stage, n);
 }
 
 /******************************************************************************/
 /*                              Read double word                              */
 /******************************************************************************/
+/**
+  * @retval 读取的双字（MSB优先）；传输超时或出错时返回0
+  */
 uint32_t Read_Dword(uint8_t rd_opcode, uint8_t address)
 {
-  uint8_t timeout = 10;
-  uint8_t spiTX[2];
-  uint8_t spiRX[4];
+  PCap04_Xfer_t xfer = {0};
+  uint8_t spiRX[4] = {0};
   uint32_t temp_u32 = 0;
-  
-  spiTX[0] = rd_opcode;
-  spiTX[1] = address;
-  
-  /* SSN默认拉低使能，只需确保为LOW */
-  Set_SSN(LOW);
-  
-  /* 发送寄存器地址 */
-  HAL_SPI_Transmit(&hspi2, spiTX, 2, timeout);
-  
-  /* 读取四个字节 */
-  HAL_SPI_Receive(&hspi2, spiRX, 4, timeout);
-  
-  /* SSN默认拉低使能，不需要拉高 */
-  
+
+  xfer.header[0] = rd_opcode;
+  xfer.header[1] = address;
+  xfer.header_len = 2;
+  xfer.dir = PCAP04_XFER_RX;
+  xfer.rx_data = spiRX;
+  xfer.length = 4;
+
+  /* 发送寄存器地址后读取四个字节；超时/出错时返回0，不返回缓冲区中的残留数据 */
+  if(PCap04_DMA_Transfer(&xfer, PCAP04_DMA_TIMEOUT_MS) != HAL_OK) {
+    return 0;
+  }
+
   /* Concatenate of bytes (from MSB to LSB) */
   temp_u32 = ((uint32_t)spiRX[0] << 24) | ((uint32_t)spiRX[1] << 16) | ((uint32_t)spiRX[2] << 8) | (uint32_t)spiRX[3];
-  
+
   return temp_u32;
 }
 
+/******************************************************************************/
+/*                              Write data block                              */
+/******************************************************************************/
+/**
+  * @brief  发送 操作码 + 地址 + 数据块，并等待DMA完成
+  */
+static HAL_StatusTypeDef Write_Block(uint8_t opcode, uint8_t address, const uint8_t *data, uint16_t size)
+{
+  PCap04_Xfer_t xfer = {0};
+
+  xfer.header[0] = opcode;
+  xfer.header[1] = address;
+  xfer.header_len = 2;
+  xfer.dir = PCAP04_XFER_TX;
+  xfer.tx_data = data;
+  xfer.length = size;
+
+  return PCap04_DMA_Transfer(&xfer, PCAP04_DMA_TIMEOUT_MS);
+}
+
 /******************************************************************************/
 /*                         PCap04 Memory Access                              */
 /******************************************************************************/
-HAL_StatusTypeDef PCap04_Memory_Access(uint8_t opcode, uint16_t address, uint8_t *byte, uint16_t size)
+/**
+  * @brief  写入存储器：操作码 + 地址之后整块数据一次DMA突发发送（芯片内地址自动递增）
+  * @param  opcode: WR_MEM，地址高两位自动并入操作码
+  * @param  address: 起始地址（0x000-0x3FF）
+  * @param  byte: 数据，按数组顺序写入；直接作为DMA源，可以在Flash中，不做中间拷贝
+  */
+HAL_StatusTypeDef PCap04_Memory_Access(uint8_t opcode, uint16_t address, const uint8_t *byte, uint16_t size)
 {
-  /* 将字节数组转换为双字数组 */
-  uint32_t dword_array[137];  /* 最大548字节 = 137双字 */
-  uint16_t dword_count;
-  uint8_t i;
-  
-  if(size == 0 || size > 548) {
+  if(size == 0 || address + size > PCAP04_MEM_SIZE) {
     return HAL_ERROR;
   }
-  
-  /* 计算需要的双字数量（向上取整） */
-  dword_count = (size + 3) / 4;
-  
-  /* 将字节数组转换为双字数组（小端格式） */
-  for(i = 0; i < dword_count; i++) {
-    uint16_t byte_idx = i * 4;
-    dword_array[i] = 0;
-    
-    if(byte_idx < size) {
-      dword_array[i] |= ((uint32_t)byte[byte_idx]) << 0;
-    }
-    if(byte_idx + 1 < size) {
-      dword_array[i] |= ((uint32_t)byte[byte_idx + 1]) << 8;
-    }
-    if(byte_idx + 2 < size) {
-      dword_array[i] |= ((uint32_t)byte[byte_idx + 2]) << 16;
-    }
-    if(byte_idx + 3 < size) {
-      dword_array[i] |= ((uint32_t)byte[byte_idx + 3]) << 24;
-    }
-  }
-  
-  /* 使用自动递增写入 */
-  Write_Dword_Auto_Incr(opcode, (uint8_t)address, dword_array, (uint8_t)(address + dword_count - 1));
-  
-  return HAL_OK;
+
+  return Write_Block((uint8_t)(opcode | ((address >> 8) & 0x03)), (uint8_t)address, byte, size);
 }
 
 /******************************************************************************/
 /*                         PCap04 Config Access                               */
 /******************************************************************************/
-HAL_StatusTypeDef PCap04_Config_Access(uint8_t opcode, uint8_t address, uint8_t *byte, uint8_t size)
+/**
+  * @brief  写入配置寄存器：一次DMA突发，寄存器 n 位于存储器 PCAP04_CFG_MEM_BASE + n
+  * @param  opcode: WR_CONFIG
+  * @param  address: 起始寄存器号（0-63）
+  * @param  byte: 寄存器值，直接作为DMA源（可以在Flash中）
+  */
+HAL_StatusTypeDef PCap04_Config_Access(uint8_t opcode, uint8_t address, const uint8_t *byte, uint8_t size)
 {
-  /* 将字节数组转换为双字数组 */
-  uint32_t dword_array[13];  /* 配置寄存器通常是13个双字 */
-  uint8_t dword_count;
-  uint8_t i;
-  
-  if(size == 0 || size > 52) {
+  if(size == 0 || address + size > PCAP04_CFG_SIZE) {
     return HAL_ERROR;
   }
-  
-  /* 计算需要的双字数量（向上取整） */
-  dword_count = (size + 3) / 4;
-  
-  /* 将字节数组转换为双字数组（小端格式） */
-  for(i = 0; i < dword_count && i < 13; i++) {
-    uint8_t byte_idx = i * 4;
-    dword_array[i] = 0;
-    
-    if(byte_idx < size) {
-      dword_array[i] |= ((uint32_t)byte[byte_idx]) << 0;
-    }
-    if(byte_idx + 1 < size) {
-      dword_array[i] |= ((uint32_t)byte[byte_idx + 1]) << 8;
-    }
-    if(byte_idx + 2 < size) {
-      dword_array[i] |= ((uint32_t)byte[byte_idx + 2]) << 16;
-    }
-    if(byte_idx + 3 < size) {
-      dword_array[i] |= ((uint32_t)byte[byte_idx + 3]) << 24;
+
+  return Write_Block(opcode, PCAP04_CFG_ADDR(address), byte, size);
+}
+
+/******************************************************************************/
+/*                         PCap04 Memory Read / NVRAM                         */
+/******************************************************************************/
+/**
+  * @brief  按10位存储器地址读取（RD_MEM，地址高两位在操作码中），按 PCAP04_DMA_MAX_READ 分段
+  * @param  address: 起始地址（0x000-0x3FF）
+  */
+HAL_StatusTypeDef PCap04_Read_Mem(uint16_t address, uint8_t *buf, uint16_t size)
+{
+  PCap04_Xfer_t xfer = {0};
+  uint16_t chunk;
+  HAL_StatusTypeDef status;
+
+  while(size > 0) {
+    chunk = (size < PCAP04_DMA_MAX_READ) ? size : PCAP04_DMA_MAX_READ;
+    xfer.header[0] = PCAP04_RD_MEM_CMD(address);
+    xfer.header[1] = (uint8_t)address;
+    xfer.header_len = 2;
+    xfer.dir = PCAP04_XFER_RX;
+    xfer.rx_data = buf;
+    xfer.length = chunk;
+    status = PCap04_DMA_Transfer(&xfer, PCAP04_DMA_TIMEOUT_MS);
+    if(status != HAL_OK) {
+      return status;
     }
+    address += chunk;
+    buf += chunk;
+    size -= chunk;
   }
-  
-  /* 使用自动递增写入 */
-  Write_Dword_Auto_Incr(opcode, address, dword_array, (uint8_t)(address + dword_count - 1));
-  
+  return HAL_OK;
+}
+
+/**
+  * @brief  按10位存储器地址写入（WR_MEM，地址高两位在操作码中），等待DMA完成
+  */
+HAL_StatusTypeDef PCap04_Write_Mem(uint16_t address, const uint8_t *data, uint16_t size)
+{
+  return Write_Block(PCAP04_WR_MEM_CMD(address), (uint8_t)address, data, size);
+}
+
+/**
+  * @brief  NVRAM操作：先向 MEM_CTRL 写入对应密钥，再发送操作码（同参考驱动 21211/pcap04.c）
+  * @param  opcode: NV_STORE / NV_RECALL / NV_ERASE
+  * @note   只发出命令，完成时间见 PCAP04_NV_*_MS
+  */
+HAL_StatusTypeDef PCap04_NV_Command(uint8_t opcode)
+{
+  uint8_t key;
+  HAL_StatusTypeDef status;
+
+  switch(opcode) {
+    case NV_STORE:  key = PCAP04_NV_KEY_STORE; break;
+    case NV_RECALL: key = PCAP04_NV_KEY_RECALL; break;
+    case NV_ERASE:  key = PCAP04_NV_KEY_ERASE; break;
+    default: return HAL_ERROR;
+  }
+
+  status = PCap04_Write_Mem(PCAP04_MEM_CTRL_ADDR, &key, 1);
+  if(status != HAL_OK) {
+    return status;
+  }
+  Write_Opcode(opcode);
   return HAL_OK;
 }
 
@@ -361,6 +390,60 @@ uint32_t PCap04_Read_Result(uint8_t rd_opcode, uint8_t address)
 #endif
 }
 
+/******************************************************************************/
+/*                       PCap04 Burst Read Results                            */
+/******************************************************************************/
+/**
+  * @brief  在一次片选内读取 RES0..RES7 和 STATUS_0..2（共35字节，RES6/RES7 读出后丢弃）
+  * @note   从地址0开始自动递增读取 PCAP04_RESULT_BURST_LEN 字节，完成后拉高SSN
+  *         （复位INTN，异步读模式下允许结果更新）。相比逐个寄存器读取，
+  *         多个端口只多占用数据字节，不再重复操作码和片选间隔。
+  * @param  results: 输出结果
+  * @retval HAL状态
+  */
+HAL_StatusTypeDef PCap04_Read_Results(PCap04_Results_t *results)
+{
+#if (USE_SIMULATION_MODE != 0)
+  for(uint8_t i = 0; i < PCAP04_RESULT_PORTS; i++) {
+    results->res[i] = PCap04_Generate_Random(5000, 95000);
+  }
+  results->status[0] = 0;
+  results->status[1] = 0;
+  results->status[2] = 0;
+  return HAL_OK;
+#else
+  uint8_t rx[PCAP04_RESULT_BURST_LEN] = {0};
+  PCap04_Xfer_t xfer = {0};
+  HAL_StatusTypeDef status;
+
+  xfer.header[0] = PCAP04_RD_RESULT_CMD(PCAP04_RES0_ADDR);
+  xfer.header_len = 1;
+  xfer.dir = PCAP04_XFER_RX;
+  xfer.ssn_release = 1;
+  xfer.rx_data = rx;
+  xfer.length = PCAP04_RESULT_BURST_LEN;
+
+  status = PCap04_DMA_Transfer(&xfer, PCAP04_DMA_TIMEOUT_MS);
+  PCap04_Unpack_Results(rx, results);
+  return status;
+#endif
+}
+
+/**
+  * @brief  解析突发读取数据（可在DMA完成回调中调用）
+  * @param  rx: 从地址0开始的 PCAP04_RESULT_BURST_LEN 字节
+  */
+void PCap04_Unpack_Results(const uint8_t *rx, PCap04_Results_t *results)
+{
+  for(uint8_t i = 0; i < PCAP04_RESULT_PORTS; i++) {
+    const uint8_t *p = &rx[i * 4];
+    results->res[i] = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+  }
+  results->status[0] = rx[PCAP04_STATUS0_ADDR];
+  results->status[1] = rx[PCAP04_STATUS1_ADDR];
+  results->status[2] = rx[PCAP04_STATUS2_ADDR];
+}
+
 /******************************************************************************/
 /*                         PCap04 Get Status                                 */
 /******************************************************************************/
@@ -388,9 +471,9 @@ PCap04_Status_t PCap04_Get_Status(void)
   status.is_simulation_mode = 0;
   
   /* 尝试读取配置寄存器0来判断通信是否正常 */
-  /* 注意：如果读取失败，Read_Dword可能会返回0xFFFFFFFF或0 */
-  status.config_reg0 = Read_Dword(RD_CONFIG, 0x00);
-  status.config_reg1 = Read_Dword(RD_CONFIG, 0x01);
+  /* 注意：读取失败时 Read_Dword 返回0 */
+  status.config_reg0 = Read_Dword(RD_CONFIG, PCAP04_CFG_ADDR(0));
+  status.config_reg1 = Read_Dword(RD_CONFIG, PCAP04_CFG_ADDR(1));
   
   /* 尝试读取结果寄存器 */
   status.result_reg0 = Read_Dword(RD_RESULT, 0x00);
@@ -445,14 +528,19 @@ PCap04_TestResult_t PCap04_Test_Communication(void)
   uint8_t test_data = TEST_READ;  /* 0x7E */
   uint8_t received_data = 0x00;
   HAL_StatusTypeDef hal_status;
-  uint8_t timeout = 100;  /* 100ms超时 */
+  PCap04_Xfer_t xfer = {0};
   
   /* SSN默认拉低使能，只需确保为LOW */
   Set_SSN(LOW);
   HAL_Delay(2);  /* 等待稳定 */
   
-  /* 发送TEST_READ操作码并同时接收响应 */
-  hal_status = HAL_SPI_TransmitReceive(&hspi2, &test_data, &received_data, 1, timeout);
+  /* 发送TEST_READ操作码并同时接收响应（无头部，全双工1字节） */
+  xfer.header_len = 0;
+  xfer.dir = PCAP04_XFER_RX;
+  xfer.tx_data = &test_data;
+  xfer.rx_data = &received_data;
+  xfer.length = 1;
+  hal_status = PCap04_DMA_Transfer(&xfer, 100);  /* 100ms超时 */
   
   /* SSN默认拉低使能，不需要拉高 */
   
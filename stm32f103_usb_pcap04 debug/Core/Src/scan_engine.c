@@ -0,0 +1,679 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    scan_engine.c
+  * @brief   Pipelined Matrix Scan Engine
+  *
+  * @verbatim
+  * 顺序扫描时每个点依次经历：选通 -> 建立 -> CDC_START -> 转换 -> 读取 -> 禁用，
+  * 各阶段串行执行。本引擎将其拆成流水线：
+  *
+  *   时间 -->
+  *   点N   : [建立][START][ 转换 ][读取]
+  *   点N+1 :                      [建立][START][ 转换 ][读取]
+  *
+  * 点N转换结束时，读取结果的DMA事务与切换到点N+1并等待建立同时进行；
+  * 结果寄存器在下一次CDC_START之前保持不变，DMA队列保证读取先于下一次START发出。
+  * 每点耗时约为 建立时间 + 转换时间，SPI读取、禁用多路复用器和格式化输出不再占用关键路径。
+  * 点与点之间直接切换通道，只在整帧结束时禁用多路复用器。
+  *
+  * 转换完成判定：
+  *   INTN   : INTN下降沿置位标志并在EXTI中断中直接推进状态机，转换一结束就发出读取；
+  *            结果读取完成后拉高SSN，复位INTN并允许异步读模式下的下一次结果更新。
+  *            超时则该点改用状态轮询，连续 SCAN_INTN_FAIL_LIMIT 次超时后永久切换。
+  *   STATUS : 转换期间异步读取 STATUS_0，CDC_ACTIVE 清零后再等待 SCAN_DSP_GUARD_US。
+  *   TIMED  : 固定等待 convert_us。
+  *
+  * 结果读取：每点只发一个 RD_RESULT 事务，从地址0自动递增读取 RES0..RES7 和 STATUS_0..2，
+  * 片选一次即可得到所有端口的结果和端口错误标志，启用多个端口时不增加SPI事务数。
+  * @endverbatim
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "scan_engine.h"
+#include "pcap04_spi.h"
+#include "pcap04_dma.h"
+#include "mux_control.h"
+#include "timebase.h"
+#include "scan_order.h"
+#include <string.h>
+
+/* Private define ------------------------------------------------------------*/
+#define FIFO_MASK           (SCAN_POINT_FIFO_SIZE - 1)
+
+/* 状态轮询子状态 */
+#define STATUS_IDLE         0     /* 未发出读取 */
+#define STATUS_PENDING      1     /* STATUS_0 读取在途 */
+#define STATUS_DONE         2     /* 已读回，待判断 */
+#define STATUS_CLEAR        3     /* CDC_ACTIVE 已清零，等待DSP保护时间 */
+
+/* Private variables ---------------------------------------------------------*/
+static MatrixData_t *s_matrix = NULL;
+static volatile ScanStage_t s_stage = SCAN_STAGE_IDLE;
+static uint16_t s_index = 0;                 /* 当前处于建立/转换阶段的点（扫描顺序中的序号） */
+static ScanOrder_t s_frame_order = SCAN_ORDER_BINARY;  /* 本帧扫描顺序，帧开始时锁存 */
+static volatile uint32_t s_stage_start = 0;  /* 当前阶段起始时刻（DWT周期） */
+static volatile uint8_t s_start_done = 0;    /* CDC_START 已实际发出 */
+static volatile uint8_t s_reads_pending = 0; /* 已提交但未完成的读取事务数 */
+static uint32_t s_settle_us = SCAN_MUX_SETTLE_US;
+static uint32_t s_convert_us = SCAN_CONVERT_TIME_US;
+static uint32_t s_frame_start = 0;
+static uint32_t s_last_frame_us = 0;
+static volatile uint8_t s_poll_busy = 0;     /* 防止主循环与EXTI中断重入状态机 */
+static uint8_t s_port_mask = SCAN_PORT_MASK_DEFAULT;
+static uint8_t s_frame_ports = SCAN_PORT_MASK_DEFAULT;  /* 本帧采集端口，帧开始时锁存 */
+static ScanLayout_t s_frame_layout;          /* 本帧端口/单元映射表，帧开始时锁存 */
+static uint16_t s_frame_points = MATRIX_SIZE * MATRIX_SIZE;  /* 本帧测量点数 */
+
+/* 转换完成判定 */
+#if (USE_SIMULATION_MODE != 0)
+static ScanWaitMode_t s_wait_mode = SCAN_WAIT_TIMED;
+#else
+static ScanWaitMode_t s_wait_mode = SCAN_WAIT_INTN;
+#endif
+static ScanWaitMode_t s_point_wait = SCAN_WAIT_TIMED;  /* 当前点实际使用的方式 */
+static volatile uint8_t s_intn_flag = 0;     /* CDC_START 之后收到INTN下降沿 */
+static uint8_t s_intn_fail = 0;              /* 连续INTN超时次数 */
+static volatile uint8_t s_status_state = STATUS_IDLE;
+static uint8_t s_status_rx = 0;
+static uint32_t s_status_clear = 0;          /* CDC_ACTIVE 清零时刻（DWT周期） */
+static ScanEngine_Stats_t s_stats;
+
+/* 每个在途读取事务使用独立的接收缓冲区 */
+static uint8_t s_rx_buf[2][PCAP04_RESULT_BURST_LEN];
+
+/* 已完成测量点FIFO：DMA完成中断写入，主循环读取 */
+static ScanPoint_t s_fifo[SCAN_POINT_FIFO_SIZE];
+static volatile uint8_t s_fifo_head = 0;
+static volatile uint8_t s_fifo_tail = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+static void Select_Point(uint16_t index);
+static uint8_t Fifo_Free(void);
+static void Push_Point(uint16_t index, const PCap04_Results_t *results);
+static void Latch_Layout(void);
+static HAL_StatusTypeDef Queue_Start(void);
+static HAL_StatusTypeDef Queue_Read(uint16_t index);
+static HAL_StatusTypeDef Queue_Status(void);
+static void Start_Done(const PCap04_Xfer_t *xfer);
+static void Read_Done(const PCap04_Xfer_t *xfer);
+static void Reads_Pending_Add(int8_t delta);
+static void Status_Done(const PCap04_Xfer_t *xfer);
+static uint8_t Conversion_Ready(void);
+static void Intn_Timeout(void);
+#if (USE_SIMULATION_MODE == 0)
+static void Wait_Conversion(void);
+static uint8_t Read_Status_Sync(void);
+#endif
+
+/******************************************************************************/
+/*                           Scan Engine Initialization                       */
+/******************************************************************************/
+void Scan_Engine_Init(void)
+{
+  s_matrix = NULL;
+  s_stage = SCAN_STAGE_IDLE;
+  s_index = 0;
+  s_reads_pending = 0;
+  s_fifo_head = 0;
+  s_fifo_tail = 0;
+  s_settle_us = SCAN_MUX_SETTLE_US;
+  s_convert_us = SCAN_CONVERT_TIME_US;
+  s_intn_fail = 0;
+  memset(&s_stats, 0, sizeof(s_stats));
+  Latch_Layout();
+}
+
+/**
+  * @brief  设置建立时间和转换等待时间（微秒）
+  */
+void Scan_Engine_Set_Timing(uint32_t settle_us, uint32_t convert_us)
+{
+  s_settle_us = settle_us;
+  s_convert_us = convert_us;
+}
+
+/**
+  * @brief  设置转换完成判定方式（模拟模式下固定为TIMED）
+  */
+void Scan_Engine_Set_Wait_Mode(ScanWaitMode_t mode)
+{
+#if (USE_SIMULATION_MODE != 0)
+  (void)mode;
+  s_wait_mode = SCAN_WAIT_TIMED;
+#else
+  s_wait_mode = mode;
+#endif
+  s_intn_fail = 0;
+}
+
+ScanWaitMode_t Scan_Engine_Get_Wait_Mode(void)
+{
+  return s_wait_mode;
+}
+
+void Scan_Engine_Get_Stats(ScanEngine_Stats_t *stats)
+{
+  *stats = s_stats;
+  stats->wait_mode = s_wait_mode;
+  stats->last_frame_us = s_last_frame_us;
+}
+
+/**
+  * @brief  设置每点采集的PCap04端口（下一帧生效）
+  * @param  mask: 位0..5 对应 PC0..PC5，为0时恢复默认
+  */
+void Scan_Engine_Set_Port_Mask(uint8_t mask)
+{
+  mask &= PCAP04_PORT_MASK_ALL;
+  s_port_mask = (mask != 0) ? mask : SCAN_PORT_MASK_DEFAULT;
+}
+
+uint8_t Scan_Engine_Get_Port_Mask(void)
+{
+  return s_port_mask;
+}
+
+/******************************************************************************/
+/*                              Start One Frame                               */
+/******************************************************************************/
+void Scan_Engine_Start(MatrixData_t *matrix)
+{
+  /* 上一帧中途停止时可能仍有结果读取/CDC_START/STATUS事务在DMA上，
+   * 先等它们完成（超时则终止），否则其完成回调会计入新帧：在途计数下溢或写入旧点 */
+  if(PCap04_DMA_Is_Busy()) {
+    PCap04_DMA_Wait_Idle(PCAP04_DMA_TIMEOUT_MS);
+  }
+
+  s_matrix = matrix;
+  s_index = 0;
+  s_reads_pending = 0;
+  s_start_done = 0;
+  s_status_state = STATUS_IDLE;
+  s_fifo_head = 0;
+  s_fifo_tail = 0;
+  s_frame_start = Timebase_Cycles();
+  if(matrix != NULL) {
+    matrix->timestamp_us = Timebase_Micros();
+  }
+  s_frame_order = Scan_Order_Get();
+  Latch_Layout();
+
+  /* 流水线第一级：选通第一个点 */
+  Select_Point(0);
+  s_stage_start = Timebase_Cycles();
+  s_stage = SCAN_STAGE_SETTLE;
+}
+
+/******************************************************************************/
+/*                           Advance State Machine                            */
+/******************************************************************************/
+/**
+  * @brief  推进流水线状态机，需在主循环（包括等待USB发送期间）中反复调用
+  * @retval 当前阶段
+  */
+ScanStage_t Scan_Engine_Poll(void)
+{
+  /* EXTI中断打断主循环中的Poll时直接返回，标志位已置位，主循环下次调用时处理 */
+  if(s_poll_busy) {
+    return s_stage;
+  }
+  s_poll_busy = 1;
+
+  switch(s_stage) {
+    case SCAN_STAGE_SETTLE:
+      /* 建立时间到 -> 触发转换（DMA队列满则下次重试） */
+      if(Timebase_Elapsed_Us(s_stage_start) < s_settle_us) {
+        break;
+      }
+      if(Queue_Start() != HAL_OK) {
+        break;
+      }
+      s_stage = SCAN_STAGE_CONVERT;
+      break;
+
+    case SCAN_STAGE_CONVERT:
+      /* 等待CDC_START实际发出并且转换完成 */
+      if(!s_start_done || !Conversion_Ready()) {
+        break;
+      }
+      /* 消费者跟不上时暂停流水线，不丢点 */
+      if(s_reads_pending >= 2 || Fifo_Free() <= s_reads_pending) {
+        break;
+      }
+      if(Queue_Read(s_index) != HAL_OK) {
+        break;
+      }
+
+      /* 读取点N的同时切换到点N+1开始建立 */
+      s_index++;
+      if(s_index < s_frame_points) {
+        Select_Point(s_index);
+        s_stage_start = Timebase_Cycles();
+        s_stage = SCAN_STAGE_SETTLE;
+      } else {
+        s_stage = SCAN_STAGE_DRAIN;
+      }
+      break;
+
+    case SCAN_STAGE_DRAIN:
+      if(s_reads_pending == 0) {
+        /* 整帧结束：禁用多路复用器 */
+        MUX_Fast_Disable();
+        s_last_frame_us = Timebase_Elapsed_Us(s_frame_start);
+        if(s_matrix != NULL) {
+          s_matrix->end_us = Timebase_Micros();
+        }
+        s_stage = SCAN_STAGE_DONE;
+      }
+      break;
+
+    case SCAN_STAGE_IDLE:
+    case SCAN_STAGE_DONE:
+    default:
+      break;
+  }
+
+  s_poll_busy = 0;
+  return s_stage;
+}
+
+/******************************************************************************/
+/*                          Blocking Single Point                             */
+/******************************************************************************/
+/**
+  * @brief  阻塞式单点测量：选通 -> 建立 -> CDC_START -> 等待转换完成 -> 突发读取结果
+  * @note   可在USB中断上下文中调用（SCAN_POINT命令），此时INTN通过EXTI挂起位判定
+  * @retval 端口掩码中编号最小端口的结果
+  */
+uint32_t Scan_Engine_Measure_Point(uint8_t row, uint8_t col)
+{
+  PCap04_Results_t results = {0};
+  ScanLayout_t layout;
+  uint8_t port = 0;
+  uint8_t mux_col = col;
+
+  /* 按当前布局找到测量该单元的端口和列多路复用器位置 */
+  Scan_Layout_Build(Scan_Layout_Get(), s_port_mask, &layout);
+  Scan_Layout_Locate(&layout, col, &port, &mux_col);
+
+  MUX_Fast_Select(row, mux_col);
+  Timebase_Delay_Us(s_settle_us);
+
+#if (USE_SIMULATION_MODE != 0)
+  Timebase_Delay_Us(s_convert_us);
+#else
+  s_intn_flag = 0;
+  __HAL_GPIO_EXTI_CLEAR_IT(PCAP04_INTN_Pin);
+  Write_Opcode(CDC_START);  /* 0x8C */
+  Wait_Conversion();
+#endif
+
+  /* 读取后拉高SSN，复位INTN */
+  PCap04_Read_Results(&results);
+
+  MUX_Fast_Disable();
+
+  return results.res[port];
+}
+
+/**
+  * @brief  本帧测量点数：16 x 列多路复用器位置数
+  */
+uint16_t Scan_Engine_Frame_Points(void)
+{
+  return s_frame_points;
+}
+
+/**
+  * @brief  按本帧映射表展开一个测量点
+  * @param  cols: 输出矩阵列（至少 PCAP04_RESULT_PORTS 个）
+  * @param  values: 输出对应的值
+  * @retval 单元数
+  */
+uint8_t Scan_Engine_Point_Cells(const ScanPoint_t *point, uint8_t *cols, uint32_t *values)
+{
+  uint8_t n = 0;
+
+  for(uint8_t i = 0; i < PCAP04_RESULT_PORTS; i++) {
+    if(point->cell_ports & (1U << i)) {
+      cols[n] = (uint8_t)(s_frame_layout.col_base[i] + point->col);
+      values[n] = point->res[i];
+      n++;
+    }
+  }
+  return n;
+}
+
+/******************************************************************************/
+/*                             Result Point FIFO                              */
+/******************************************************************************/
+uint8_t Scan_Engine_Pop_Point(ScanPoint_t *point)
+{
+  if(s_fifo_tail == s_fifo_head) {
+    return 0;
+  }
+
+  *point = s_fifo[s_fifo_tail & FIFO_MASK];
+  s_fifo_tail++;
+  return 1;
+}
+
+uint8_t Scan_Engine_Is_Done(void)
+{
+  return (s_stage == SCAN_STAGE_DONE && s_fifo_tail == s_fifo_head) ? 1 : 0;
+}
+
+uint32_t Scan_Engine_Last_Frame_Us(void)
+{
+  return s_last_frame_us;
+}
+
+/******************************************************************************/
+/*                              Private Helpers                               */
+/******************************************************************************/
+static void Select_Point(uint16_t index)
+{
+  uint8_t row, col;
+
+  /* 按扫描顺序选通；帧内不禁用多路复用器，格雷码顺序下每步只翻转一根选择线 */
+  Scan_Order_Point_Cols(s_frame_order, index, s_frame_layout.col_bits, &row, &col);
+  MUX_Fast_Select(row, col);
+}
+
+static uint8_t Fifo_Free(void)
+{
+  return (uint8_t)(SCAN_POINT_FIFO_SIZE - (uint8_t)(s_fifo_head - s_fifo_tail));
+}
+
+/**
+  * @brief  存储一个完成点（DMA完成中断或模拟模式下的主循环中调用）
+  */
+static void Push_Point(uint16_t index, const PCap04_Results_t *results)
+{
+  ScanPoint_t *slot = &s_fifo[s_fifo_head & FIFO_MASK];
+
+  /* 按扫描顺序还原行和列位置 */
+  Scan_Order_Point_Cols(s_frame_order, index, s_frame_layout.col_bits, &slot->row, &slot->col);
+  slot->cell_ports = s_frame_layout.port_mask;
+  slot->port_err = results->status[2] & s_frame_ports;
+  slot->value = 0;
+  if(slot->port_err) {
+    s_stats.port_errors++;
+  }
+
+  /* 每个映射端口写入一个矩阵单元：列 = col_base[端口] + 列位置 */
+  for(uint8_t i = PCAP04_RESULT_PORTS; i-- > 0; ) {
+    slot->res[i] = (s_frame_ports & (1U << i)) ? results->res[i] : 0;
+    if(s_frame_layout.port_mask & (1U << i)) {
+      slot->value = results->res[i];
+      if(s_matrix != NULL) {
+        s_matrix->capacitance[slot->row][s_frame_layout.col_base[i] + slot->col] = results->res[i];
+      }
+    }
+  }
+
+  s_fifo_head++;
+}
+
+/**
+  * @brief  帧开始时锁存端口/单元映射表，映射端口总是包含在采集端口中
+  */
+static void Latch_Layout(void)
+{
+  Scan_Layout_Build(Scan_Layout_Get(), s_port_mask, &s_frame_layout);
+  s_frame_ports = s_port_mask | s_frame_layout.port_mask;
+  s_frame_points = (uint16_t)(MATRIX_SIZE << s_frame_layout.col_bits);
+}
+
+static HAL_StatusTypeDef Queue_Start(void)
+{
+  s_start_done = 0;
+  s_status_state = STATUS_IDLE;
+  s_point_wait = s_wait_mode;
+  return PCap04_DMA_Queue_Opcode(CDC_START, Start_Done, NULL);  /* 0x8C */
+}
+
+static HAL_StatusTypeDef Queue_Read(uint16_t index)
+{
+#if (USE_SIMULATION_MODE != 0)
+  /* 模拟模式：直接生成随机数据 */
+  PCap04_Results_t results;
+  PCap04_Read_Results(&results);
+  Push_Point(index, &results);
+  return HAL_OK;
+#else
+  HAL_StatusTypeDef status;
+  PCap04_Xfer_t xfer = {0};
+
+  /* 一次片选读取 RES0..RES7 + STATUS_0..2；完成后拉高SSN：复位INTN，异步读模式下允许下一次转换更新结果 */
+  xfer.header[0] = PCAP04_RD_RESULT_CMD(PCAP04_RES0_ADDR);
+  xfer.header_len = 1;
+  xfer.dir = PCAP04_XFER_RX;
+  xfer.ssn_release = 1;
+  xfer.rx_data = s_rx_buf[index & 1];
+  xfer.length = PCAP04_RESULT_BURST_LEN;
+  xfer.callback = Read_Done;
+  xfer.context = (void *)(uintptr_t)index;
+
+  /* 先计数再提交，避免完成中断先于计数执行 */
+  Reads_Pending_Add(1);
+  status = PCap04_DMA_Submit(&xfer);
+  if(status != HAL_OK) {
+    Reads_Pending_Add(-1);
+  }
+  return status;
+#endif
+}
+
+/**
+  * @brief  异步读取 STATUS_0（单字节命令 0x40 | 0x20）
+  */
+static HAL_StatusTypeDef Queue_Status(void)
+{
+  PCap04_Xfer_t xfer = {0};
+
+  xfer.header[0] = PCAP04_RD_RESULT_CMD(PCAP04_STATUS0_ADDR);
+  xfer.header_len = 1;
+  xfer.dir = PCAP04_XFER_RX;
+  xfer.rx_data = &s_status_rx;
+  xfer.length = 1;
+  xfer.callback = Status_Done;
+
+  return PCap04_DMA_Submit(&xfer);
+}
+
+/**
+  * @brief  CDC_START 发送完成：从此刻开始计算转换时间
+  */
+static void Start_Done(const PCap04_Xfer_t *xfer)
+{
+  (void)xfer;
+  s_intn_flag = 0;
+  s_stage_start = Timebase_Cycles();
+  s_start_done = 1;
+}
+
+/**
+  * @brief  结果突发读取完成（DMA中断上下文）
+  */
+static void Read_Done(const PCap04_Xfer_t *xfer)
+{
+  uint16_t index = (uint16_t)(uintptr_t)xfer->context;
+  PCap04_Results_t results = {0};
+
+  if(xfer->status == HAL_OK) {
+    PCap04_Unpack_Results(xfer->rx_data, &results);
+  }
+
+  Push_Point(index, &results);
+  Reads_Pending_Add(-1);
+}
+
+/**
+  * @brief  修改在途读取计数
+  * @note   提交在主循环或EXTI中断、完成在DMA中断，读-改-写可能被对方打断而丢失一次更新，
+  *         需关中断执行
+  */
+static void Reads_Pending_Add(int8_t delta)
+{
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  s_reads_pending = (uint8_t)(s_reads_pending + delta);
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  STATUS_0 读取完成（DMA中断上下文）
+  */
+static void Status_Done(const PCap04_Xfer_t *xfer)
+{
+  /* 读取失败时按"仍在转换"处理，下次Poll重新读取 */
+  s_status_rx = (xfer->status == HAL_OK) ? xfer->rx_data[0] : PCAP04_STATUS0_CDC_ACTIVE;
+  s_status_state = STATUS_DONE;
+}
+
+/**
+  * @brief  判断当前点转换是否完成（仅在CONVERT阶段由Poll调用）
+  * @retval 1=可以读取结果, 0=继续等待
+  */
+static uint8_t Conversion_Ready(void)
+{
+  uint32_t elapsed = Timebase_Elapsed_Us(s_stage_start);
+
+  switch(s_point_wait) {
+    case SCAN_WAIT_INTN:
+      if(s_intn_flag) {
+        s_intn_fail = 0;
+        return 1;
+      }
+      if(elapsed >= SCAN_CONVERT_TIMEOUT_US) {
+        /* 该点改用状态轮询，重新计时 */
+        Intn_Timeout();
+        s_point_wait = SCAN_WAIT_STATUS;
+        s_stage_start = Timebase_Cycles();
+      }
+      return 0;
+
+    case SCAN_WAIT_STATUS:
+      switch(s_status_state) {
+        case STATUS_IDLE:
+          if(elapsed >= SCAN_CONVERT_TIMEOUT_US) {
+            s_stats.status_timeouts++;
+            return 1;
+          }
+          if(Queue_Status() == HAL_OK) {
+            s_status_state = STATUS_PENDING;
+            s_stats.status_polls++;
+          }
+          return 0;
+
+        case STATUS_DONE:
+          if(s_status_rx & PCAP04_STATUS0_CDC_ACTIVE) {
+            s_status_state = STATUS_IDLE;
+          } else {
+            s_status_clear = Timebase_Cycles();
+            s_status_state = STATUS_CLEAR;
+          }
+          return 0;
+
+        case STATUS_CLEAR:
+          return (Timebase_Elapsed_Us(s_status_clear) >= SCAN_DSP_GUARD_US) ? 1 : 0;
+
+        case STATUS_PENDING:
+        default:
+          return 0;
+      }
+
+    case SCAN_WAIT_TIMED:
+    default:
+      return (elapsed >= s_convert_us) ? 1 : 0;
+  }
+}
+
+/**
+  * @brief  记录一次INTN超时，连续超时达到上限后切换为状态轮询
+  */
+static void Intn_Timeout(void)
+{
+  s_stats.intn_timeouts++;
+  if(++s_intn_fail >= SCAN_INTN_FAIL_LIMIT) {
+    s_wait_mode = SCAN_WAIT_STATUS;
+  }
+}
+
+#if (USE_SIMULATION_MODE == 0)
+/**
+  * @brief  阻塞等待转换完成（Scan_Engine_Measure_Point使用）
+  */
+static void Wait_Conversion(void)
+{
+  uint32_t start = Timebase_Cycles();
+  ScanWaitMode_t mode = s_wait_mode;
+
+  if(mode == SCAN_WAIT_INTN) {
+    /* 在USB中断中调用时EXTI无法抢占，同时检查挂起位 */
+    while(!s_intn_flag && !__HAL_GPIO_EXTI_GET_IT(PCAP04_INTN_Pin)) {
+      if(Timebase_Elapsed_Us(start) >= SCAN_CONVERT_TIMEOUT_US) {
+        Intn_Timeout();
+        mode = SCAN_WAIT_STATUS;
+        start = Timebase_Cycles();
+        break;
+      }
+    }
+    if(mode == SCAN_WAIT_INTN) {
+      s_intn_fail = 0;
+      return;
+    }
+  }
+
+  if(mode == SCAN_WAIT_STATUS) {
+    do {
+      if((Read_Status_Sync() & PCAP04_STATUS0_CDC_ACTIVE) == 0) {
+        Timebase_Delay_Us(SCAN_DSP_GUARD_US);
+        return;
+      }
+    } while(Timebase_Elapsed_Us(start) < SCAN_CONVERT_TIMEOUT_US);
+    s_stats.status_timeouts++;
+    return;
+  }
+
+  Timebase_Delay_Us(s_convert_us);
+}
+
+/**
+  * @brief  同步读取 STATUS_0，失败时返回 CDC_ACTIVE
+  */
+static uint8_t Read_Status_Sync(void)
+{
+  uint8_t status = 0;
+  PCap04_Xfer_t xfer = {0};
+
+  xfer.header[0] = PCAP04_RD_RESULT_CMD(PCAP04_STATUS0_ADDR);
+  xfer.header_len = 1;
+  xfer.dir = PCAP04_XFER_RX;
+  xfer.rx_data = &status;
+  xfer.length = 1;
+
+  s_stats.status_polls++;
+  if(PCap04_DMA_Transfer(&xfer, PCAP04_DMA_TIMEOUT_MS) != HAL_OK) {
+    return PCAP04_STATUS0_CDC_ACTIVE;
+  }
+  return status;
+}
+#endif
+
+/**
+  * @brief  EXTI回调：PCap04 INTN 下降沿表示新结果就绪
+  */
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+  if(GPIO_Pin == PCAP04_INTN_Pin) {
+    s_intn_flag = 1;
+    s_stats.intn_events++;
+    /* 立即推进状态机，不等主循环 */
+    Scan_Engine_Poll();
+  }
+}
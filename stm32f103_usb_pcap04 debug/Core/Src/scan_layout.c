@@ -0,0 +1,98 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    scan_layout.c
+  * @brief   Multi-Port Matrix Layout (PCap04 Port -> Matrix Cell Table)
+  *
+  * @verbatim
+  * 单端口接线下每次转换只得到一个单元，而结果突发读取本来就返回全部6个端口。
+  * 把矩阵列分组接到多个端口后，列多路复用器只需走 16 / 端口数 个位置，
+  * 每帧转换次数按端口数成比例减少。标准配置 C_PORT_EN = 0x0F 已启用 PC0-PC3。
+  * @endverbatim
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "scan_layout.h"
+
+/* Private variables ---------------------------------------------------------*/
+/* 端口/单元映射表，按 ScanLayoutId_t 索引 */
+static const ScanLayout_t s_layouts[] = {
+  /* SINGLE: PC0 -> 列0-15（实际端口由端口掩码决定） */
+  { 0x01, 4, { 0, SCAN_LAYOUT_NO_CELL, SCAN_LAYOUT_NO_CELL, SCAN_LAYOUT_NO_CELL, SCAN_LAYOUT_NO_CELL, SCAN_LAYOUT_NO_CELL } },
+  /* DUAL: PC0 -> 列0-7, PC1 -> 列8-15 */
+  { 0x03, 3, { 0, 8, SCAN_LAYOUT_NO_CELL, SCAN_LAYOUT_NO_CELL, SCAN_LAYOUT_NO_CELL, SCAN_LAYOUT_NO_CELL } },
+  /* QUAD: PC0 -> 列0-3, PC1 -> 列4-7, PC2 -> 列8-11, PC3 -> 列12-15 */
+  { 0x0F, 2, { 0, 4, 8, 12, SCAN_LAYOUT_NO_CELL, SCAN_LAYOUT_NO_CELL } },
+};
+
+static ScanLayoutId_t s_layout = SCAN_LAYOUT_SINGLE;
+
+/******************************************************************************/
+/*                            Layout Configuration                            */
+/******************************************************************************/
+void Scan_Layout_Set(ScanLayoutId_t id)
+{
+  if(id > SCAN_LAYOUT_QUAD) {
+    id = SCAN_LAYOUT_SINGLE;
+  }
+  s_layout = id;
+}
+
+ScanLayoutId_t Scan_Layout_Get(void)
+{
+  return s_layout;
+}
+
+const char *Scan_Layout_Name(ScanLayoutId_t id)
+{
+  switch(id) {
+    case SCAN_LAYOUT_DUAL: return "DUAL";
+    case SCAN_LAYOUT_QUAD: return "QUAD";
+    default: return "SINGLE";
+  }
+}
+
+/**
+  * @brief  生成一帧使用的映射表
+  * @param  id: 布局
+  * @param  port_mask: 采集端口掩码（SINGLE 布局下取编号最小的端口作为单元值）
+  * @param  layout: 输出映射表
+  */
+void Scan_Layout_Build(ScanLayoutId_t id, uint8_t port_mask, ScanLayout_t *layout)
+{
+  if(id > SCAN_LAYOUT_QUAD) {
+    id = SCAN_LAYOUT_SINGLE;
+  }
+  *layout = s_layouts[id];
+
+  if(id == SCAN_LAYOUT_SINGLE) {
+    for(uint8_t i = 0; i < PCAP04_RESULT_PORTS; i++) {
+      if(port_mask & (1U << i)) {
+        layout->col_base[0] = SCAN_LAYOUT_NO_CELL;
+        layout->col_base[i] = 0;
+        layout->port_mask = (uint8_t)(1U << i);
+        break;
+      }
+    }
+  }
+}
+
+/**
+  * @brief  查找矩阵列由哪个端口、哪个列多路复用器位置测量
+  * @retval 1=找到, 0=该列不在映射表中
+  */
+uint8_t Scan_Layout_Locate(const ScanLayout_t *layout, uint8_t col, uint8_t *port, uint8_t *mux_col)
+{
+  uint8_t width = (uint8_t)(1U << layout->col_bits);
+
+  for(uint8_t i = 0; i < PCAP04_RESULT_PORTS; i++) {
+    uint8_t base = layout->col_base[i];
+    if(base != SCAN_LAYOUT_NO_CELL && col >= base && col < base + width) {
+      *port = i;
+      *mux_col = (uint8_t)(col - base);
+      return 1;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,102 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    scan_order.c
+  * @brief   Matrix Scan Order Generator
+  *
+  * @verbatim
+  * 二进制顺序下列通道 7->8 会同时翻转4根选择线，行末 15->0 也是4根，
+  * 多根选择线同时切换注入的电荷更多，需要更长的建立时间。
+  * 格雷码顺序每步只翻转一根选择线（行或列），蛇形顺序保证换行时列不跳变。
+  * 点序号到行列的映射直接计算，不占用查找表RAM。
+  * @endverbatim
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "scan_order.h"
+#include "matrix_scan.h"
+
+#if (MATRIX_SIZE != 16)
+#error "scan_order assumes a 16x16 matrix (4 select lines per multiplexer)"
+#endif
+
+/* Private variables ---------------------------------------------------------*/
+static ScanOrder_t s_order = SCAN_ORDER_GRAY;
+
+/******************************************************************************/
+/*                            Order Configuration                             */
+/******************************************************************************/
+void Scan_Order_Set(ScanOrder_t order)
+{
+  if(order > SCAN_ORDER_GRAY) {
+    order = SCAN_ORDER_BINARY;
+  }
+  s_order = order;
+}
+
+ScanOrder_t Scan_Order_Get(void)
+{
+  return s_order;
+}
+
+const char *Scan_Order_Name(ScanOrder_t order)
+{
+  switch(order) {
+    case SCAN_ORDER_SERPENTINE: return "SERPENTINE";
+    case SCAN_ORDER_GRAY: return "GRAY";
+    default: return "BINARY";
+  }
+}
+
+/******************************************************************************/
+/*                            Step -> Row/Column                              */
+/******************************************************************************/
+/**
+  * @brief  计算扫描顺序中第step个点的行列
+  * @param  order: 扫描顺序
+  * @param  step: 点序号 (0 到 MATRIX_SIZE*MATRIX_SIZE-1)
+  * @param  row, col: 输出行列 (0-15)
+  */
+void Scan_Order_Point(ScanOrder_t order, uint16_t step, uint8_t *row, uint8_t *col)
+{
+  Scan_Order_Point_Cols(order, step, 4, row, col);
+}
+
+/**
+  * @brief  每行只有 1 << col_bits 个列位置时计算第step个点的行和列位置
+  * @param  step: 点序号 (0 到 (MATRIX_SIZE << col_bits)-1)
+  * @param  col_bits: 列位置位数 (0-4)
+  * @param  row: 输出行 (0-15)
+  * @param  col: 输出列位置 (0 到 (1 << col_bits)-1)
+  */
+void Scan_Order_Point_Cols(ScanOrder_t order, uint16_t step, uint8_t col_bits, uint8_t *row, uint8_t *col)
+{
+  uint8_t col_mask = (uint8_t)((1U << col_bits) - 1U);
+  uint8_t r = (uint8_t)((step >> col_bits) & 0x0F);
+  uint8_t c = (uint8_t)(step & col_mask);
+
+  switch(order) {
+    case SCAN_ORDER_SERPENTINE:
+      if(r & 0x01) {
+        c = (uint8_t)(col_mask - c);
+      }
+      break;
+
+    case SCAN_ORDER_GRAY:
+      {
+        /* (4+col_bits)位反射格雷码：高4位为行的格雷码，低位列在奇数行自动反向 */
+        uint16_t g = (uint16_t)(step ^ (step >> 1));
+        r = (uint8_t)((g >> col_bits) & 0x0F);
+        c = (uint8_t)(g & col_mask);
+      }
+      break;
+
+    case SCAN_ORDER_BINARY:
+    default:
+      break;
+  }
+
+  *row = r;
+  *col = c;
+}
@@ -0,0 +1,169 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    text_format.c
+  * @brief   Fast Text Formatter for TABLE/SIMPLE Output
+  *
+  * @verbatim
+  * 表格格式一帧有256个 ",%lu" 和17个 "%02d"，newlib 的 sprintf 每次都要解析
+  * 格式串、走通用的可变参数路径，在没有FPU的Cortex-M3上是文本模式的主要开销。
+  *
+  * Text_Format_U32：先比较得到位数，再从低位起每次除以100、查两位数字表
+  * 写两个字符（M3有硬件除法），位数最多10位时只需5次除法。
+  * 列标题行在初始化时生成一次，之后每帧直接复制。
+  * @endverbatim
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "text_format.h"
+#include "matrix_scan.h"
+#include <string.h>
+
+/* Private variables ---------------------------------------------------------*/
+/* "00" "01" ... "99" */
+static const char s_digit_pairs[200] = {
+  '0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
+  '1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
+  '2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
+  '3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
+  '4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
+  '5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
+  '6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
+  '7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
+  '8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
+  '9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9'
+};
+
+/* 列标题行："X00,X01,...,X15\r\n" */
+static char s_col_header[MATRIX_SIZE * 4 + 2];
+static uint8_t s_col_header_len = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+static uint8_t Decimal_Digits(uint32_t value);
+
+/******************************************************************************/
+/*                              Initialization                                */
+/******************************************************************************/
+void Text_Format_Init(void)
+{
+  char *p = s_col_header;
+  uint8_t col;
+
+  for(col = 0; col < MATRIX_SIZE; col++) {
+    if(col > 0) {
+      *p++ = ',';
+    }
+    p = Text_Format_Label(p, 'X', col);
+  }
+  *p++ = '\r';
+  *p++ = '\n';
+  s_col_header_len = (uint8_t)(p - s_col_header);
+}
+
+/******************************************************************************/
+/*                                 Formatters                                 */
+/******************************************************************************/
+/**
+  * @brief  无符号32位整数转十进制（无前导0，0输出"0"）
+  * @retval 末尾指针
+  */
+char *Text_Format_U32(char *p, uint32_t value)
+{
+  char *end = p + Decimal_Digits(value);
+  char *q = end;
+  uint32_t pair;
+
+  while(value >= 100) {
+    pair = (value % 100) * 2;
+    value /= 100;
+    q -= 2;
+    q[0] = s_digit_pairs[pair];
+    q[1] = s_digit_pairs[pair + 1];
+  }
+  if(value >= 10) {
+    q[-2] = s_digit_pairs[value * 2];
+    q[-1] = s_digit_pairs[value * 2 + 1];
+  } else {
+    q[-1] = (char)('0' + value);
+  }
+  return end;
+}
+
+char *Text_Format_Label(char *p, char axis, uint8_t index)
+{
+  p[0] = axis;
+  p[1] = s_digit_pairs[index * 2];
+  p[2] = s_digit_pairs[index * 2 + 1];
+  return p + 3;
+}
+
+char *Text_Format_Str(char *p, const char *s)
+{
+  while(*s != '\0') {
+    *p++ = *s++;
+  }
+  return p;
+}
+
+char *Text_Format_Col_Header(char *p)
+{
+  if(s_col_header_len == 0) {
+    Text_Format_Init();
+  }
+  memcpy(p, s_col_header, s_col_header_len);
+  return p + s_col_header_len;
+}
+
+char *Text_Format_Simple_Point(char *p, uint8_t col, uint8_t row, uint32_t value)
+{
+  p = Text_Format_Label(p, 'X', col);
+  p = Text_Format_Label(p, 'Y', row);
+  *p++ = ':';
+  p = Text_Format_U32(p, value);
+  *p++ = '\r';
+  *p++ = '\n';
+  return p;
+}
+
+/**
+  * @brief  帧标记行："START:序号,微秒\r\n" / "END:序号,微秒\r\n"
+  *         不带参数的 START/END 仍用于会话开始/结束和单点输出
+  */
+char *Text_Format_Marker(char *p, const char *tag, uint32_t seq, uint32_t us)
+{
+  p = Text_Format_Str(p, tag);
+  *p++ = ':';
+  p = Text_Format_U32(p, seq);
+  *p++ = ',';
+  p = Text_Format_U32(p, us);
+  *p++ = '\r';
+  *p++ = '\n';
+  return p;
+}
+
+/******************************************************************************/
+/*                              Private Helpers                               */
+/******************************************************************************/
+/**
+  * @brief  十进制位数（比较次数最多4次）
+  */
+static uint8_t Decimal_Digits(uint32_t value)
+{
+  if(value < 100000UL) {
+    if(value < 100UL) {
+      return (value < 10UL) ? 1 : 2;
+    }
+    if(value < 10000UL) {
+      return (value < 1000UL) ? 3 : 4;
+    }
+    return 5;
+  }
+  if(value < 10000000UL) {
+    return (value < 1000000UL) ? 6 : 7;
+  }
+  if(value < 1000000000UL) {
+    return (value < 100000000UL) ? 8 : 9;
+  }
+  return 10;
+}
@@ -0,0 +1,88 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    timebase.c
+  * @brief   Microsecond Timebase (Cortex-M3 DWT Cycle Counter)
+  *
+  * @verbatim
+  * HAL_GetTick() 只有1ms分辨率，不足以调度多路复用器建立时间和单点转换时间。
+  * 这里使用DWT->CYCCNT（72MHz下分辨率约14ns），以周期差值计算经过时间，
+  * 因此32位回绕不影响差值计算（单次间隔不超过约59秒即可）。
+ * 绝对时间戳 Timebase_Micros() 则由HAL毫秒节拍和SysTick计数值组合得到。
+  * @endverbatim
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "timebase.h"
+
+/* Private variables ---------------------------------------------------------*/
+static uint32_t s_cycles_per_us = 72;
+
+/******************************************************************************/
+/*                              Timebase Init                                 */
+/******************************************************************************/
+void Timebase_Init(void)
+{
+  s_cycles_per_us = SystemCoreClock / 1000000U;
+  if(s_cycles_per_us == 0) {
+    s_cycles_per_us = 1;
+  }
+
+  /* 使能跟踪模块并启动周期计数器 */
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/******************************************************************************/
+/*                              Timebase Read                                 */
+/******************************************************************************/
+uint32_t Timebase_Cycles(void)
+{
+  return DWT->CYCCNT;
+}
+
+/**
+  * @brief  系统运行微秒数 = HAL毫秒节拍 * 1000 + SysTick当前毫秒内的偏移
+  * @note   不依赖CYCCNT，32位按微秒连续回绕（约71分钟），适合做时间戳
+  * @note   关中断或在不低于SysTick优先级的中断中调用时，SysTick计到0后节拍中断挂起、
+  *         uwTick尚未加1，此时按挂起位补1ms，否则时间戳会比上一次倒退最多1ms
+  */
+uint32_t Timebase_Micros(void)
+{
+  uint32_t tick;
+  uint32_t ms;
+  uint32_t val;
+
+  /* 读取期间若发生SysTick中断则重读，保证毫秒与计数值一致 */
+  do {
+    tick = HAL_GetTick();
+    ms = tick;
+    val = SysTick->VAL;
+    if(SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) {
+      /* 已回绕但节拍未处理；VAL可能是回绕前读到的，重读取回绕后的值 */
+      val = SysTick->VAL;
+      ms += 1U;
+    }
+  } while(tick != HAL_GetTick());
+
+  return ms * 1000U + (SysTick->LOAD - val) / s_cycles_per_us;
+}
+
+uint32_t Timebase_Elapsed_Us(uint32_t start_cycles)
+{
+  return (DWT->CYCCNT - start_cycles) / s_cycles_per_us;
+}
+
+/******************************************************************************/
+/*                              Timebase Delay                                */
+/******************************************************************************/
+void Timebase_Delay_Us(uint32_t us)
+{
+  uint32_t start = DWT->CYCCNT;
+  uint32_t cycles = us * s_cycles_per_us;
+
+  while((DWT->CYCCNT - start) < cycles) {
+  }
+}
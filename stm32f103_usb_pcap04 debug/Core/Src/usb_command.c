@@ -11,6 +11,14 @@
 #include "usbd_cdc_if.h"
 #include "matrix_scan.h"
 #include "pcap04_spi.h"
+#include "scan_engine.h"
+#include "scan_order.h"
+#include "scan_layout.h"
+#include "frame_stream.h"
+#include "frame_sched.h"
+#include "frame_codec.h"
+#include "boot_seq.h"
+#include "pcap04_image.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -22,6 +30,7 @@ extern uint32_t Quantize_Value(uint32_t raw_value, uint32_t min_val, uint32_t ma
 WorkMode_t g_work_mode = MODE_NORMAL;
 static WorkMode_t g_last_work_mode = MODE_NORMAL;  /* 保存上一次的工作模式，用于START时恢复 */
 uint32_t g_scan_delay_ms = 100;  /* 默认100ms */
+uint32_t g_scan_period_us = 100000;  /* 默认100ms帧周期 */
 uint8_t g_current_row = 0;       /* 当前行通道 (0-15) */
 uint8_t g_current_col = 0;       /* 当前列通道 (0-15) */
 OutputMode_t g_output_mode = OUTPUT_RAW;  /* 默认原始值模式 */
@@ -31,6 +40,16 @@ uint32_t g_quant_max = 100000;             /* 量化最大值（默认10万） *
 QuantLevel_t g_quant_level = QUANT_LEVEL_255;  /* 默认255档位 */
 volatile uint8_t g_stream_enabled = 0; /* START/STOP 会话开关 */
 
+/* 命令接收：USB中断只写环形缓冲区，主循环拼行执行（读写索引自由递增，按掩码取模） */
+static uint8_t s_rx_ring[USB_CMD_RX_RING_SIZE];
+static volatile uint16_t s_rx_head = 0;    /* 中断写入 */
+static volatile uint16_t s_rx_tail = 0;    /* 主循环读出 */
+static uint8_t s_rx_resync = 0;            /* 丢过包，中断跳到下一个行结束符再继续写入 */
+static uint32_t s_rx_dropped = 0;
+static char s_line[USB_CMD_LINE_MAX + 1];  /* 正在拼接的命令行 */
+static uint16_t s_line_len = 0;
+static uint8_t s_line_overlong = 0;        /* 当前行超长，丢弃到行结束 */
+
 /* Private function prototypes -----------------------------------------------*/
 static void Send_Response(const char *msg);
 static void Process_SetRate(const char *param);
@@ -51,6 +70,23 @@ static void Process_SetMode(const char *param);
 static void Process_SetRange(const char *param);
 static void Process_SetLevel(const char *param);
 static void Process_SetFormat(const char *param);
+static void Process_SetWait(const char *param);
+static void Process_SetOrder(const char *param);
+static void Process_SetPolicy(const char *param);
+static void Process_SetPeriod(const char *param);
+static void Process_SchedStats(const char *param);
+static void Process_SetPorts(const char *param);
+static void Process_SetLayout(const char *param);
+static void Process_SetDelta(const char *param);
+static void Process_Keyframe(void);
+static void Process_Bench(const char *param);
+static void Process_GetFrame(const char *param);
+static void Process_BootStats(void);
+static void Process_PCap04_Persist(void);
+static void Process_PCap04_Upload(void);
+static void Param_To_Upper(const char *param, char *upper, size_t size);
+static const char *Output_Format_Name(OutputFormat_t format);
+static const char *Wait_Mode_Name(ScanWaitMode_t mode);
 static void Process_PCap04_Status(void);
 static void Process_PCap04_Test(void);
 
@@ -61,6 +97,7 @@ void USB_Command_Init(void)
 {
   g_work_mode = MODE_NORMAL;  /* 默认普通模式，开始扫描 */
   g_scan_delay_ms = 100;      /* 默认100ms扫描间隔 */
+  g_scan_period_us = 100000;  /* 默认100ms帧周期 */
   g_current_row = 0;          /* 默认行通道0 */
   g_current_col = 0;          /* 默认列通道0 */
   g_output_mode = OUTPUT_RAW;  /* 默认原始值模式 */
@@ -70,6 +107,96 @@ void USB_Command_Init(void)
   g_quant_level = QUANT_LEVEL_255;  /* 默认255档位 */
 }
 
+/******************************************************************************/
+/*                           Deferred Command Reception                       */
+/******************************************************************************/
+/**
+  * @brief  接收USB数据（CDC_Receive_FS 中调用），中断中只做复制
+  * @note   一个包可能含半条命令或多条命令，拼行由 USB_Command_Task() 完成。
+  *         剩余空间放不下整包时丢弃整包，并跳过之后的字节直到行结束符，
+  *         再写入一个0字节通知主循环丢弃残缺的半行，避免两条命令拼接成一条
+  */
+void USB_Command_Receive(const uint8_t *buf, uint32_t len)
+{
+  uint16_t head = s_rx_head;
+  uint32_t i = 0;
+
+  if(s_rx_resync) {
+    while(i < len && buf[i] != '\r' && buf[i] != '\n') {
+      i++;
+    }
+    if(i == len) {
+      return;
+    }
+  }
+
+  if((uint32_t)(USB_CMD_RX_RING_SIZE - (uint16_t)(head - s_rx_tail)) < len - i + 1U) {
+    s_rx_resync = 1;
+    s_rx_dropped++;
+    return;
+  }
+
+  if(s_rx_resync) {
+    s_rx_ring[head++ & (USB_CMD_RX_RING_SIZE - 1)] = 0;
+    s_rx_resync = 0;
+  }
+  for(; i < len; i++) {
+    s_rx_ring[head++ & (USB_CMD_RX_RING_SIZE - 1)] = buf[i];
+  }
+  s_rx_head = head;
+}
+
+/**
+  * @brief  从接收缓冲区拼行并执行命令（主循环中调用）
+  * @note   只在帧边界（没有正在扫描的帧）执行，执行期间暂缓TIM2开始新帧，
+  *         命令处理可以直接访问SPI；回复经发送任务排在正在发送的帧之后
+  */
+void USB_Command_Task(void)
+{
+  uint16_t tail = s_rx_tail;
+  uint8_t c;
+
+  while(tail != s_rx_head) {
+    c = s_rx_ring[tail & (USB_CMD_RX_RING_SIZE - 1)];
+
+    if(c == '\r' || c == '\n') {
+      if(s_line_len > 0 && !s_line_overlong) {
+        Frame_Sched_Hold();
+        if(Matrix_Stream_Scanning()) {
+          /* 帧扫描中：行结束符留在缓冲区，下一轮再执行 */
+          Frame_Sched_Release();
+          break;
+        }
+        s_rx_tail = ++tail;
+        s_line[s_line_len] = '\0';
+        USB_Command_Process((uint8_t*)s_line, s_line_len);
+        Frame_Sched_Release();
+        s_line_len = 0;
+        continue;
+      }
+      if(s_line_overlong) {
+        Send_Response("ERROR: Command too long\r\n");
+      }
+      s_line_len = 0;
+      s_line_overlong = 0;
+    } else if(c == 0) {
+      /* 接收缓冲区溢出：丢弃残缺的半行 */
+      s_line_len = 0;
+      s_line_overlong = 0;
+    } else if(s_line_len < USB_CMD_LINE_MAX) {
+      s_line[s_line_len++] = (char)c;
+    } else {
+      s_line_overlong = 1;
+    }
+    s_rx_tail = ++tail;
+  }
+}
+
+uint32_t USB_Command_Rx_Dropped(void)
+{
+  return s_rx_dropped;
+}
+
 /******************************************************************************/
 /*                           Parse Command                                    */
 /******************************************************************************/
@@ -81,11 +208,7 @@ uint8_t USB_Command_Parse(const char *cmd)
   
   /* 转换为大写以便比较 */
   char cmd_upper[64];
-  int i;
-  for(i = 0; i < strlen(cmd) && i < 63; i++) {
-    cmd_upper[i] = (cmd[i] >= 'a' && cmd[i] <= 'z') ? (cmd[i] - 'a' + 'A') : cmd[i];
-  }
-  cmd_upper[i] = '\0';
+  Param_To_Upper(cmd, cmd_upper, sizeof(cmd_upper));
   
   /* 查找冒号位置（参数分隔符） */
   char *colon = strchr(cmd_upper, ':');
@@ -170,6 +293,62 @@ uint8_t USB_Command_Parse(const char *cmd)
     Process_SetFormat(param);
     return CMD_SET_FORMAT;
   }
+  else if(strncmp(cmd_upper, "SET_WAIT", cmd_len) == 0 || strncmp(cmd_upper, "WAIT", cmd_len) == 0) {
+    Process_SetWait(param);
+    return CMD_SET_WAIT;
+  }
+  else if(strncmp(cmd_upper, "SET_ORDER", cmd_len) == 0 || strncmp(cmd_upper, "ORDER", cmd_len) == 0) {
+    Process_SetOrder(param);
+    return CMD_SET_ORDER;
+  }
+  else if(strncmp(cmd_upper, "SET_POLICY", cmd_len) == 0 || strncmp(cmd_upper, "POLICY", cmd_len) == 0) {
+    Process_SetPolicy(param);
+    return CMD_SET_POLICY;
+  }
+  else if(strncmp(cmd_upper, "SET_PERIOD", cmd_len) == 0 || strncmp(cmd_upper, "PERIOD", cmd_len) == 0) {
+    Process_SetPeriod(param);
+    return CMD_SET_PERIOD;
+  }
+  else if(strncmp(cmd_upper, "SCHED_STATS", cmd_len) == 0 || strncmp(cmd_upper, "SCHED", cmd_len) == 0) {
+    Process_SchedStats(param);
+    return CMD_SCHED_STATS;
+  }
+  else if(strncmp(cmd_upper, "SET_PORTS", cmd_len) == 0 || strncmp(cmd_upper, "PORTS", cmd_len) == 0) {
+    Process_SetPorts(param);
+    return CMD_SET_PORTS;
+  }
+  else if(strncmp(cmd_upper, "SET_LAYOUT", cmd_len) == 0 || strncmp(cmd_upper, "LAYOUT", cmd_len) == 0) {
+    Process_SetLayout(param);
+    return CMD_SET_LAYOUT;
+  }
+  else if(strncmp(cmd_upper, "SET_DELTA", cmd_len) == 0 || strncmp(cmd_upper, "DELTA", cmd_len) == 0) {
+    Process_SetDelta(param);
+    return CMD_SET_DELTA;
+  }
+  else if(strncmp(cmd_upper, "KEYFRAME", cmd_len) == 0) {
+    Process_Keyframe();
+    return CMD_KEYFRAME;
+  }
+  else if(strncmp(cmd_upper, "BENCH", cmd_len) == 0) {
+    Process_Bench(param);
+    return CMD_BENCH;
+  }
+  else if(strncmp(cmd_upper, "GET_FRAME", cmd_len) == 0) {
+    Process_GetFrame(param);
+    return CMD_GET_FRAME;
+  }
+  else if(strncmp(cmd_upper, "BOOT_STATS", cmd_len) == 0 || strncmp(cmd_upper, "BOOT", cmd_len) == 0) {
+    Process_BootStats();
+    return CMD_BOOT_STATS;
+  }
+  else if(strncmp(cmd_upper, "PCAP04_PERSIST", cmd_len) == 0) {
+    Process_PCap04_Persist();
+    return CMD_PCAP04_PERSIST;
+  }
+  else if(strncmp(cmd_upper, "PCAP04_UPLOAD", cmd_len) == 0) {
+    Process_PCap04_Upload();
+    return CMD_PCAP04_UPLOAD;
+  }
   else if(strncmp(cmd_upper, "PCAP04_STATUS", cmd_len) == 0 || strncmp(cmd_upper, "PCAP_STATUS", cmd_len) == 0) {
     Process_PCap04_Status();
     return CMD_PCAP04_STATUS;
@@ -185,6 +364,9 @@ uint8_t USB_Command_Parse(const char *cmd)
 /******************************************************************************/
 /*                           Process USB Command                              */
 /******************************************************************************/
+/**
+  * @brief  执行一条命令（USB_Command_Task 拼好的一行，主循环中调用）
+  */
 void USB_Command_Process(uint8_t *buf, uint32_t len)
 {
   if(buf == NULL || len == 0) {
@@ -227,6 +409,7 @@ static void Process_SetRate(const char *param)
     uint32_t rate = strtoul(param, NULL, 10);
     if(rate > 0 && rate <= 10000) {  /* 限制在1-10000ms之间 */
       g_scan_delay_ms = rate;
+      g_scan_period_us = rate * 1000;
       char msg[64];
       sprintf(msg, "OK: Scan rate set to %lu ms\r\n", g_scan_delay_ms);
       Send_Response(msg);
@@ -245,6 +428,7 @@ static void Process_FastMode(void)
   g_work_mode = MODE_FAST;
   g_last_work_mode = MODE_FAST;  /* 保存工作模式 */
   g_scan_delay_ms = 0;  /* 快速模式：无延时 */
+  g_scan_period_us = 0;
   Send_Response("OK: Fast mode enabled (continuous scan, no delay)\r\n");
 }
 
@@ -255,8 +439,11 @@ static void Process_NormalMode(void)
   if(g_scan_delay_ms == 0) {
     g_scan_delay_ms = 100;  /* 恢复默认值 */
   }
+  if(g_scan_period_us == 0) {
+    g_scan_period_us = g_scan_delay_ms * 1000;
+  }
   char msg[64];
-  sprintf(msg, "OK: Normal mode enabled (scan rate: %lu ms)\r\n", g_scan_delay_ms);
+  sprintf(msg, "OK: Normal mode enabled (scan period: %lu us)\r\n", g_scan_period_us);
   Send_Response(msg);
 }
 
@@ -291,13 +478,15 @@ static void Process_Start(void)
       g_work_mode = MODE_NORMAL;
     }
   }
+  /* 新会话的第一帧为关键帧，主机无需保留上一会话的参考帧 */
+  Frame_Codec_Request_Keyframe();
   Send_Response("START\r\n");
   Send_Response("OK: Streaming session started\r\n");
 }
 
 static void Process_Status(void)
 {
-  char msg[512];
+  char msg[1024];
   const char *mode_str;
   const char *output_mode_str;
   
@@ -310,17 +499,18 @@ static void Process_Status(void)
   }
   
   output_mode_str = (g_output_mode == OUTPUT_RAW) ? "RAW" : "QUANT";
-  const char *format_str = (g_output_format == FORMAT_SIMPLE) ? "SIMPLE" : "TABLE";
+  const char *format_str = Output_Format_Name(g_output_format);
   
   sprintf(msg, "Status:\r\n"
                "  Work Mode: %s\r\n"
                "  Scan Delay: %lu ms\r\n"
+               "  Scan Period: %lu us\r\n"
                "  Current Row: %d\r\n"
                "  Current Col: %d\r\n"
                "  Matrix Size: 16x16\r\n"
                "  Output Mode: %s\r\n"
                "  Output Format: %s\r\n",
-          mode_str, g_scan_delay_ms, g_current_row, g_current_col, output_mode_str, format_str);
+          mode_str, g_scan_delay_ms, g_scan_period_us, g_current_row, g_current_col, output_mode_str, format_str);
   
   if(g_output_mode == OUTPUT_QUANT) {
     char range_msg[128];
@@ -330,6 +520,74 @@ static void Process_Status(void)
     strcat(msg, range_msg);
   }
   
+  {
+    ScanEngine_Stats_t stats;
+    char wait_msg[288];
+    Scan_Engine_Get_Stats(&stats);
+    sprintf(wait_msg, "  Scan Order: %s\r\n"
+                      "  Wait Mode: %s\r\n"
+                      "  INTN Events/Timeouts: %lu/%lu\r\n"
+                      "  Status Polls/Timeouts: %lu/%lu\r\n"
+                      "  PCap04 Ports: 0x%02X (port errors %lu)\r\n"
+                      "  Layout: %s (%u conversions/frame)\r\n"
+                      "  Last Frame: %lu us\r\n",
+            Scan_Order_Name(Scan_Order_Get()), Wait_Mode_Name(stats.wait_mode), stats.intn_events, stats.intn_timeouts,
+            stats.status_polls, stats.status_timeouts, Scan_Engine_Get_Port_Mask(), stats.port_errors,
+            Scan_Layout_Name(Scan_Layout_Get()), Scan_Engine_Frame_Points(), stats.last_frame_us);
+    strcat(msg, wait_msg);
+  }
+  
+  {
+    FrameStream_Stats_t fstats;
+    char frame_msg[240];
+    Frame_Stream_Get_Stats(&fstats);
+    uint32_t oldest = 0, newest = 0;
+    uint8_t history = Frame_Stream_History_Range(&oldest, &newest);
+    sprintf(frame_msg, "  Stream Policy: %s\r\n"
+                       "  Frames Scanned/Sent/Resent: %lu/%lu/%lu\r\n"
+                       "  Frames Dropped: %lu\r\n"
+                       "  Scan Stalls: %lu\r\n"
+                       "  Binary Sink: %s\r\n"
+                       "  Frame History: %u (seq %lu-%lu)\r\n",
+            Frame_Stream_Policy_Name(Frame_Stream_Get_Policy()),
+            fstats.frames_scanned, fstats.frames_sent, fstats.frames_resent, fstats.frames_dropped, fstats.scan_stalls,
+            Vendor_Stream_Active() ? "VENDOR(EP84)" : "CDC", history, oldest, newest);
+    strcat(msg, frame_msg);
+  }
+  
+  {
+    FrameSched_Stats_t sstats;
+    char sched_msg[96];
+    Frame_Sched_Get_Stats(&sstats);
+    sprintf(sched_msg, "  Frame Jitter Max/Mean: %lu/%lu us\r\n"
+                       "  Frame Overruns: %lu\r\n",
+            sstats.max_jitter_us, sstats.mean_jitter_us, sstats.overruns);
+    strcat(msg, sched_msg);
+  }
+  
+  {
+    FrameStream_Stats_t fstats;
+    char cmd_msg[64];
+    Frame_Stream_Get_Stats(&fstats);
+    sprintf(cmd_msg, "  Cmd RX/Reply Dropped: %lu/%lu\r\n", s_rx_dropped, fstats.replies_dropped);
+    strcat(msg, cmd_msg);
+  }
+  
+  if(g_output_format == FORMAT_BINARY) {
+    FrameCodec_Stats_t cstats;
+    char codec_msg[112];
+    Frame_Codec_Get_Stats(&cstats);
+    if(Frame_Codec_Get_Delta() == 0) {
+      sprintf(codec_msg, "  Delta: OFF\r\n");
+    } else {
+      sprintf(codec_msg, "  Delta: keyframe every %u\r\n", Frame_Codec_Get_Delta());
+    }
+    strcat(msg, codec_msg);
+    sprintf(codec_msg, "  Key/Delta Frames: %lu/%lu (last payload %u bytes)\r\n",
+            cstats.key_frames, cstats.delta_frames, cstats.last_payload);
+    strcat(msg, codec_msg);
+  }
+  
   Send_Response(msg);
 }
 
@@ -340,6 +598,7 @@ static void Process_Help(void)
     "\r\n"
     "Scan Control:\r\n"
     "  SET_RATE:<ms>     - Set scan rate in milliseconds (1-10000)\r\n"
+    "  SET_PERIOD:<us>   - Set frame period in microseconds (100-10000000, timer driven)\r\n"
     "  FAST_MODE         - Enable fast mode (continuous scan, no delay)\r\n"
     "  NORMAL_MODE       - Enable normal mode (scan at set rate)\r\n"
     "  SINGLE_SCAN       - Perform single scan then stop\r\n"
@@ -358,10 +617,23 @@ static void Process_Help(void)
     "  SET_MODE:<raw|quant> - Set output mode (raw=original value, quant=quantized value)\r\n"
     "  SET_RANGE:<min>:<max> - Set quantization range (L-H)\r\n"
     "  SET_LEVEL:<255|1023> - Set quantization level (0-255 or 0-1023)\r\n"
-    "  SET_FORMAT:<simple|table> - Set output format (simple=X00Y00:value, table=with headers)\r\n"
+    "  SET_FORMAT:<simple|table|binary> - Set output format (simple=X00Y00:value, table=with headers, binary=COBS frames+CRC32)\r\n"
+    "  SET_WAIT:<intn|status|timed> - Conversion complete detection (INTN pin, STATUS_0 poll, fixed delay)\r\n"
+    "  SET_ORDER:<binary|serpentine|gray> - Scan order (gray=one select line change per step)\r\n"
+    "  SET_POLICY:<block|drop_oldest|drop_newest> - Slow host handling (drop keeps scan cadence)\r\n"
+    "  SET_PORTS:<mask>  - PCap04 ports read per point (bit0-5 = PC0-PC5, e.g. 0x0F)\r\n"
+    "  SET_LAYOUT:<single|dual|quad> - Column groups on PC0/PC0-1/PC0-3 (256/128/64 conversions)\r\n"
+    "  SET_DELTA:<n|0>   - Binary format: delta frames with a keyframe every n frames (0=off)\r\n"
+    "  KEYFRAME          - Send the next binary frame as a keyframe (no reply)\r\n"
+    "  GET_FRAME:<seq>   - Resend a recent frame from the history ring (no reply unless unavailable)\r\n"
     "\r\n"
     "System:\r\n"
     "  STATUS            - Show current status\r\n"
+    "  SCHED_STATS[:RESET] - Show (or reset) frame period jitter statistics\r\n"
+    "  BENCH:<KB>        - USB throughput test: send <KB> of test pattern, then BENCH_DONE:<bytes>,<us>\r\n"
+    "  BOOT_STATS        - Show PCap04 bring-up stage timing and USB enumeration time\r\n"
+    "  PCAP04_PERSIST    - Store current firmware/config in PCap04 NVRAM (boot then skips download)\r\n"
+    "  PCAP04_UPLOAD     - Re-upload firmware/config, read back and compare (throughput, mismatches)\r\n"
     "  PCAP04_STATUS     - Show PCap04 sensor status\r\n"
     "  PCAP04_TEST       - Test PCap04 communication\r\n"
     "  HELP or ?         - Show this help\r\n"
@@ -524,11 +796,7 @@ static void Process_SetMode(const char *param)
 {
   if(param != NULL && strlen(param) > 0) {
     char param_upper[16];
-    int i;
-    for(i = 0; i < strlen(param) && i < 15; i++) {
-      param_upper[i] = (param[i] >= 'a' && param[i] <= 'z') ? (param[i] - 'a' + 'A') : param[i];
-    }
-    param_upper[i] = '\0';
+    Param_To_Upper(param, param_upper, sizeof(param_upper));
     
     if(strcmp(param_upper, "RAW") == 0 || strcmp(param_upper, "ORIGINAL") == 0) {
       g_output_mode = OUTPUT_RAW;
@@ -626,11 +894,7 @@ static void Process_SetFormat(const char *param)
 {
   if(param != NULL && strlen(param) > 0) {
     char param_upper[16];
-    int i;
-    for(i = 0; i < strlen(param) && i < 15; i++) {
-      param_upper[i] = (param[i] >= 'a' && param[i] <= 'z') ? (param[i] - 'a' + 'A') : param[i];
-    }
-    param_upper[i] = '\0';
+    Param_To_Upper(param, param_upper, sizeof(param_upper));
     
     if(strcmp(param_upper, "SIMPLE") == 0) {
       g_output_format = FORMAT_SIMPLE;
@@ -640,17 +904,441 @@ static void Process_SetFormat(const char *param)
       g_output_format = FORMAT_TABLE;
       Send_Response("OK: Output format set to TABLE (with row/col headers, comma separated)\r\n");
     }
+    else if(strcmp(param_upper, "BINARY") == 0 || strcmp(param_upper, "BIN") == 0) {
+      g_output_format = FORMAT_BINARY;
+      Send_Response("OK: Output format set to BINARY (0x00-delimited COBS frames, CRC-32; quant values packed to 8/10 bits)\r\n");
+    }
     else {
-      Send_Response("ERROR: Invalid format. Use 'simple' or 'table'\r\n");
+      Send_Response("ERROR: Invalid format. Use 'simple', 'table' or 'binary'\r\n");
     }
   } else {
-    const char *format_str = (g_output_format == FORMAT_SIMPLE) ? "SIMPLE" : "TABLE";
+    const char *format_str = Output_Format_Name(g_output_format);
     char msg[64];
     sprintf(msg, "Current output format: %s\r\n", format_str);
     Send_Response(msg);
   }
 }
 
+/**
+  * @brief  参数转大写，超出 size - 1 个字符的部分截断
+  */
+static void Param_To_Upper(const char *param, char *upper, size_t size)
+{
+  size_t i;
+
+  for(i = 0; i + 1 < size && param[i] != '\0'; i++) {
+    upper[i] = (param[i] >= 'a' && param[i] <= 'z') ? (param[i] - 'a' + 'A') : param[i];
+  }
+  upper[i] = '\0';
+}
+
+static const char *Output_Format_Name(OutputFormat_t format)
+{
+  switch(format) {
+    case FORMAT_SIMPLE: return "SIMPLE";
+    case FORMAT_BINARY: return "BINARY";
+    default: return "TABLE";
+  }
+}
+
+static const char *Wait_Mode_Name(ScanWaitMode_t mode)
+{
+  switch(mode) {
+    case SCAN_WAIT_INTN: return "INTN";
+    case SCAN_WAIT_STATUS: return "STATUS";
+    default: return "TIMED";
+  }
+}
+
+static void Process_SetWait(const char *param)
+{
+  if(param != NULL && strlen(param) > 0) {
+    char param_upper[16];
+    Param_To_Upper(param, param_upper, sizeof(param_upper));
+    
+    if(strcmp(param_upper, "INTN") == 0) {
+      Scan_Engine_Set_Wait_Mode(SCAN_WAIT_INTN);
+    }
+    else if(strcmp(param_upper, "STATUS") == 0) {
+      Scan_Engine_Set_Wait_Mode(SCAN_WAIT_STATUS);
+    }
+    else if(strcmp(param_upper, "TIMED") == 0) {
+      Scan_Engine_Set_Wait_Mode(SCAN_WAIT_TIMED);
+    }
+    else {
+      Send_Response("ERROR: Invalid wait mode. Use 'intn', 'status' or 'timed'\r\n");
+      return;
+    }
+    
+    {
+      char msg[64];
+      sprintf(msg, "OK: Wait mode set to %s\r\n", Wait_Mode_Name(Scan_Engine_Get_Wait_Mode()));
+      Send_Response(msg);
+    }
+  } else {
+    char msg[64];
+    sprintf(msg, "Current wait mode: %s\r\n", Wait_Mode_Name(Scan_Engine_Get_Wait_Mode()));
+    Send_Response(msg);
+  }
+}
+
+static void Process_SetOrder(const char *param)
+{
+  if(param != NULL && strlen(param) > 0) {
+    char param_upper[16];
+    Param_To_Upper(param, param_upper, sizeof(param_upper));
+    
+    if(strcmp(param_upper, "BINARY") == 0) {
+      Scan_Order_Set(SCAN_ORDER_BINARY);
+    }
+    else if(strcmp(param_upper, "SERPENTINE") == 0 || strcmp(param_upper, "SERP") == 0) {
+      Scan_Order_Set(SCAN_ORDER_SERPENTINE);
+    }
+    else if(strcmp(param_upper, "GRAY") == 0) {
+      Scan_Order_Set(SCAN_ORDER_GRAY);
+    }
+    else {
+      Send_Response("ERROR: Invalid scan order. Use 'binary', 'serpentine' or 'gray'\r\n");
+      return;
+    }
+    
+    {
+      char msg[64];
+      sprintf(msg, "OK: Scan order set to %s (from next frame)\r\n", Scan_Order_Name(Scan_Order_Get()));
+      Send_Response(msg);
+    }
+  } else {
+    char msg[64];
+    sprintf(msg, "Current scan order: %s\r\n", Scan_Order_Name(Scan_Order_Get()));
+    Send_Response(msg);
+  }
+}
+
+static void Process_SetPolicy(const char *param)
+{
+  if(param != NULL && strlen(param) > 0) {
+    char param_upper[16];
+    Param_To_Upper(param, param_upper, sizeof(param_upper));
+    
+    if(strcmp(param_upper, "BLOCK") == 0) {
+      Frame_Stream_Set_Policy(FRAME_POLICY_BLOCK);
+    }
+    else if(strcmp(param_upper, "DROP_OLDEST") == 0 || strcmp(param_upper, "OLDEST") == 0) {
+      Frame_Stream_Set_Policy(FRAME_POLICY_DROP_OLDEST);
+    }
+    else if(strcmp(param_upper, "DROP_NEWEST") == 0 || strcmp(param_upper, "NEWEST") == 0) {
+      Frame_Stream_Set_Policy(FRAME_POLICY_DROP_NEWEST);
+    }
+    else {
+      Send_Response("ERROR: Invalid policy. Use 'block', 'drop_oldest' or 'drop_newest'\r\n");
+      return;
+    }
+    
+    {
+      char msg[64];
+      sprintf(msg, "OK: Stream policy set to %s\r\n", Frame_Stream_Policy_Name(Frame_Stream_Get_Policy()));
+      Send_Response(msg);
+    }
+  } else {
+    FrameStream_Stats_t fstats;
+    char msg[96];
+    Frame_Stream_Get_Stats(&fstats);
+    sprintf(msg, "Current stream policy: %s (dropped %lu frames)\r\n",
+            Frame_Stream_Policy_Name(Frame_Stream_Get_Policy()), fstats.frames_dropped);
+    Send_Response(msg);
+  }
+}
+
+/**
+  * @brief  设置普通模式帧周期（微秒），由TIM2定时启动每帧
+  */
+static void Process_SetPeriod(const char *param)
+{
+  if(param != NULL && strlen(param) > 0) {
+    uint32_t period = strtoul(param, NULL, 10);
+    if(period >= FRAME_SCHED_MIN_PERIOD_US && period <= FRAME_SCHED_MAX_PERIOD_US) {
+      g_scan_period_us = period;
+      g_scan_delay_ms = (period + 999) / 1000;
+      char msg[64];
+      sprintf(msg, "OK: Frame period set to %lu us\r\n", g_scan_period_us);
+      Send_Response(msg);
+    } else {
+      Send_Response("ERROR: Invalid period (100-10000000 us)\r\n");
+    }
+  } else {
+    char msg[64];
+    sprintf(msg, "Current frame period: %lu us\r\n", g_scan_period_us);
+    Send_Response(msg);
+  }
+}
+
+/**
+  * @brief  查询帧调度统计：实际帧间隔相对设定周期的抖动和超限次数
+  */
+static void Process_SchedStats(const char *param)
+{
+  FrameSched_Stats_t stats;
+  char msg[320];
+
+  if(param != NULL && strncmp(param, "RESET", 5) == 0) {
+    Frame_Sched_Reset_Stats();
+    Send_Response("OK: Scheduler statistics reset\r\n");
+    return;
+  }
+
+  Frame_Sched_Get_Stats(&stats);
+  sprintf(msg, "Scheduler:\r\n"
+               "  Running: %s\r\n"
+               "  Period: %lu us (tick %lu us)\r\n"
+               "  Frames Started: %lu\r\n"
+               "  Overruns: %lu\r\n"
+               "  Jitter Last/Max/Mean: %lu/%lu/%lu us\r\n"
+               "  Interval Min/Max: %lu/%lu us\r\n",
+          Frame_Sched_Running() ? "YES" : "NO",
+          stats.period_us, stats.tick_us, stats.frames_started, stats.overruns,
+          stats.last_jitter_us, stats.max_jitter_us, stats.mean_jitter_us,
+          stats.min_interval_us, stats.max_interval_us);
+  Send_Response(msg);
+}
+
+/**
+  * @brief  设置每个测量点采集的PCap04端口（一次突发读取，端口数不影响SPI事务数）
+  */
+static void Process_SetPorts(const char *param)
+{
+  if(param != NULL && strlen(param) > 0) {
+    uint32_t mask = strtoul(param, NULL, 0);
+    if(mask >= 1 && mask <= PCAP04_PORT_MASK_ALL) {
+      Scan_Engine_Set_Port_Mask((uint8_t)mask);
+      char msg[64];
+      sprintf(msg, "OK: PCap04 ports set to 0x%02X\r\n", Scan_Engine_Get_Port_Mask());
+      Send_Response(msg);
+    } else {
+      Send_Response("ERROR: Invalid port mask (0x01-0x3F)\r\n");
+    }
+  } else {
+    char msg[64];
+    sprintf(msg, "Current PCap04 ports: 0x%02X\r\n", Scan_Engine_Get_Port_Mask());
+    Send_Response(msg);
+  }
+}
+
+/**
+  * @brief  设置多端口布局：矩阵列分组接到多个PCap04端口，每次转换写入多个单元
+  */
+static void Process_SetLayout(const char *param)
+{
+  if(param != NULL && strlen(param) > 0) {
+    char param_upper[16];
+    Param_To_Upper(param, param_upper, sizeof(param_upper));
+    
+    if(strcmp(param_upper, "SINGLE") == 0 || strcmp(param_upper, "1") == 0) {
+      Scan_Layout_Set(SCAN_LAYOUT_SINGLE);
+    }
+    else if(strcmp(param_upper, "DUAL") == 0 || strcmp(param_upper, "2") == 0) {
+      Scan_Layout_Set(SCAN_LAYOUT_DUAL);
+    }
+    else if(strcmp(param_upper, "QUAD") == 0 || strcmp(param_upper, "4") == 0) {
+      Scan_Layout_Set(SCAN_LAYOUT_QUAD);
+    }
+    else {
+      Send_Response("ERROR: Invalid layout. Use 'single', 'dual' or 'quad'\r\n");
+      return;
+    }
+    
+    {
+      char msg[64];
+      sprintf(msg, "OK: Layout set to %s (next frame)\r\n", Scan_Layout_Name(Scan_Layout_Get()));
+      Send_Response(msg);
+    }
+  } else {
+    char msg[64];
+    sprintf(msg, "Current layout: %s\r\n", Scan_Layout_Name(Scan_Layout_Get()));
+    Send_Response(msg);
+  }
+}
+
+static void Process_SetDelta(const char *param)
+{
+  if(param != NULL && strlen(param) > 0) {
+    char msg[80];
+    uint32_t interval;
+    
+    if(strcmp(param, "OFF") == 0) {
+      interval = 0;
+    } else {
+      interval = strtoul(param, NULL, 10);
+      if(interval > FRAME_CODEC_KEY_INTERVAL_MAX || (interval == 0 && param[0] != '0')) {
+        sprintf(msg, "ERROR: Keyframe interval must be 0-%d (0=off)\r\n", FRAME_CODEC_KEY_INTERVAL_MAX);
+        Send_Response(msg);
+        return;
+      }
+    }
+    
+    Frame_Codec_Set_Delta((uint16_t)interval);
+    if(interval == 0) {
+      Send_Response("OK: Delta frames disabled\r\n");
+    } else {
+      sprintf(msg, "OK: Delta frames enabled, keyframe every %lu frames (binary format)\r\n", interval);
+      Send_Response(msg);
+    }
+  } else {
+    char msg[64];
+    sprintf(msg, "Current delta keyframe interval: %u (0=off)\r\n", Frame_Codec_Get_Delta());
+    Send_Response(msg);
+  }
+}
+
+/**
+  * @brief  主机重新同步差分帧时自动发送，不回复（回复可能插入正在发送的帧中使其CRC失败）
+  */
+static void Process_Keyframe(void)
+{
+  Frame_Codec_Request_Keyframe();
+}
+
+/**
+  * @brief  USB吞吐量测试：主循环以最快速度发送测试图样（只在停止扫描时）
+  */
+static void Process_Bench(const char *param)
+{
+  char msg[64];
+  uint32_t kb = (param != NULL) ? strtoul(param, NULL, 10) : 0;
+
+  if(kb == 0 || kb > FRAME_STREAM_BENCH_MAX_KB) {
+    sprintf(msg, "ERROR: Size must be 1-%d KB\r\n", FRAME_STREAM_BENCH_MAX_KB);
+    Send_Response(msg);
+    return;
+  }
+  if(g_stream_enabled || Frame_Stream_Bench_Active()) {
+    Send_Response("ERROR: STOP streaming before BENCH\r\n");
+    return;
+  }
+
+  sprintf(msg, "OK: BENCH %lu bytes\r\n", kb * 1024);
+  Send_Response(msg);
+  Frame_Stream_Bench_Start(kb * 1024);
+}
+
+/**
+  * @brief  重发历史帧：成功时不回复（重发的帧本身就是回复，与数据流混在一起），
+  *         该帧已被回收时回复ERROR和当前可重发的序号范围，主机据此放弃等待
+  */
+static void Process_GetFrame(const char *param)
+{
+  char msg[80];
+  char *end;
+  uint32_t seq, oldest, newest;
+
+  if(param == NULL || *param == '\0') {
+    Send_Response("ERROR: Usage GET_FRAME:<seq>\r\n");
+    return;
+  }
+  seq = strtoul(param, &end, 10);
+  if(end == param) {
+    Send_Response("ERROR: Invalid frame sequence\r\n");
+    return;
+  }
+
+  if(Frame_Stream_Request_Resend(seq)) {
+    return;
+  }
+  if(Frame_Stream_History_Range(&oldest, &newest) == 0) {
+    sprintf(msg, "ERROR: Frame %lu not available (history empty)\r\n", seq);
+  } else {
+    sprintf(msg, "ERROR: Frame %lu not available (history %lu-%lu)\r\n", seq, oldest, newest);
+  }
+  Send_Response(msg);
+}
+
+/**
+  * @brief  上电各阶段耗时（POR/INIT/固件/配置/RUN 的轮询结果）和USB枚举时刻
+  */
+static void Process_BootStats(void)
+{
+  Boot_Stats_t stats;
+  char msg[512];
+  int n;
+
+  Boot_Seq_Get_Stats(&stats);
+  n = sprintf(msg, "Boot Stats:\r\n");
+  for(uint8_t i = 0; i < BOOT_STAGE_COUNT; i++) {
+    if(stats.stage[i].skipped) {
+      n += sprintf(msg + n, "  %-9s   (skipped)\r\n", Boot_Stage_Name((BootStage_t)i));
+      continue;
+    }
+    n += sprintf(msg + n, "  %-9s %7lu us (%u polls)%s\r\n",
+                 Boot_Stage_Name((BootStage_t)i), stats.stage[i].us, stats.stage[i].polls,
+                 stats.stage[i].timeout ? " TIMEOUT" : "");
+  }
+  n += sprintf(msg + n, "  Sensor Start/Ready: %lu/%lu ms\r\n"
+                        "  Main Loop: %lu ms\r\n",
+               stats.sensor_start_ms, stats.sensor_ready_ms, stats.main_loop_ms);
+  if(stats.usb_config_ms != 0) {
+    n += sprintf(msg + n, "  USB Configured: %lu ms\r\n", stats.usb_config_ms);
+  } else {
+    n += sprintf(msg + n, "  USB Configured: (pending)\r\n");
+  }
+  n += sprintf(msg + n, "  TEST_READ: 0x%02X, STATUS_0: 0x%02X\r\n", stats.test_read, stats.status0);
+  sprintf(msg + n, "  Image: %s (CRC 0x%08lX, NV recall 0x%08lX)\r\n",
+          (stats.image_source == PCAP04_IMAGE_NVRAM) ? "NVRAM" :
+          (stats.image_source == PCAP04_IMAGE_DOWNLOAD) ? "Download" : "None",
+          stats.image_crc, stats.recall_crc);
+  Send_Response(msg);
+}
+
+/**
+  * @brief  把当前固件/配置写入 PCap04 NVRAM 并读回校验（阻塞约100ms，只在停止扫描时）
+  */
+static void Process_PCap04_Persist(void)
+{
+  char msg[96];
+
+  if(g_stream_enabled || Matrix_Stream_Scanning() || Frame_Stream_Bench_Active()) {
+    Send_Response("ERROR: STOP streaming before PCAP04_PERSIST\r\n");
+    return;
+  }
+
+  if(PCap04_Image_Persist() == HAL_OK) {
+    sprintf(msg, "OK: PCap04 NVRAM updated, CRC 0x%08lX\r\n", PCap04_Image_Crc());
+  } else {
+    sprintf(msg, "ERROR: NVRAM verify failed (read 0x%08lX, image 0x%08lX)\r\n",
+            PCap04_Image_Last_Read_Crc(), PCap04_Image_Crc());
+  }
+  Send_Response(msg);
+}
+
+/**
+  * @brief  重新上传固件/配置并逐字节读回比较，回复耗时/吞吐量和不一致字节（只在停止扫描时）
+  */
+static void Process_PCap04_Upload(void)
+{
+  PCap04_Upload_Stats_t stats;
+  HAL_StatusTypeDef status;
+  char msg[192];
+  int n;
+
+  if(g_stream_enabled || Matrix_Stream_Scanning() || Frame_Stream_Bench_Active()) {
+    Send_Response("ERROR: STOP streaming before PCAP04_UPLOAD\r\n");
+    return;
+  }
+
+  status = PCap04_Image_Upload(&stats);
+  n = sprintf(msg, "%s: Upload %u bytes, write %lu us (%lu KB/s), verify %lu us (%lu KB/s), %u mismatches",
+              (status == HAL_OK) ? "OK" : "ERROR", stats.bytes,
+              stats.write_us, (stats.write_us > 0) ? (uint32_t)stats.bytes * 1000UL / stats.write_us : 0UL,
+              stats.verify_us, (stats.verify_us > 0) ? (uint32_t)stats.bytes * 1000UL / stats.verify_us : 0UL,
+              stats.mismatches);
+  if(stats.mismatches > 0) {
+    n += sprintf(msg + n, ", first at 0x%03X (expected 0x%02X, read 0x%02X)",
+                 stats.first_addr, stats.expected, stats.actual);
+  } else if(status != HAL_OK) {
+    n += sprintf(msg + n, " (SPI transfer failed)");
+  }
+  sprintf(msg + n, "\r\n");
+  Send_Response(msg);
+}
+
 /******************************************************************************/
 /*                           PCap04 Status Handler                            */
 /******************************************************************************/
@@ -751,7 +1439,7 @@ static void Send_Response(const char *msg)
 {
   if(msg != NULL) {
     uint16_t len = strlen(msg);
-    CDC_Transmit_FS((uint8_t*)msg, len);
+    Frame_Stream_Send_Reply((const uint8_t*)msg, len);
   }
 }
 
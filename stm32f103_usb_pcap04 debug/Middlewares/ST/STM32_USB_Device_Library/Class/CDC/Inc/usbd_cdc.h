@@ -42,8 +42,11 @@ extern "C" {
   * @{
   */
 #define CDC_IN_EP                                   0x81U  /* EP1 for data IN */
-#define CDC_OUT_EP                                  0x01U  /* EP1 for data OUT */
+#define CDC_OUT_EP                                  0x03U  /* EP3 for data OUT (EP1 is double-buffered IN only) */
 #define CDC_CMD_EP                                  0x82U  /* EP2 for CDC commands */
+#define VENDOR_IN_EP                                0x84U  /* EP4 for vendor bulk frame stream */
+#define VENDOR_INTERFACE                            0x02U  /* Vendor interface number (after CDC 0-1) */
+#define VENDOR_STR_IDX                              0x06U  /* iInterface string of the vendor interface */
 
 #ifndef CDC_HS_BINTERVAL
 #define CDC_HS_BINTERVAL                          0x10U
@@ -58,7 +61,7 @@ extern "C" {
 #define CDC_DATA_FS_MAX_PACKET_SIZE                 64U  /* Endpoint IN & OUT Packet size */
 #define CDC_CMD_PACKET_SIZE                         8U  /* Control Endpoint Packet size */
 
-#define USB_CDC_CONFIG_DESC_SIZ                     67U
+#define USB_CDC_CONFIG_DESC_SIZ                     100U  /* 67 CDC + 8 IAD + 2x9 vendor alt settings + 7 EP */
 #define CDC_DATA_HS_IN_PACKET_SIZE                  CDC_DATA_HS_MAX_PACKET_SIZE
 #define CDC_DATA_HS_OUT_PACKET_SIZE                 CDC_DATA_HS_MAX_PACKET_SIZE
 
@@ -120,6 +123,9 @@ typedef struct
 
   __IO uint32_t TxState;
   __IO uint32_t RxState;
+
+  __IO uint32_t VendorTxState;  /* Vendor bulk IN transfer in progress */
+  uint8_t  VendorAlt;           /* Vendor interface alternate setting: 1 = stream endpoint open */
 }
 USBD_CDC_HandleTypeDef;
 
@@ -159,6 +165,12 @@ uint8_t  USBD_CDC_SetRxBuffer(USBD_HandleTypeDef   *pdev,
 uint8_t  USBD_CDC_ReceivePacket(USBD_HandleTypeDef *pdev);
 
 uint8_t  USBD_CDC_TransmitPacket(USBD_HandleTypeDef *pdev);
+
+uint8_t  USBD_CDC_VendorTransmit(USBD_HandleTypeDef *pdev,
+                                 uint8_t *pbuff,
+                                 uint16_t length);
+
+uint8_t  USBD_CDC_VendorActive(USBD_HandleTypeDef *pdev);
 /**
   * @}
   */
@@ -127,6 +127,13 @@ static uint8_t  *USBD_CDC_GetOtherSpeedCfgDesc(uint16_t *length);
 
 uint8_t  *USBD_CDC_GetDeviceQualifierDescriptor(uint16_t *length);
 
+#if (USBD_SUPPORT_USER_STRING_DESC == 1U)
+static uint8_t  *USBD_CDC_GetUsrStrDescriptor(USBD_HandleTypeDef *pdev,
+                                              uint8_t index, uint16_t *length);
+#endif
+
+static void USBD_CDC_VendorSetAlt(USBD_HandleTypeDef *pdev, uint8_t alt);
+
 /* USB Standard Device Descriptor */
 __ALIGN_BEGIN static uint8_t USBD_CDC_DeviceQualifierDesc[USB_LEN_DEV_QUALIFIER_DESC] __ALIGN_END =
 {
@@ -168,6 +175,9 @@ USBD_ClassTypeDef  USBD_CDC =
   USBD_CDC_GetFSCfgDesc,
   USBD_CDC_GetOtherSpeedCfgDesc,
   USBD_CDC_GetDeviceQualifierDescriptor,
+#if (USBD_SUPPORT_USER_STRING_DESC == 1U)
+  USBD_CDC_GetUsrStrDescriptor,
+#endif
 };
 
 /* USB CDC device Configuration Descriptor */
@@ -178,7 +188,7 @@ __ALIGN_BEGIN uint8_t USBD_CDC_CfgHSDesc[USB_CDC_CONFIG_DESC_SIZ] __ALIGN_END =
   USB_DESC_TYPE_CONFIGURATION,      /* bDescriptorType: Configuration */
   USB_CDC_CONFIG_DESC_SIZ,                /* wTotalLength:no of returned bytes */
   0x00,
-  0x02,   /* bNumInterfaces: 2 interface */
+  0x03,   /* bNumInterfaces: CDC (2) + vendor (1) */
   0x01,   /* bConfigurationValue: Configuration value */
   0x00,   /* iConfiguration: Index of string descriptor describing the configuration */
   0xC0,   /* bmAttributes: self powered */
@@ -186,6 +196,16 @@ __ALIGN_BEGIN uint8_t USBD_CDC_CfgHSDesc[USB_CDC_CONFIG_DESC_SIZ] __ALIGN_END =
 
   /*---------------------------------------------------------------------------*/
 
+  /*Interface Association Descriptor: CDC function = interfaces 0-1 */
+  0x08,   /* bLength */
+  0x0B,   /* bDescriptorType: Interface Association */
+  0x00,   /* bFirstInterface */
+  0x02,   /* bInterfaceCount */
+  0x02,   /* bFunctionClass: Communication Interface Class */
+  0x02,   /* bFunctionSubClass: Abstract Control Model */
+  0x01,   /* bFunctionProtocol: Common AT commands */
+  0x00,   /* iFunction */
+
   /*Interface Descriptor */
   0x09,   /* bLength: Interface Descriptor size */
   USB_DESC_TYPE_INTERFACE,  /* bDescriptorType: Interface */
@@ -262,6 +282,39 @@ __ALIGN_BEGIN uint8_t USBD_CDC_CfgHSDesc[USB_CDC_CONFIG_DESC_SIZ] __ALIGN_END =
   0x02,                              /* bmAttributes: Bulk */
   LOBYTE(CDC_DATA_HS_MAX_PACKET_SIZE),  /* wMaxPacketSize: */
   HIBYTE(CDC_DATA_HS_MAX_PACKET_SIZE),
+  0x00,                              /* bInterval: ignore for Bulk transfer */
+
+  /*---------------------------------------------------------------------------*/
+
+  /*Vendor interface, alternate setting 0: no endpoint (frames stay on CDC) */
+  0x09,   /* bLength: Interface Descriptor size */
+  USB_DESC_TYPE_INTERFACE,  /* bDescriptorType: Interface */
+  VENDOR_INTERFACE,         /* bInterfaceNumber */
+  0x00,   /* bAlternateSetting */
+  0x00,   /* bNumEndpoints */
+  0xFF,   /* bInterfaceClass: Vendor specific */
+  0x00,   /* bInterfaceSubClass */
+  0x00,   /* bInterfaceProtocol */
+  VENDOR_STR_IDX,           /* iInterface */
+
+  /*Vendor interface, alternate setting 1: binary frames on the bulk IN endpoint */
+  0x09,   /* bLength: Interface Descriptor size */
+  USB_DESC_TYPE_INTERFACE,  /* bDescriptorType: Interface */
+  VENDOR_INTERFACE,         /* bInterfaceNumber */
+  0x01,   /* bAlternateSetting */
+  0x01,   /* bNumEndpoints */
+  0xFF,   /* bInterfaceClass: Vendor specific */
+  0x00,   /* bInterfaceSubClass */
+  0x00,   /* bInterfaceProtocol */
+  VENDOR_STR_IDX,           /* iInterface */
+
+  /*Vendor bulk IN Endpoint Descriptor*/
+  0x07,   /* bLength: Endpoint Descriptor size */
+  USB_DESC_TYPE_ENDPOINT,      /* bDescriptorType: Endpoint */
+  VENDOR_IN_EP,                      /* bEndpointAddress */
+  0x02,                              /* bmAttributes: Bulk */
+  LOBYTE(CDC_DATA_HS_MAX_PACKET_SIZE),  /* wMaxPacketSize: */
+  HIBYTE(CDC_DATA_HS_MAX_PACKET_SIZE),
   0x00                               /* bInterval: ignore for Bulk transfer */
 } ;
 
@@ -274,7 +327,7 @@ __ALIGN_BEGIN uint8_t USBD_CDC_CfgFSDesc[USB_CDC_CONFIG_DESC_SIZ] __ALIGN_END =
   USB_DESC_TYPE_CONFIGURATION,      /* bDescriptorType: Configuration */
   USB_CDC_CONFIG_DESC_SIZ,                /* wTotalLength:no of returned bytes */
   0x00,
-  0x02,   /* bNumInterfaces: 2 interface */
+  0x03,   /* bNumInterfaces: CDC (2) + vendor (1) */
   0x01,   /* bConfigurationValue: Configuration value */
   0x00,   /* iConfiguration: Index of string descriptor describing the configuration */
   0xC0,   /* bmAttributes: self powered */
@@ -282,6 +335,16 @@ __ALIGN_BEGIN uint8_t USBD_CDC_CfgFSDesc[USB_CDC_CONFIG_DESC_SIZ] __ALIGN_END =
 
   /*---------------------------------------------------------------------------*/
 
+  /*Interface Association Descriptor: CDC function = interfaces 0-1 */
+  0x08,   /* bLength */
+  0x0B,   /* bDescriptorType: Interface Association */
+  0x00,   /* bFirstInterface */
+  0x02,   /* bInterfaceCount */
+  0x02,   /* bFunctionClass: Communication Interface Class */
+  0x02,   /* bFunctionSubClass: Abstract Control Model */
+  0x01,   /* bFunctionProtocol: Common AT commands */
+  0x00,   /* iFunction */
+
   /*Interface Descriptor */
   0x09,   /* bLength: Interface Descriptor size */
   USB_DESC_TYPE_INTERFACE,  /* bDescriptorType: Interface */
@@ -358,6 +421,39 @@ __ALIGN_BEGIN uint8_t USBD_CDC_CfgFSDesc[USB_CDC_CONFIG_DESC_SIZ] __ALIGN_END =
   0x02,                              /* bmAttributes: Bulk */
   LOBYTE(CDC_DATA_FS_MAX_PACKET_SIZE),  /* wMaxPacketSize: */
   HIBYTE(CDC_DATA_FS_MAX_PACKET_SIZE),
+  0x00,                              /* bInterval: ignore for Bulk transfer */
+
+  /*---------------------------------------------------------------------------*/
+
+  /*Vendor interface, alternate setting 0: no endpoint (frames stay on CDC) */
+  0x09,   /* bLength: Interface Descriptor size */
+  USB_DESC_TYPE_INTERFACE,  /* bDescriptorType: Interface */
+  VENDOR_INTERFACE,         /* bInterfaceNumber */
+  0x00,   /* bAlternateSetting */
+  0x00,   /* bNumEndpoints */
+  0xFF,   /* bInterfaceClass: Vendor specific */
+  0x00,   /* bInterfaceSubClass */
+  0x00,   /* bInterfaceProtocol */
+  VENDOR_STR_IDX,           /* iInterface */
+
+  /*Vendor interface, alternate setting 1: binary frames on the bulk IN endpoint */
+  0x09,   /* bLength: Interface Descriptor size */
+  USB_DESC_TYPE_INTERFACE,  /* bDescriptorType: Interface */
+  VENDOR_INTERFACE,         /* bInterfaceNumber */
+  0x01,   /* bAlternateSetting */
+  0x01,   /* bNumEndpoints */
+  0xFF,   /* bInterfaceClass: Vendor specific */
+  0x00,   /* bInterfaceSubClass */
+  0x00,   /* bInterfaceProtocol */
+  VENDOR_STR_IDX,           /* iInterface */
+
+  /*Vendor bulk IN Endpoint Descriptor*/
+  0x07,   /* bLength: Endpoint Descriptor size */
+  USB_DESC_TYPE_ENDPOINT,      /* bDescriptorType: Endpoint */
+  VENDOR_IN_EP,                      /* bEndpointAddress */
+  0x02,                              /* bmAttributes: Bulk */
+  LOBYTE(CDC_DATA_FS_MAX_PACKET_SIZE),  /* wMaxPacketSize: */
+  HIBYTE(CDC_DATA_FS_MAX_PACKET_SIZE),
   0x00                               /* bInterval: ignore for Bulk transfer */
 } ;
 
@@ -367,12 +463,22 @@ __ALIGN_BEGIN uint8_t USBD_CDC_OtherSpeedCfgDesc[USB_CDC_CONFIG_DESC_SIZ] __ALIG
   USB_DESC_TYPE_OTHER_SPEED_CONFIGURATION,
   USB_CDC_CONFIG_DESC_SIZ,
   0x00,
-  0x02,   /* bNumInterfaces: 2 interfaces */
+  0x03,   /* bNumInterfaces: CDC (2) + vendor (1) */
   0x01,   /* bConfigurationValue: */
   0x04,   /* iConfiguration: */
   0xC0,   /* bmAttributes: */
   0x32,   /* MaxPower 100 mA */
 
+  /*Interface Association Descriptor: CDC function = interfaces 0-1 */
+  0x08,   /* bLength */
+  0x0B,   /* bDescriptorType: Interface Association */
+  0x00,   /* bFirstInterface */
+  0x02,   /* bInterfaceCount */
+  0x02,   /* bFunctionClass: Communication Interface Class */
+  0x02,   /* bFunctionSubClass: Abstract Control Model */
+  0x01,   /* bFunctionProtocol: Common AT commands */
+  0x00,   /* iFunction */
+
   /*Interface Descriptor */
   0x09,   /* bLength: Interface Descriptor size */
   USB_DESC_TYPE_INTERFACE,  /* bDescriptorType: Interface */
@@ -450,7 +556,39 @@ __ALIGN_BEGIN uint8_t USBD_CDC_OtherSpeedCfgDesc[USB_CDC_CONFIG_DESC_SIZ] __ALIG
   0x02,                             /* bmAttributes: Bulk */
   0x40,                             /* wMaxPacketSize: */
   0x00,
-  0x00                              /* bInterval */
+  0x00,                             /* bInterval */
+  /*---------------------------------------------------------------------------*/
+
+  /*Vendor interface, alternate setting 0: no endpoint (frames stay on CDC) */
+  0x09,   /* bLength: Interface Descriptor size */
+  USB_DESC_TYPE_INTERFACE,  /* bDescriptorType: Interface */
+  VENDOR_INTERFACE,         /* bInterfaceNumber */
+  0x00,   /* bAlternateSetting */
+  0x00,   /* bNumEndpoints */
+  0xFF,   /* bInterfaceClass: Vendor specific */
+  0x00,   /* bInterfaceSubClass */
+  0x00,   /* bInterfaceProtocol */
+  VENDOR_STR_IDX,           /* iInterface */
+
+  /*Vendor interface, alternate setting 1: binary frames on the bulk IN endpoint */
+  0x09,   /* bLength: Interface Descriptor size */
+  USB_DESC_TYPE_INTERFACE,  /* bDescriptorType: Interface */
+  VENDOR_INTERFACE,         /* bInterfaceNumber */
+  0x01,   /* bAlternateSetting */
+  0x01,   /* bNumEndpoints */
+  0xFF,   /* bInterfaceClass: Vendor specific */
+  0x00,   /* bInterfaceSubClass */
+  0x00,   /* bInterfaceProtocol */
+  VENDOR_STR_IDX,           /* iInterface */
+
+  /*Vendor bulk IN Endpoint Descriptor*/
+  0x07,   /* bLength: Endpoint Descriptor size */
+  USB_DESC_TYPE_ENDPOINT,      /* bDescriptorType: Endpoint */
+  VENDOR_IN_EP,                      /* bEndpointAddress */
+  0x02,                              /* bmAttributes: Bulk */
+  0x40,  /* wMaxPacketSize: */
+  0x00,
+  0x00                               /* bInterval: ignore for Bulk transfer */
 };
 
 /**
@@ -523,6 +661,10 @@ static uint8_t  USBD_CDC_Init(USBD_HandleTypeDef *pdev, uint8_t cfgidx)
     hcdc->TxState = 0U;
     hcdc->RxState = 0U;
 
+    /* Vendor stream endpoint is opened by SET_INTERFACE alt 1 */
+    hcdc->VendorTxState = 0U;
+    hcdc->VendorAlt = 0U;
+
     if (pdev->dev_speed == USBD_SPEED_HIGH)
     {
       /* Prepare Out endpoint to receive next packet */
@@ -565,6 +707,8 @@ static uint8_t  USBD_CDC_DeInit(USBD_HandleTypeDef *pdev, uint8_t cfgidx)
   /* DeInit  physical Interface components */
   if (pdev->pClassData != NULL)
   {
+    USBD_CDC_VendorSetAlt(pdev, 0U);
+
     ((USBD_CDC_ItfTypeDef *)pdev->pUserData)->DeInit();
     USBD_free(pdev->pClassData);
     pdev->pClassData = NULL;
@@ -634,7 +778,14 @@ static uint8_t  USBD_CDC_Setup(USBD_HandleTypeDef *pdev,
         case USB_REQ_GET_INTERFACE:
           if (pdev->dev_state == USBD_STATE_CONFIGURED)
           {
-            USBD_CtlSendData(pdev, &ifalt, 1U);
+            if (LOBYTE(req->wIndex) == VENDOR_INTERFACE)
+            {
+              USBD_CtlSendData(pdev, &hcdc->VendorAlt, 1U);
+            }
+            else
+            {
+              USBD_CtlSendData(pdev, &ifalt, 1U);
+            }
           }
           else
           {
@@ -649,6 +800,20 @@ static uint8_t  USBD_CDC_Setup(USBD_HandleTypeDef *pdev,
             USBD_CtlError(pdev, req);
             ret = USBD_FAIL;
           }
+          else if (LOBYTE(req->wIndex) == VENDOR_INTERFACE)
+          {
+            if (LOBYTE(req->wValue) <= 1U)
+            {
+              /* Re-opening the endpoint also resets its data toggle */
+              USBD_CDC_VendorSetAlt(pdev, 0U);
+              USBD_CDC_VendorSetAlt(pdev, LOBYTE(req->wValue));
+            }
+            else
+            {
+              USBD_CtlError(pdev, req);
+              ret = USBD_FAIL;
+            }
+          }
           break;
 
         default:
@@ -689,6 +854,10 @@ static uint8_t  USBD_CDC_DataIn(USBD_HandleTypeDef *pdev, uint8_t epnum)
       /* Send ZLP */
       USBD_LL_Transmit(pdev, epnum, NULL, 0U);
     }
+    else if (epnum == (VENDOR_IN_EP & 0xFU))
+    {
+      hcdc->VendorTxState = 0U;
+    }
     else
     {
       hcdc->TxState = 0U;
@@ -894,6 +1063,109 @@ uint8_t  USBD_CDC_TransmitPacket(USBD_HandleTypeDef *pdev)
 }
 
 
+/**
+  * @brief  USBD_CDC_VendorTransmit
+  *         Transmit a buffer on the vendor bulk IN endpoint
+  * @param  pdev: device instance
+  * @param  pbuff: data, must stay valid until the transfer completes
+  * @param  length: number of bytes
+  * @retval USBD_OK, USBD_BUSY while the previous transfer is in progress,
+  *         USBD_FAIL if the host has not selected alternate setting 1
+  */
+uint8_t  USBD_CDC_VendorTransmit(USBD_HandleTypeDef *pdev,
+                                 uint8_t *pbuff,
+                                 uint16_t length)
+{
+  USBD_CDC_HandleTypeDef   *hcdc = (USBD_CDC_HandleTypeDef *) pdev->pClassData;
+
+  if ((hcdc == NULL) || (hcdc->VendorAlt == 0U))
+  {
+    return USBD_FAIL;
+  }
+
+  if (hcdc->VendorTxState != 0U)
+  {
+    return USBD_BUSY;
+  }
+
+  hcdc->VendorTxState = 1U;
+
+  /* Update the packet total length (a ZLP follows whole packets) */
+  pdev->ep_in[VENDOR_IN_EP & 0xFU].total_length = length;
+
+  USBD_LL_Transmit(pdev, VENDOR_IN_EP, pbuff, length);
+
+  return USBD_OK;
+}
+
+/**
+  * @brief  USBD_CDC_VendorActive
+  *         Host has selected the vendor stream (alternate setting 1)
+  * @param  pdev: device instance
+  * @retval 1 if active, else 0
+  */
+uint8_t  USBD_CDC_VendorActive(USBD_HandleTypeDef *pdev)
+{
+  USBD_CDC_HandleTypeDef   *hcdc = (USBD_CDC_HandleTypeDef *) pdev->pClassData;
+
+  return ((hcdc != NULL) && (hcdc->VendorAlt != 0U)) ? 1U : 0U;
+}
+
+/**
+  * @brief  USBD_CDC_VendorSetAlt
+  *         Open (alt 1) or close (alt 0) the vendor bulk IN endpoint
+  * @param  pdev: device instance
+  * @param  alt: alternate setting
+  * @retval None
+  */
+static void USBD_CDC_VendorSetAlt(USBD_HandleTypeDef *pdev, uint8_t alt)
+{
+  USBD_CDC_HandleTypeDef   *hcdc = (USBD_CDC_HandleTypeDef *) pdev->pClassData;
+
+  if (hcdc->VendorAlt != 0U)
+  {
+    USBD_LL_CloseEP(pdev, VENDOR_IN_EP);
+    pdev->ep_in[VENDOR_IN_EP & 0xFU].is_used = 0U;
+  }
+
+  hcdc->VendorTxState = 0U;
+  hcdc->VendorAlt = alt;
+
+  if (alt != 0U)
+  {
+    USBD_LL_OpenEP(pdev, VENDOR_IN_EP, USBD_EP_TYPE_BULK,
+                   (pdev->dev_speed == USBD_SPEED_HIGH) ? CDC_DATA_HS_IN_PACKET_SIZE
+                                                        : CDC_DATA_FS_IN_PACKET_SIZE);
+    pdev->ep_in[VENDOR_IN_EP & 0xFU].is_used = 1U;
+  }
+}
+
+#if (USBD_SUPPORT_USER_STRING_DESC == 1U)
+/**
+  * @brief  USBD_CDC_GetUsrStrDescriptor
+  *         Return the vendor interface string (defined in usbd_desc.c)
+  * @param  pdev: device instance
+  * @param  index: string index
+  * @param  length: pointer data length
+  * @retval pointer to descriptor buffer, NULL if unknown
+  */
+static uint8_t  *USBD_CDC_GetUsrStrDescriptor(USBD_HandleTypeDef *pdev,
+                                              uint8_t index, uint16_t *length)
+{
+  extern uint8_t *USBD_FS_VendorStrDescriptor(USBD_SpeedTypeDef speed, uint16_t *length);
+
+  if (index == VENDOR_STR_IDX)
+  {
+    return USBD_FS_VendorStrDescriptor(pdev->dev_speed, length);
+  }
+
+  /* Unknown string: the core sends nothing for length 0, so stall here */
+  USBD_CtlError(pdev, NULL);
+  *length = 0U;
+  return NULL;
+}
+#endif
+
 /**
   * @brief  USBD_CDC_ReceivePacket
   *         prepare OUT Endpoint for reception
@@ -259,8 +259,8 @@ static int8_t CDC_Control_FS(uint8_t cmd, uint8_t* pbuf, uint16_t length)
 static int8_t CDC_Receive_FS(uint8_t* Buf, uint32_t *Len)
 {
   /* USER CODE BEGIN 6 */
-  /* 处理接收到的USB命令 */
-  USB_Command_Process(Buf, *Len);
+  /* 只放入命令接收缓冲区，命令在主循环中执行 */
+  USB_Command_Receive(Buf, *Len);
   
   /* 准备接收下一个数据包 - 使用静态缓冲区 */
   USBD_CDC_SetRxBuffer(&hUsbDeviceFS, UserRxBufferFS);
@@ -295,6 +295,50 @@ uint8_t CDC_Transmit_FS(uint8_t* Buf, uint16_t Len)
 }
 
 /* USER CODE BEGIN PRIVATE_FUNCTIONS_IMPLEMENTATION */
+/**
+  * @brief  通过厂商批量接口（EP 0x84）发送，与CDC数据端点互不占用
+  * @param  Buf: 发送完成前保持有效
+  * @param  Len: 字节数
+  * @retval USBD_OK；上一包未发完返回USBD_BUSY；主机未选择备用设置1返回USBD_FAIL
+  */
+uint8_t Vendor_Transmit_FS(uint8_t* Buf, uint16_t Len)
+{
+  return USBD_CDC_VendorTransmit(&hUsbDeviceFS, Buf, Len);
+}
+
+/**
+  * @brief  主机是否已完成枚举（SET_CONFIGURATION），之后才能收发数据
+  */
+uint8_t CDC_Configured_FS(void)
+{
+  return (hUsbDeviceFS.dev_state == USBD_STATE_CONFIGURED) ? 1 : 0;
+}
+
+/**
+  * @brief  CDC数据IN端点是否仍有数据在发送
+  */
+uint8_t CDC_Tx_Busy_FS(void)
+{
+  USBD_CDC_HandleTypeDef *hcdc = (USBD_CDC_HandleTypeDef*)hUsbDeviceFS.pClassData;
+  return (hcdc != NULL && hcdc->TxState != 0) ? 1 : 0;
+}
+
+/**
+  * @brief  厂商批量IN端点是否仍有数据在发送
+  */
+uint8_t Vendor_Tx_Busy_FS(void)
+{
+  USBD_CDC_HandleTypeDef *hcdc = (USBD_CDC_HandleTypeDef*)hUsbDeviceFS.pClassData;
+  return (hcdc != NULL && hcdc->VendorTxState != 0) ? 1 : 0;
+}
+
+/**
+  * @brief  主机是否已打开厂商批量接口（SET_INTERFACE 接口2 备用设置1）
+  */
+uint8_t Vendor_Stream_Active(void)
+{
+  return USBD_CDC_VendorActive(&hUsbDeviceFS);
+}
 
 /* USER CODE END PRIVATE_FUNCTIONS_IMPLEMENTATION */
 
@@ -108,6 +108,11 @@ extern USBD_CDC_ItfTypeDef USBD_Interface_fops_FS;
 uint8_t CDC_Transmit_FS(uint8_t* Buf, uint16_t Len);
 
 /* USER CODE BEGIN EXPORTED_FUNCTIONS */
+uint8_t Vendor_Transmit_FS(uint8_t* Buf, uint16_t Len);
+uint8_t Vendor_Stream_Active(void);
+uint8_t CDC_Tx_Busy_FS(void);
+uint8_t Vendor_Tx_Busy_FS(void);
+uint8_t CDC_Configured_FS(void);
 
 /* USER CODE END EXPORTED_FUNCTIONS */
 
@@ -329,13 +329,22 @@ USBD_StatusTypeDef USBD_LL_Init(USBD_HandleTypeDef *pdev)
   HAL_PCD_RegisterIsoInIncpltCallback(&hpcd_USB_FS, PCD_ISOINIncompleteCallback);
 #endif /* USE_HAL_PCD_REGISTER_CALLBACKS */
   /* USER CODE BEGIN EndPoint_Configuration */
-  HAL_PCDEx_PMAConfig((PCD_HandleTypeDef*)pdev->pData , 0x00 , PCD_SNG_BUF, 0x18);
-  HAL_PCDEx_PMAConfig((PCD_HandleTypeDef*)pdev->pData , 0x80 , PCD_SNG_BUF, 0x58);
+  /* PMA布局（512字节）：0x00-0x27 缓冲区描述表（EP0-EP4，每个8字节）
+   *   0x028 EP0 OUT 64 | 0x068 EP0 IN 64 | 0x0A8 EP2 IN(CDC命令) 8 | 0x0B0 EP3 OUT 64
+   *   0x0F0/0x130 EP1 IN 双缓冲 2x64 | 0x170/0x1B0 EP4 IN(厂商批量接口) 双缓冲 2x64
+   * 双缓冲端点占用该端点号的发送和接收两个描述符，只能单方向使用，
+   * 因此数据OUT端点由EP1移到EP3（CDC_OUT_EP）。 */
+  HAL_PCDEx_PMAConfig((PCD_HandleTypeDef*)pdev->pData , 0x00 , PCD_SNG_BUF, 0x28);
+  HAL_PCDEx_PMAConfig((PCD_HandleTypeDef*)pdev->pData , 0x80 , PCD_SNG_BUF, 0x68);
   /* USER CODE END EndPoint_Configuration */
   /* USER CODE BEGIN EndPoint_Configuration_CDC */
-  HAL_PCDEx_PMAConfig((PCD_HandleTypeDef*)pdev->pData , 0x81 , PCD_SNG_BUF, 0xC0);
-  HAL_PCDEx_PMAConfig((PCD_HandleTypeDef*)pdev->pData , 0x01 , PCD_SNG_BUF, 0x110);
-  HAL_PCDEx_PMAConfig((PCD_HandleTypeDef*)pdev->pData , 0x82 , PCD_SNG_BUF, 0x100);
+  /* 数据IN：批量双缓冲，USB发送一半时HAL在中断中填充另一半，
+   * 多包传输的包与包之间不再等待中断重新装填（地址：高16位=缓冲区1，低16位=缓冲区0） */
+  HAL_PCDEx_PMAConfig((PCD_HandleTypeDef*)pdev->pData , CDC_IN_EP , PCD_DBL_BUF, (0x130U << 16) | 0x0F0U);
+  HAL_PCDEx_PMAConfig((PCD_HandleTypeDef*)pdev->pData , CDC_OUT_EP , PCD_SNG_BUF, 0xB0);
+  HAL_PCDEx_PMAConfig((PCD_HandleTypeDef*)pdev->pData , CDC_CMD_EP , PCD_SNG_BUF, 0xA8);
+  /* 厂商批量接口（接口2备用设置1）的数据IN，同样双缓冲 */
+  HAL_PCDEx_PMAConfig((PCD_HandleTypeDef*)pdev->pData , VENDOR_IN_EP , PCD_DBL_BUF, (0x1B0U << 16) | 0x170U);
   /* USER CODE END EndPoint_Configuration_CDC */
   return USBD_OK;
 }
@@ -49,6 +49,15 @@ typedef struct {
     uint8_t eny_state;        // ENY pin state (0=enabled, 1=disabled)
 } MUX_Status_t;
 
+/**
+  * @brief  Full matrix scan order
+  */
+typedef enum {
+    MUX_ORDER_BINARY = 0,     // Row-major, X counts 0..15 in binary
+    MUX_ORDER_SERPENTINE,     // Odd rows reversed, X unchanged across a row change
+    MUX_ORDER_GRAY            // 8-bit reflected Gray code, one select line flips per step
+} MUX_ScanOrder_t;
+
 /* Exported constants --------------------------------------------------------*/
 
 #define MUX_CHANNEL_MAX     15    // Maximum channel number (0-15)
@@ -82,6 +91,8 @@ void MUX_DisableBoth(void);
 void MUX_ScanRow(uint8_t row);           // Scan specific row (Y fixed, X scans 0-15)
 void MUX_ScanColumn(uint8_t column);     // Scan specific column (X fixed, Y scans 0-15)
 void MUX_ScanAll(void);                  // Scan all combinations (16x16 matrix)
+void MUX_SetScanOrder(MUX_ScanOrder_t order);  // Point order used by MUX_ScanAll
+MUX_ScanOrder_t MUX_GetScanOrder(void);
 
 // Status and utility functions
 MUX_Status_t MUX_GetStatus(void);
@@ -42,6 +42,11 @@ extern "C" {
 #define TEST                0x7E
 #define PCAP04_READ_RESULT  0x40
 
+/* Result RAM layout: RES0..RES7 at 0..31 (LSB first), STATUS_0..2 at 32..34 */
+#define PCAP04_RESULT_PORTS     6
+#define PCAP04_STATUS0_ADDR     32
+#define PCAP04_RESULT_BURST_LEN 35
+
 /* Exported macro ------------------------------------------------------------*/
 
 /* Exported variables --------------------------------------------------------*/
@@ -57,6 +62,7 @@ void PCap04_Init(void);
 void PCAP04_WriteFirmware(void);
 void PCap04_Init_Tow(void);
 uint32_t PCAP04_Read_CDC_Result_data(int Nun);
+void PCAP04_Read_CDC_Results(uint32_t *res, uint8_t *status);
 double integrated_data(uint32_t data);
 void PCap04_SetMutualCapacitanceMode(void);
 void PCap04_SetFloatConversion(uint8_t enable);
@@ -43,11 +43,14 @@ static MUX_Status_t mux_status = {
     .eny_state = 1   // Disabled (high)
 };
 
+static MUX_ScanOrder_t scan_order = MUX_ORDER_BINARY;  // SET_ORDER selects serpentine/Gray
+
 /* Private function prototypes -----------------------------------------------*/
 static void MUX_SetChannelBits(uint8_t channel, GPIO_TypeDef* s0_port, uint16_t s0_pin,
                                GPIO_TypeDef* s1_port, uint16_t s1_pin,
                                GPIO_TypeDef* s2_port, uint16_t s2_pin,
                                GPIO_TypeDef* s3_port, uint16_t s3_pin);
+static void MUX_OrderPoint(uint16_t step, uint8_t* x, uint8_t* y);
 
 /* Private functions ---------------------------------------------------------*/
 
@@ -81,6 +84,32 @@ static void MUX_SetChannelBits(uint8_t channel, GPIO_TypeDef* s0_port, uint16_t
     HAL_GPIO_WritePin(s3_port, s3_pin, (channel & 0x08) ? GPIO_PIN_SET : GPIO_PIN_RESET);
 }
 
+/**
+  * @brief  Map scan step to X/Y channel according to scan_order
+  * @param  step: Point index in scan order (0-255)
+  * @param  x, y: Output X (column) and Y (row) channels
+  * @retval None
+  */
+static void MUX_OrderPoint(uint16_t step, uint8_t* x, uint8_t* y)
+{
+    uint8_t row = (step >> 4) & 0x0F;
+    uint8_t col = step & 0x0F;
+    
+    if(scan_order == MUX_ORDER_SERPENTINE) {
+        if(row & 0x01) {
+            col = 0x0F - col;
+        }
+    } else if(scan_order == MUX_ORDER_GRAY) {
+        // High nibble = row, low nibble = column
+        uint8_t g = (uint8_t)(step ^ (step >> 1));
+        row = g >> 4;
+        col = g & 0x0F;
+    }
+    
+    *x = col;
+    *y = row;
+}
+
 /* Public functions ----------------------------------------------------------*/
 
 /**
@@ -338,26 +367,50 @@ void MUX_ScanAll(void)
     
     MUX_EnableBoth();
     
-    for(uint8_t y = 0; y <= MUX_CHANNEL_MAX; y++) {
-        MUX_SetYChannel(y);
+    // Enables stay on for the whole scan; only channels that changed are rewritten
+    for(uint16_t step = 0; step < 256; step++) {
+        uint8_t x, y;
+        MUX_OrderPoint(step, &x, &y);
         
-        for(uint8_t x = 0; x <= MUX_CHANNEL_MAX; x++) {
+        if(step == 0 || y != mux_status.y_channel) {
+            MUX_SetYChannel(y);
+        }
+        if(step == 0 || x != mux_status.x_channel) {
             MUX_SetXChannel(x);
-            USB_Printf("[%2d,%2d] ", x, y);
-            
-            // Add your measurement code here
-            // Example: Read PCAP04 data
-            HAL_Delay(10);  // Settling time
-            
-            if((x + 1) % 8 == 0) USB_Printf("\r\n");  // New line every 8 positions
         }
-        USB_Printf("\r\n");
+        USB_Printf("[%2d,%2d] ", x, y);
+        
+        // Add your measurement code here
+        // Example: Read PCAP04 data
+        HAL_Delay(10);  // Settling time
+        
+        if((step + 1) % 8 == 0) USB_Printf("\r\n");  // New line every 8 positions
+        if((step + 1) % 16 == 0) USB_Printf("\r\n");
     }
     
     mux_status.mode = MUX_MODE_XY_BOTH;
     USB_Printf("Full matrix scan completed (256 positions)\r\n");
 }
 
+/**
+  * @brief  Set point order used by MUX_ScanAll
+  * @param  order: MUX_ORDER_BINARY, MUX_ORDER_SERPENTINE or MUX_ORDER_GRAY
+  * @retval None
+  */
+void MUX_SetScanOrder(MUX_ScanOrder_t order)
+{
+    scan_order = (order > MUX_ORDER_GRAY) ? MUX_ORDER_BINARY : order;
+}
+
+/**
+  * @brief  Get point order used by MUX_ScanAll
+  * @retval MUX_ScanOrder_t: Current scan order
+  */
+MUX_ScanOrder_t MUX_GetScanOrder(void)
+{
+    return scan_order;
+}
+
 /**
   * @brief  Get current multiplexer status
   * @retval MUX_Status_t: Current status structure
@@ -318,6 +318,39 @@ uint32_t PCAP04_Read_CDC_Result_data(int Nun)
 	return dCapRatio;
 }
 
+/**
+  * @brief  Read RES0..RES5 and STATUS_0..2 in a single chip-select window
+  * @param  res: Output array of PCAP04_RESULT_PORTS raw results
+  * @param  status: Output array of 3 status bytes (may be NULL)
+  * @retval None
+  * @note   Address auto-increments from 0, so one opcode returns all ports.
+  */
+void PCAP04_Read_CDC_Results(uint32_t *res, uint8_t *status)
+{
+	uint8_t rx[PCAP04_RESULT_BURST_LEN]={0x00};
+	uint8_t data = PCAP04_READ_RESULT;
+	int i;
+
+	FLASH_SPI_CS_ENABLE();
+	HAL_SPI_Transmit(&hspi2,&data,1,1000);
+	HAL_SPI_Receive(&hspi2,rx,PCAP04_RESULT_BURST_LEN,1000);
+	FLASH_SPI_CS_DISABLE();
+
+	for(i = 0; i < PCAP04_RESULT_PORTS; i++)
+	{
+		res[i] =  rx[i*4];
+		res[i] |= rx[i*4+1]<<8;
+		res[i] |= rx[i*4+2]<<16;
+		res[i] |= (uint32_t)rx[i*4+3]<<24;
+	}
+	if(status != NULL)
+	{
+		status[0] = rx[PCAP04_STATUS0_ADDR];
+		status[1] = rx[PCAP04_STATUS0_ADDR+1];
+		status[2] = rx[PCAP04_STATUS0_ADDR+2];
+	}
+}
+
 /**
   * @brief  Convert raw data to capacitance value
   * @param  data: Raw 32-bit data from PCAP04
@@ -486,6 +486,25 @@ static CMD_Result_t CMD_ExecuteSingle(const char *cmd, char params[][CMD_TOKEN_M
         USB_SendError(21, "Invalid SET_MATRIX_SIZE parameters");
         return CMD_RESULT_INVALID_PARAM;
     }
+    // === SET_ORDER:<binary/serpentine/gray> ===
+    else if (strncmp(cmd_upper, "SET_ORDER", 9) == 0) {
+        if (param_count >= 1) {
+            if (strcmp(params[0], "binary") == 0 || strcmp(params[0], "BINARY") == 0) {
+                MUX_SetScanOrder(MUX_ORDER_BINARY);
+            } else if (strcmp(params[0], "serpentine") == 0 || strcmp(params[0], "SERPENTINE") == 0) {
+                MUX_SetScanOrder(MUX_ORDER_SERPENTINE);
+            } else if (strcmp(params[0], "gray") == 0 || strcmp(params[0], "GRAY") == 0) {
+                MUX_SetScanOrder(MUX_ORDER_GRAY);
+            } else {
+                USB_SendError(22, "Invalid SET_ORDER parameter (binary/serpentine/gray)");
+                return CMD_RESULT_INVALID_PARAM;
+            }
+            USB_SendOK("SET_ORDER");
+            return CMD_RESULT_OK;
+        }
+        USB_SendError(22, "Invalid SET_ORDER parameter");
+        return CMD_RESULT_INVALID_PARAM;
+    }
     
     // Unknown command
     USB_SendError(255, "Unknown command");
@@ -604,13 +623,16 @@ void USB_SingleScan(void)
     // Read PCAP04 data
     // PC0, PC1: Reference capacitance (CA)
     // PC2, PC3: Measurement capacitance (CB)
-    extern uint32_t PCAP04_Read_CDC_Result_data(int Nun);
+    // One burst read returns all ports instead of one transaction per port
+    extern void PCAP04_Read_CDC_Results(uint32_t *res, uint8_t *status);
     extern double integrated_data(uint32_t data);
     
-    uint32_t raw_data_pc0 = PCAP04_Read_CDC_Result_data(0);
-    uint32_t raw_data_pc1 = PCAP04_Read_CDC_Result_data(1);
-    uint32_t raw_data_pc2 = PCAP04_Read_CDC_Result_data(2);
-    uint32_t raw_data_pc3 = PCAP04_Read_CDC_Result_data(3);
+    uint32_t res[6];
+    PCAP04_Read_CDC_Results(res, NULL);
+    uint32_t raw_data_pc0 = res[0];
+    uint32_t raw_data_pc1 = res[1];
+    uint32_t raw_data_pc2 = res[2];
+    uint32_t raw_data_pc3 = res[3];
     
     double float_data_pc0 = integrated_data(raw_data_pc0);
     double float_data_pc1 = integrated_data(raw_data_pc1);
@@ -766,13 +788,16 @@ void USB_ScanPoint(uint8_t row, uint8_t col)
     // Read PCAP04 data
     // PC0, PC1: Reference capacitance (CA)
     // PC2, PC3: Measurement capacitance (CB)
-    extern uint32_t PCAP04_Read_CDC_Result_data(int Nun);
+    // One burst read returns all ports instead of one transaction per port
+    extern void PCAP04_Read_CDC_Results(uint32_t *res, uint8_t *status);
     extern double integrated_data(uint32_t data);
     
-    uint32_t raw_data_pc0 = PCAP04_Read_CDC_Result_data(0);
-    uint32_t raw_data_pc1 = PCAP04_Read_CDC_Result_data(1);
-    uint32_t raw_data_pc2 = PCAP04_Read_CDC_Result_data(2);
-    uint32_t raw_data_pc3 = PCAP04_Read_CDC_Result_data(3);
+    uint32_t res[6];
+    PCAP04_Read_CDC_Results(res, NULL);
+    uint32_t raw_data_pc0 = res[0];
+    uint32_t raw_data_pc1 = res[1];
+    uint32_t raw_data_pc2 = res[2];
+    uint32_t raw_data_pc3 = res[3];
     
     double float_data_pc0 = integrated_data(raw_data_pc0);
     double float_data_pc1 = integrated_data(raw_data_pc1);
@@ -823,6 +848,7 @@ void USB_PrintHelp(void)
         "General: START, STOP, STATUS, HELP, ?\r\n"
         "Scan: SET_RATE:<ms>, FAST_MODE, NORMAL_MODE, SINGLE_SCAN\r\n"
         "Matrix: SET_ROW:<n>, SET_COL:<n>, GET_ROW, GET_COL, SCAN_POINT:<r>:<c>, MATRIX_INFO\r\n"
+        "Matrix: SET_ORDER:<binary/serpentine/gray>\r\n"
         "PCAP04: PCAP04_STATUS, PCAP04_TEST, PCAP04_READ:<reg>, PCAP04_WRITE:<reg>:<val>\r\n"
         "PCAP04: PCAP04_DUMP, PCAP04_LOAD_DEFAULT, SET_CDIFF:<0/1>, SET_INTREF:<0/1>, SET_EXTREF:<0/1>\r\n"
         "Template: SET_MODE:<raw/quant>, SET_FORMAT:<table/simple>, SET_TABLE_DELIM:<char>\r\n"